@@ -0,0 +1,85 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BATCHED_STATE_BROADCASTER__BATCHED_STATE_BROADCASTER_HPP_
+#define BATCHED_STATE_BROADCASTER__BATCHED_STATE_BROADCASTER_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "controller_interface/controller_interface.hpp"
+#include "kuka_driver_interfaces/msg/joint_state_batch.hpp"
+#include "pluginlib/class_list_macros.hpp"
+#include "rclcpp/duration.hpp"
+#include "rclcpp/time.hpp"
+#include "realtime_tools/realtime_publisher.h"
+
+#include "batched_state_broadcaster/visibility_control.h"
+#include "batched_state_broadcaster_parameters.hpp"
+
+namespace kuka_controllers
+{
+/**
+ * @brief Broadcaster publishing the joint states of several control cycles in one message
+ *
+ * The states are collected in a fixed-size message, which is published when the configured number
+ *  of cycles is reached. Compared to publishing a joint state message in every cycle, the number of
+ *  messages is reduced by the batch size and no joint names are transferred.
+ */
+class BatchedStateBroadcaster : public controller_interface::ControllerInterface
+{
+public:
+  BATCHED_STATE_BROADCASTER_PUBLIC controller_interface::InterfaceConfiguration
+  command_interface_configuration() const override;
+
+  BATCHED_STATE_BROADCASTER_PUBLIC controller_interface::InterfaceConfiguration
+  state_interface_configuration() const override;
+
+  BATCHED_STATE_BROADCASTER_PUBLIC controller_interface::return_type update(
+    const rclcpp::Time & time, const rclcpp::Duration & period) override;
+
+  BATCHED_STATE_BROADCASTER_PUBLIC controller_interface::CallbackReturn on_configure(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  BATCHED_STATE_BROADCASTER_PUBLIC controller_interface::CallbackReturn on_activate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  BATCHED_STATE_BROADCASTER_PUBLIC controller_interface::CallbackReturn on_deactivate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  BATCHED_STATE_BROADCASTER_PUBLIC controller_interface::CallbackReturn on_init() override;
+
+private:
+  using JointStateBatch = kuka_driver_interfaces::msg::JointStateBatch;
+  using Params = batched_state_broadcaster::Params;
+  using ParamListener = batched_state_broadcaster::ParamListener;
+
+  std::shared_ptr<ParamListener> param_listener_;
+  Params params_;
+
+  // Number of state interfaces of a joint, and the offsets of the optional ones
+  std::size_t interfaces_per_joint_ = 1;
+  std::size_t torque_offset_ = 0;
+  std::size_t external_torque_offset_ = 0;
+
+  // Batch being collected, copied to the publisher when it is full
+  JointStateBatch batch_;
+  std::size_t batch_size_ = 0;
+
+  std::shared_ptr<rclcpp::Publisher<JointStateBatch>> batch_publisher_;
+  std::unique_ptr<realtime_tools::RealtimePublisher<JointStateBatch>> rt_batch_publisher_;
+};
+}  // namespace kuka_controllers
+#endif  // BATCHED_STATE_BROADCASTER__BATCHED_STATE_BROADCASTER_HPP_
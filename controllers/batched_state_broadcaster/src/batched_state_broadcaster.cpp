@@ -0,0 +1,170 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+
+#include "batched_state_broadcaster/batched_state_broadcaster.hpp"
+
+namespace kuka_controllers
+{
+controller_interface::CallbackReturn BatchedStateBroadcaster::on_init()
+{
+  try
+  {
+    param_listener_ = std::make_shared<ParamListener>(get_node());
+    params_ = param_listener_->get_params();
+  }
+  catch (const std::exception & e)
+  {
+    fprintf(stderr, "Exception thrown during init stage with message: %s \n", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::InterfaceConfiguration
+BatchedStateBroadcaster::command_interface_configuration() const
+{
+  return controller_interface::InterfaceConfiguration{
+    controller_interface::interface_configuration_type::NONE};
+}
+
+controller_interface::InterfaceConfiguration
+BatchedStateBroadcaster::state_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_POSITION);
+    if (!params_.torque_interface.empty())
+    {
+      config.names.emplace_back(joint + "/" + params_.torque_interface);
+    }
+    if (!params_.external_torque_interface.empty())
+    {
+      config.names.emplace_back(joint + "/" + params_.external_torque_interface);
+    }
+  }
+  if (!params_.timestamp_interface.empty())
+  {
+    config.names.emplace_back(params_.timestamp_interface);
+  }
+  return config;
+}
+
+controller_interface::CallbackReturn BatchedStateBroadcaster::on_configure(
+  const rclcpp_lifecycle::State &)
+{
+  params_ = param_listener_->get_params();
+  if (params_.joints.empty())
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "'joints' parameter is empty");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  if (params_.joints.size() > JointStateBatch::MAX_JOINTS)
+  {
+    RCLCPP_ERROR(
+      get_node()->get_logger(), "At most %u joints can be published, %zu were given",
+      JointStateBatch::MAX_JOINTS, params_.joints.size());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+
+  interfaces_per_joint_ = 1;
+  if (!params_.torque_interface.empty())
+  {
+    torque_offset_ = interfaces_per_joint_++;
+  }
+  if (!params_.external_torque_interface.empty())
+  {
+    external_torque_offset_ = interfaces_per_joint_++;
+  }
+  batch_size_ = static_cast<std::size_t>(params_.batch_size);
+
+  batch_ = JointStateBatch();
+  batch_.joint_count = static_cast<uint8_t>(params_.joints.size());
+  batch_.has_torques = !params_.torque_interface.empty();
+  batch_.has_external_torques = !params_.external_torque_interface.empty();
+  batch_.has_controller_timestamps = !params_.timestamp_interface.empty();
+
+  batch_publisher_ =
+    get_node()->create_publisher<JointStateBatch>("~/joint_states", rclcpp::SystemDefaultsQoS());
+  rt_batch_publisher_ =
+    std::make_unique<realtime_tools::RealtimePublisher<JointStateBatch>>(batch_publisher_);
+
+  RCLCPP_INFO(
+    get_node()->get_logger(), "Batched state broadcaster configured with %zu cycles per message",
+    batch_size_);
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn BatchedStateBroadcaster::on_activate(
+  const rclcpp_lifecycle::State &)
+{
+  batch_.sample_count = 0;
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn BatchedStateBroadcaster::on_deactivate(
+  const rclcpp_lifecycle::State &)
+{
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::return_type BatchedStateBroadcaster::update(
+  const rclcpp::Time & time, const rclcpp::Duration &)
+{
+  const std::size_t sample = batch_.sample_count;
+  batch_.stamps[sample] = time;
+  const std::size_t offset = sample * JointStateBatch::MAX_JOINTS;
+  for (std::size_t i = 0; i < batch_.joint_count; ++i)
+  {
+    const std::size_t first_interface = i * interfaces_per_joint_;
+    batch_.positions[offset + i] = state_interfaces_[first_interface].get_value();
+    if (batch_.has_torques)
+    {
+      batch_.torques[offset + i] =
+        static_cast<float>(state_interfaces_[first_interface + torque_offset_].get_value());
+    }
+    if (batch_.has_external_torques)
+    {
+      batch_.external_torques[offset + i] = static_cast<float>(
+        state_interfaces_[first_interface + external_torque_offset_].get_value());
+    }
+  }
+  if (batch_.has_controller_timestamps)
+  {
+    batch_.controller_timestamps[sample] = state_interfaces_.back().get_value();
+  }
+
+  if (++batch_.sample_count < batch_size_)
+  {
+    return controller_interface::return_type::OK;
+  }
+
+  // The message has a fixed size, copying it does not allocate memory
+  if (rt_batch_publisher_->trylock())
+  {
+    rt_batch_publisher_->msg_ = batch_;
+    rt_batch_publisher_->unlockAndPublish();
+  }
+  // The sequence is also increased for dropped batches, so the gap is visible for the subscribers
+  batch_.sequence++;
+  batch_.sample_count = 0;
+  return controller_interface::return_type::OK;
+}
+}  // namespace kuka_controllers
+
+PLUGINLIB_EXPORT_CLASS(
+  kuka_controllers::BatchedStateBroadcaster, controller_interface::ControllerInterface)
@@ -0,0 +1,41 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CARTESIAN_IMPEDANCE_CONTROLLER__CARTESIAN_IMPEDANCE_CONTROLLER_HPP_
+#define CARTESIAN_IMPEDANCE_CONTROLLER__CARTESIAN_IMPEDANCE_CONTROLLER_HPP_
+
+#include "forward_command_controller/multi_interface_forward_command_controller.hpp"
+
+#include "cartesian_impedance_controller/visibility_control.h"
+
+namespace kuka_controllers
+{
+/**
+ * @brief Forwards the Cartesian stiffness and damping to the command interfaces of the hardware
+ *
+ * The interfaces of the Cartesian axes and the null space are fixed (see
+ *  hardware_interface::CARTESIAN_IMPEDANCE_AXES), therefore no parameters are needed.
+ */
+class CartesianImpedanceController : public forward_command_controller::ForwardControllersBase
+{
+public:
+  CARTESIAN_IMPEDANCE_CONTROLLER_PUBLIC CartesianImpedanceController();
+
+private:
+  CARTESIAN_IMPEDANCE_CONTROLLER_LOCAL void declare_parameters() override;
+  CARTESIAN_IMPEDANCE_CONTROLLER_LOCAL controller_interface::CallbackReturn read_parameters()
+    override;
+};
+}  // namespace kuka_controllers
+#endif  // CARTESIAN_IMPEDANCE_CONTROLLER__CARTESIAN_IMPEDANCE_CONTROLLER_HPP_
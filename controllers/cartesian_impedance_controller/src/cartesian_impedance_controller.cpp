@@ -0,0 +1,47 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "pluginlib/class_list_macros.hpp"
+
+#include "kuka_drivers_core/hardware_interface_types.hpp"
+
+#include "cartesian_impedance_controller/cartesian_impedance_controller.hpp"
+
+namespace kuka_controllers
+{
+
+CartesianImpedanceController::CartesianImpedanceController() : ForwardControllersBase() {}
+
+void CartesianImpedanceController::declare_parameters() {}
+
+controller_interface::CallbackReturn CartesianImpedanceController::read_parameters()
+{
+  // The order of the commands is stiffness_x, damping_x, stiffness_y, ... damping_nullspace
+  command_interface_types_.clear();
+  for (const auto & axis : hardware_interface::CARTESIAN_IMPEDANCE_AXES)
+  {
+    const std::string prefix =
+      std::string(hardware_interface::CARTESIAN_IMPEDANCE_PREFIX) + "_" + axis + "/";
+    command_interface_types_.push_back(prefix + hardware_interface::HW_IF_STIFFNESS);
+    command_interface_types_.push_back(prefix + hardware_interface::HW_IF_DAMPING);
+  }
+
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+}  // namespace kuka_controllers
+
+PLUGINLIB_EXPORT_CLASS(
+  kuka_controllers::CartesianImpedanceController, controller_interface::ControllerInterface)
@@ -0,0 +1,120 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CARTESIAN_SERVO_CONTROLLER__CARTESIAN_SERVO_CONTROLLER_HPP_
+#define CARTESIAN_SERVO_CONTROLLER__CARTESIAN_SERVO_CONTROLLER_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include "controller_interface/controller_interface.hpp"
+#include "geometry_msgs/msg/pose_stamped.hpp"
+#include "geometry_msgs/msg/twist_stamped.hpp"
+#include "pluginlib/class_list_macros.hpp"
+#include "rclcpp/duration.hpp"
+#include "rclcpp/time.hpp"
+#include "realtime_tools/realtime_buffer.h"
+
+#include "cartesian_servo_controller/dls_kinematics.hpp"
+#include "cartesian_servo_controller/opw_kinematics.hpp"
+#include "cartesian_servo_controller/visibility_control.h"
+#include "cartesian_servo_controller_parameters.hpp"
+
+namespace kuka_controllers
+{
+/**
+ * @brief Controller moving the flange according to streamed twist or pose commands, with the
+ *  inverse kinematics solved in every cycle
+ */
+class CartesianServoController : public controller_interface::ControllerInterface
+{
+public:
+  CARTESIAN_SERVO_CONTROLLER_PUBLIC controller_interface::InterfaceConfiguration
+  command_interface_configuration() const override;
+
+  CARTESIAN_SERVO_CONTROLLER_PUBLIC controller_interface::InterfaceConfiguration
+  state_interface_configuration() const override;
+
+  CARTESIAN_SERVO_CONTROLLER_PUBLIC controller_interface::return_type update(
+    const rclcpp::Time & time, const rclcpp::Duration & period) override;
+
+  CARTESIAN_SERVO_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_configure(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  CARTESIAN_SERVO_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_activate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  CARTESIAN_SERVO_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_deactivate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  CARTESIAN_SERVO_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_init() override;
+
+private:
+  static constexpr int MAX_DOF = 7;
+  // Joint vector with inline storage, its size is set in on_configure()
+  using JointVector = Eigen::Matrix<double, Eigen::Dynamic, 1, Eigen::ColMajor, MAX_DOF, 1>;
+
+  enum class CommandType
+  {
+    NONE,
+    TWIST,
+    POSE
+  };
+
+  struct ServoCommand
+  {
+    CommandType type = CommandType::NONE;
+    Eigen::Vector3d linear = Eigen::Vector3d::Zero();
+    Eigen::Vector3d angular = Eigen::Vector3d::Zero();
+    Eigen::Vector3d position = Eigen::Vector3d::Zero();
+    Eigen::Quaterniond orientation = Eigen::Quaterniond::Identity();
+    int64_t received = 0;
+  };
+
+  CARTESIAN_SERVO_CONTROLLER_LOCAL void onTwist(
+    const geometry_msgs::msg::TwistStamped::SharedPtr msg);
+  CARTESIAN_SERVO_CONTROLLER_LOCAL void onPose(
+    const geometry_msgs::msg::PoseStamped::SharedPtr msg);
+  CARTESIAN_SERVO_CONTROLLER_LOCAL void moveTarget(
+    const ServoCommand & command, int64_t now, double dt);
+  CARTESIAN_SERVO_CONTROLLER_LOCAL Eigen::Isometry3d forward(const JointVector & joints) const;
+  CARTESIAN_SERVO_CONTROLLER_LOCAL bool inverse(
+    const Eigen::Isometry3d & target, JointVector & joints) const;
+
+  using Params = cartesian_servo_controller::Params;
+  using ParamListener = cartesian_servo_controller::ParamListener;
+
+  std::shared_ptr<ParamListener> param_listener_;
+  Params params_;
+  bool use_opw_ = true;
+  bool flange_frame_twist_ = false;
+  int64_t command_timeout_ns_ = 0;
+
+  OPWKinematics opw_;
+  DLSKinematics<MAX_DOF> dls_;
+
+  rclcpp::Subscription<geometry_msgs::msg::TwistStamped>::SharedPtr twist_subscriber_;
+  rclcpp::Subscription<geometry_msgs::msg::PoseStamped>::SharedPtr pose_subscriber_;
+  realtime_tools::RealtimeBuffer<ServoCommand> command_buffer_;
+
+  // Commanded joint positions and the flange pose they should reach
+  JointVector joints_;
+  JointVector rest_joints_;
+  Eigen::Isometry3d target_ = Eigen::Isometry3d::Identity();
+};
+}  // namespace kuka_controllers
+#endif  // CARTESIAN_SERVO_CONTROLLER__CARTESIAN_SERVO_CONTROLLER_HPP_
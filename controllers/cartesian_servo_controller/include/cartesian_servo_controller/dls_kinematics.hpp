@@ -0,0 +1,159 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CARTESIAN_SERVO_CONTROLLER__DLS_KINEMATICS_HPP_
+#define CARTESIAN_SERVO_CONTROLLER__DLS_KINEMATICS_HPP_
+
+#include <cmath>
+
+#include <Eigen/Cholesky>
+#include <Eigen/Geometry>
+
+namespace kuka_controllers
+{
+/**
+ * @brief Kinematics of serial robots described with standard Denavit-Hartenberg parameters,
+ *  with an iterative damped least squares inverse kinematics for redundant robots
+ *
+ * It uses fixed-size Eigen types only, so none of the methods allocate memory.
+ *
+ * @tparam DOF: Number of joints
+ */
+template <int DOF>
+class DLSKinematics
+{
+public:
+  using Vector = Eigen::Matrix<double, DOF, 1>;
+  using Jacobian = Eigen::Matrix<double, 6, DOF>;
+  using Vector6d = Eigen::Matrix<double, 6, 1>;
+
+  struct Parameters
+  {
+    Vector a = Vector::Zero();
+    Vector alpha = Vector::Zero();
+    Vector d = Vector::Zero();
+    Vector theta_offsets = Vector::Zero();
+  };
+
+  DLSKinematics() = default;
+  explicit DLSKinematics(const Parameters & parameters) : p_(parameters) {}
+
+  /**
+   * @brief Calculates the pose of the flange in the base frame
+   */
+  Eigen::Isometry3d forward(const Vector & joints) const
+  {
+    Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+    for (int i = 0; i < DOF; ++i)
+    {
+      pose = pose * link(i, joints[i]);
+    }
+    return pose;
+  }
+
+  /**
+   * @brief Calculates the pose of the flange and the geometric Jacobian in the base frame
+   */
+  void forward(const Vector & joints, Eigen::Isometry3d & pose, Jacobian & jacobian) const
+  {
+    // The axis of every joint is the z axis of the previous frame
+    Eigen::Matrix<double, 3, DOF> axes;
+    Eigen::Matrix<double, 3, DOF> origins;
+    pose = Eigen::Isometry3d::Identity();
+    for (int i = 0; i < DOF; ++i)
+    {
+      axes.col(i) = pose.linear().col(2);
+      origins.col(i) = pose.translation();
+      pose = pose * link(i, joints[i]);
+    }
+    for (int i = 0; i < DOF; ++i)
+    {
+      jacobian.template block<3, 1>(0, i) =
+        axes.col(i).cross(pose.translation() - origins.col(i));
+      jacobian.template block<3, 1>(3, i) = axes.col(i);
+    }
+  }
+
+  /**
+   * @brief Moves the joints towards the target pose with damped least squares iterations
+   *
+   * The null space motion pulls the joints towards the rest configuration, which resolves the
+   *  redundancy of the robot.
+   *
+   * @param target: Target pose of the flange in the base frame
+   * @param joints: Initial configuration, overwritten with the result
+   * @param iterations: Maximum number of iterations
+   * @param damping: Damping factor, which limits the joint motion near singularities
+   * @param rest: Rest configuration used for the null space motion
+   * @param nullspace_gain: Gain of the null space motion, zero disables it
+   * @param tolerance: Iteration stops if the norm of the pose error is below this value
+   * @return double: Norm of the remaining pose error
+   */
+  double solve(
+    const Eigen::Isometry3d & target, Vector & joints, int iterations, double damping,
+    const Vector & rest, double nullspace_gain, double tolerance) const
+  {
+    Eigen::Isometry3d pose;
+    Jacobian jacobian;
+    forward(joints, pose, jacobian);
+    Vector6d error = poseError(target, pose);
+    for (int iteration = 0; iteration < iterations && error.norm() >= tolerance; ++iteration)
+    {
+      using Matrix6d = Eigen::Matrix<double, 6, 6>;
+      const Matrix6d jjt =
+        jacobian * jacobian.transpose() + damping * damping * Matrix6d::Identity();
+      const Eigen::LDLT<Matrix6d> ldlt(jjt);
+      const Vector step = jacobian.transpose() * ldlt.solve(error);
+      if (nullspace_gain > 0)
+      {
+        const Vector bias = nullspace_gain * (rest - joints);
+        joints += bias - jacobian.transpose() * ldlt.solve(jacobian * bias);
+      }
+      joints += step;
+
+      forward(joints, pose, jacobian);
+      error = poseError(target, pose);
+    }
+    return error.norm();
+  }
+
+  /**
+   * @brief Position and orientation (angle-axis) error between two poses in the base frame
+   */
+  static Vector6d poseError(const Eigen::Isometry3d & target, const Eigen::Isometry3d & actual)
+  {
+    Vector6d error;
+    error.template head<3>() = target.translation() - actual.translation();
+    const Eigen::AngleAxisd rotation(target.linear() * actual.linear().transpose());
+    error.template tail<3>() = rotation.angle() * rotation.axis();
+    return error;
+  }
+
+private:
+  Eigen::Isometry3d link(int i, double joint) const
+  {
+    const double theta = joint + p_.theta_offsets[i];
+    const double ct = std::cos(theta), st = std::sin(theta);
+    const double ca = std::cos(p_.alpha[i]), sa = std::sin(p_.alpha[i]);
+    Eigen::Isometry3d transform = Eigen::Isometry3d::Identity();
+    transform.linear() << ct, -st * ca, st * sa, st, ct * ca, -ct * sa, 0, sa, ca;
+    transform.translation() << p_.a[i] * ct, p_.a[i] * st, p_.d[i];
+    return transform;
+  }
+
+  Parameters p_{};
+};
+}  // namespace kuka_controllers
+
+#endif  // CARTESIAN_SERVO_CONTROLLER__DLS_KINEMATICS_HPP_
@@ -0,0 +1,88 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CARTESIAN_SERVO_CONTROLLER__OPW_KINEMATICS_HPP_
+#define CARTESIAN_SERVO_CONTROLLER__OPW_KINEMATICS_HPP_
+
+#include <array>
+
+#include <Eigen/Geometry>
+
+namespace kuka_controllers
+{
+/**
+ * @brief Closed-form kinematics of 6 axis industrial robots with ortho-parallel base and
+ *  spherical wrist (OPW), e.g. the KR robot family
+ *
+ * The geometry is described by the parameters defined in M. Brandstötter, A. Angerer and
+ *  M. Hofbaur: An Analytical Solution of the Inverse Kinematics Problem of Industrial Serial
+ *  Manipulators with an Ortho-parallel Basis and a Spherical Wrist (2014).
+ * None of the methods allocate memory.
+ */
+class OPWKinematics
+{
+public:
+  using Vector6d = Eigen::Matrix<double, 6, 1>;
+
+  struct Parameters
+  {
+    double a1 = 0;
+    double a2 = 0;
+    double b = 0;
+    double c1 = 0;
+    double c2 = 0;
+    double c3 = 0;
+    double c4 = 0;
+    Vector6d offsets = Vector6d::Zero();
+    Vector6d sign_corrections = Vector6d::Ones();
+  };
+
+  static constexpr std::size_t SOLUTION_COUNT = 8;
+  using Solutions = std::array<Vector6d, SOLUTION_COUNT>;
+
+  OPWKinematics() = default;
+  explicit OPWKinematics(const Parameters & parameters) : p_(parameters) {}
+
+  /**
+   * @brief Calculates the pose of the flange in the base frame
+   */
+  Eigen::Isometry3d forward(const Vector6d & joints) const;
+
+  /**
+   * @brief Calculates all joint configurations reaching the given flange pose
+   *
+   * @param pose: Pose of the flange in the base frame
+   * @param solutions: Array for the 8 solutions, unreachable solutions contain NaN values
+   */
+  void inverse(const Eigen::Isometry3d & pose, Solutions & solutions) const;
+
+  /**
+   * @brief Selects the valid solution closest to the reference configuration
+   *
+   * Every joint angle is shifted by multiples of 2*pi to be the closest to the reference.
+   *
+   * @param solutions: Solutions calculated by inverse()
+   * @param reference: Actual joint configuration
+   * @param result: The selected solution
+   * @return bool: False if none of the solutions are valid
+   */
+  static bool selectClosest(
+    const Solutions & solutions, const Vector6d & reference, Vector6d & result);
+
+private:
+  Parameters p_{};
+};
+}  // namespace kuka_controllers
+
+#endif  // CARTESIAN_SERVO_CONTROLLER__OPW_KINEMATICS_HPP_
@@ -0,0 +1,291 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+
+#include "cartesian_servo_controller/cartesian_servo_controller.hpp"
+
+namespace kuka_controllers
+{
+namespace
+{
+// Remaining pose error of the inverse kinematics, above which the target is not tracked further
+constexpr double MAX_TRACKING_ERROR = 1e-3;
+constexpr double DLS_TOLERANCE = 1e-7;
+}  // namespace
+
+controller_interface::CallbackReturn CartesianServoController::on_init()
+{
+  try
+  {
+    param_listener_ = std::make_shared<ParamListener>(get_node());
+    params_ = param_listener_->get_params();
+  }
+  catch (const std::exception & e)
+  {
+    fprintf(stderr, "Exception thrown during init stage with message: %s \n", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::InterfaceConfiguration
+CartesianServoController::command_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_POSITION);
+  }
+  return config;
+}
+
+controller_interface::InterfaceConfiguration
+CartesianServoController::state_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_POSITION);
+  }
+  return config;
+}
+
+controller_interface::CallbackReturn CartesianServoController::on_configure(
+  const rclcpp_lifecycle::State &)
+{
+  params_ = param_listener_->get_params();
+  use_opw_ = params_.kinematics == "opw";
+  const std::size_t expected_joints = use_opw_ ? 6 : MAX_DOF;
+  if (params_.joints.size() != expected_joints)
+  {
+    RCLCPP_ERROR(
+      get_node()->get_logger(), "'%s' kinematics requires %zu joints, got %zu",
+      params_.kinematics.c_str(), expected_joints, params_.joints.size());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+
+  if (use_opw_)
+  {
+    OPWKinematics::Parameters opw;
+    opw.a1 = params_.opw.a1;
+    opw.a2 = params_.opw.a2;
+    opw.b = params_.opw.b;
+    opw.c1 = params_.opw.c1;
+    opw.c2 = params_.opw.c2;
+    opw.c3 = params_.opw.c3;
+    opw.c4 = params_.opw.c4;
+    opw.offsets = Eigen::Map<const OPWKinematics::Vector6d>(params_.opw.offsets.data());
+    opw.sign_corrections =
+      Eigen::Map<const OPWKinematics::Vector6d>(params_.opw.sign_corrections.data());
+    opw_ = OPWKinematics(opw);
+  }
+  else
+  {
+    using DLSVector = DLSKinematics<MAX_DOF>::Vector;
+    DLSKinematics<MAX_DOF>::Parameters dh;
+    dh.a = Eigen::Map<const DLSVector>(params_.dh.a.data());
+    dh.alpha = Eigen::Map<const DLSVector>(params_.dh.alpha.data());
+    dh.d = Eigen::Map<const DLSVector>(params_.dh.d.data());
+    dh.theta_offsets = Eigen::Map<const DLSVector>(params_.dh.theta_offsets.data());
+    dls_ = DLSKinematics<MAX_DOF>(dh);
+  }
+
+  flange_frame_twist_ = params_.twist_frame == "flange";
+  command_timeout_ns_ = rclcpp::Duration::from_seconds(params_.command_timeout).nanoseconds();
+  joints_.setZero(static_cast<Eigen::Index>(expected_joints));
+  rest_joints_.setZero(static_cast<Eigen::Index>(expected_joints));
+
+  twist_subscriber_ = get_node()->create_subscription<geometry_msgs::msg::TwistStamped>(
+    "~/twist", rclcpp::SystemDefaultsQoS(),
+    [this](const geometry_msgs::msg::TwistStamped::SharedPtr msg) { onTwist(msg); });
+  pose_subscriber_ = get_node()->create_subscription<geometry_msgs::msg::PoseStamped>(
+    "~/pose", rclcpp::SystemDefaultsQoS(),
+    [this](const geometry_msgs::msg::PoseStamped::SharedPtr msg) { onPose(msg); });
+
+  RCLCPP_INFO(
+    get_node()->get_logger(), "Cartesian servo controller configured with '%s' kinematics",
+    params_.kinematics.c_str());
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn CartesianServoController::on_activate(
+  const rclcpp_lifecycle::State &)
+{
+  for (Eigen::Index i = 0; i < joints_.size(); ++i)
+  {
+    joints_[i] = state_interfaces_[static_cast<std::size_t>(i)].get_value();
+  }
+  rest_joints_ = joints_;
+  target_ = forward(joints_);
+
+  // Commands received before activation are not executed
+  command_buffer_.writeFromNonRT(ServoCommand{});
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn CartesianServoController::on_deactivate(
+  const rclcpp_lifecycle::State &)
+{
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::return_type CartesianServoController::update(
+  const rclcpp::Time & time, const rclcpp::Duration & period)
+{
+  const double dt = period.seconds();
+  moveTarget(*command_buffer_.readFromRT(), time.nanoseconds(), dt);
+
+  JointVector solution = joints_;
+  bool tracking = inverse(target_, solution);
+  if (tracking)
+  {
+    const double max_step = params_.max_joint_velocity * dt;
+    for (Eigen::Index i = 0; i < joints_.size(); ++i)
+    {
+      const double step = solution[i] - joints_[i];
+      if (std::abs(step) > max_step)
+      {
+        tracking = false;
+      }
+      joints_[i] += std::clamp(step, -max_step, max_step);
+    }
+  }
+  if (!tracking)
+  {
+    // The target is pulled back to the commanded pose to avoid running away from the robot
+    target_ = forward(joints_);
+  }
+
+  for (Eigen::Index i = 0; i < joints_.size(); ++i)
+  {
+    command_interfaces_[static_cast<std::size_t>(i)].set_value(joints_[i]);
+  }
+  return controller_interface::return_type::OK;
+}
+
+void CartesianServoController::moveTarget(const ServoCommand & command, int64_t now, double dt)
+{
+  Eigen::Vector3d translation = Eigen::Vector3d::Zero();
+  Eigen::AngleAxisd rotation = Eigen::AngleAxisd::Identity();
+  switch (command.type)
+  {
+    case CommandType::NONE:
+      return;
+    case CommandType::TWIST:
+    {
+      if (now - command.received > command_timeout_ns_)
+      {
+        return;
+      }
+      translation = command.linear * dt;
+      const Eigen::Vector3d angle_axis = command.angular * dt;
+      if (angle_axis.norm() > 0)
+      {
+        rotation = Eigen::AngleAxisd(angle_axis.norm(), angle_axis.normalized());
+      }
+      if (flange_frame_twist_)
+      {
+        translation = target_.linear() * translation;
+        rotation.axis() = target_.linear() * rotation.axis();
+      }
+      break;
+    }
+    case CommandType::POSE:
+      translation = command.position - target_.translation();
+      rotation =
+        Eigen::AngleAxisd(command.orientation.toRotationMatrix() * target_.linear().transpose());
+      break;
+  }
+
+  const double max_translation = params_.max_linear_velocity * dt;
+  if (translation.norm() > max_translation)
+  {
+    translation *= max_translation / translation.norm();
+  }
+  rotation.angle() = std::min(rotation.angle(), params_.max_angular_velocity * dt);
+
+  target_.translation() += translation;
+  target_.linear() = (rotation.toRotationMatrix() * target_.linear()).eval();
+}
+
+Eigen::Isometry3d CartesianServoController::forward(const JointVector & joints) const
+{
+  if (use_opw_)
+  {
+    return opw_.forward(joints.head<6>());
+  }
+  return dls_.forward(joints.head<MAX_DOF>());
+}
+
+bool CartesianServoController::inverse(
+  const Eigen::Isometry3d & target, JointVector & joints) const
+{
+  if (use_opw_)
+  {
+    OPWKinematics::Solutions solutions;
+    opw_.inverse(target, solutions);
+    OPWKinematics::Vector6d result;
+    if (!OPWKinematics::selectClosest(solutions, joints.head<6>(), result))
+    {
+      return false;
+    }
+    joints.head<6>() = result;
+    return true;
+  }
+
+  DLSKinematics<MAX_DOF>::Vector result = joints.head<MAX_DOF>();
+  const double error = dls_.solve(
+    target, result, static_cast<int>(params_.dls.iterations), params_.dls.damping,
+    rest_joints_.head<MAX_DOF>(), params_.dls.nullspace_gain, DLS_TOLERANCE);
+  joints.head<MAX_DOF>() = result;
+  return error < MAX_TRACKING_ERROR;
+}
+
+void CartesianServoController::onTwist(const geometry_msgs::msg::TwistStamped::SharedPtr msg)
+{
+  ServoCommand command;
+  command.type = CommandType::TWIST;
+  command.linear << msg->twist.linear.x, msg->twist.linear.y, msg->twist.linear.z;
+  command.angular << msg->twist.angular.x, msg->twist.angular.y, msg->twist.angular.z;
+  command.received = get_node()->now().nanoseconds();
+  command_buffer_.writeFromNonRT(command);
+}
+
+void CartesianServoController::onPose(const geometry_msgs::msg::PoseStamped::SharedPtr msg)
+{
+  const auto & orientation = msg->pose.orientation;
+  Eigen::Quaterniond quaternion(orientation.w, orientation.x, orientation.y, orientation.z);
+  if (quaternion.norm() < 1e-6)
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "Invalid orientation in pose command, ignoring it");
+    return;
+  }
+
+  ServoCommand command;
+  command.type = CommandType::POSE;
+  command.position << msg->pose.position.x, msg->pose.position.y, msg->pose.position.z;
+  command.orientation = quaternion.normalized();
+  command.received = get_node()->now().nanoseconds();
+  command_buffer_.writeFromNonRT(command);
+}
+}  // namespace kuka_controllers
+
+PLUGINLIB_EXPORT_CLASS(
+  kuka_controllers::CartesianServoController, controller_interface::ControllerInterface)
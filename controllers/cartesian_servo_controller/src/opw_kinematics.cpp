@@ -0,0 +1,155 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "cartesian_servo_controller/opw_kinematics.hpp"
+
+namespace kuka_controllers
+{
+Eigen::Isometry3d OPWKinematics::forward(const Vector6d & joints) const
+{
+  const Vector6d q = joints.cwiseProduct(p_.sign_corrections) - p_.offsets;
+
+  const double psi3 = std::atan2(p_.a2, p_.c3);
+  const double k = std::hypot(p_.a2, p_.c3);
+
+  const double cx1 = p_.c2 * std::sin(q[1]) + k * std::sin(q[1] + q[2] + psi3) + p_.a1;
+  const double cy1 = p_.b;
+  const double cz1 = p_.c2 * std::cos(q[1]) + k * std::cos(q[1] + q[2] + psi3);
+
+  const Eigen::Vector3d wrist_center(
+    cx1 * std::cos(q[0]) - cy1 * std::sin(q[0]), cx1 * std::sin(q[0]) + cy1 * std::cos(q[0]),
+    cz1 + p_.c1);
+
+  const double s1 = std::sin(q[0]), c1 = std::cos(q[0]);
+  const double s2 = std::sin(q[1]), c2 = std::cos(q[1]);
+  const double s3 = std::sin(q[2]), c3 = std::cos(q[2]);
+  const double s4 = std::sin(q[3]), c4 = std::cos(q[3]);
+  const double s5 = std::sin(q[4]), c5 = std::cos(q[4]);
+  const double s6 = std::sin(q[5]), c6 = std::cos(q[5]);
+
+  Eigen::Matrix3d r_0c;
+  r_0c << c1 * c2 * c3 - c1 * s2 * s3, -s1, c1 * c2 * s3 + c1 * s2 * c3,
+    s1 * c2 * c3 - s1 * s2 * s3, c1, s1 * c2 * s3 + s1 * s2 * c3, -s2 * c3 - c2 * s3, 0,
+    -s2 * s3 + c2 * c3;
+
+  Eigen::Matrix3d r_ce;
+  r_ce << c4 * c5 * c6 - s4 * s6, -c4 * c5 * s6 - s4 * c6, c4 * s5, s4 * c5 * c6 + c4 * s6,
+    -s4 * c5 * s6 + c4 * c6, s4 * s5, -s5 * c6, s5 * s6, c5;
+
+  Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+  pose.linear() = r_0c * r_ce;
+  pose.translation() = wrist_center + p_.c4 * pose.linear().col(2);
+  return pose;
+}
+
+void OPWKinematics::inverse(const Eigen::Isometry3d & pose, Solutions & solutions) const
+{
+  const Eigen::Matrix3d & r = pose.linear();
+  const Eigen::Vector3d c = pose.translation() - p_.c4 * r.col(2);
+
+  // Joint 1
+  const double nx1 = std::sqrt(c.x() * c.x() + c.y() * c.y() - p_.b * p_.b) - p_.a1;
+  const double tmp1 = std::atan2(c.y(), c.x());
+  const double tmp2 = std::atan2(p_.b, nx1 + p_.a1);
+  const double theta1_i = tmp1 - tmp2;
+  const double theta1_ii = tmp1 + tmp2 - M_PI;
+
+  // Joints 2 and 3
+  const double tmp3 = c.z() - p_.c1;
+  const double s1_2 = nx1 * nx1 + tmp3 * tmp3;
+  const double tmp4 = nx1 + 2 * p_.a1;
+  const double s2_2 = tmp4 * tmp4 + tmp3 * tmp3;
+  const double kappa_2 = p_.a2 * p_.a2 + p_.c3 * p_.c3;
+  const double c2_2 = p_.c2 * p_.c2;
+  const double s1 = std::sqrt(s1_2);
+  const double s2 = std::sqrt(s2_2);
+
+  const double tmp13 = std::acos((s1_2 + c2_2 - kappa_2) / (2 * s1 * p_.c2));
+  const double tmp14 = std::atan2(nx1, tmp3);
+  const double theta2_i = -tmp13 + tmp14;
+  const double theta2_ii = tmp13 + tmp14;
+
+  const double tmp15 = std::acos((s2_2 + c2_2 - kappa_2) / (2 * s2 * p_.c2));
+  const double tmp16 = std::atan2(tmp4, tmp3);
+  const double theta2_iii = -tmp15 - tmp16;
+  const double theta2_iv = tmp15 - tmp16;
+
+  const double tmp9 = 2 * p_.c2 * std::sqrt(kappa_2);
+  const double tmp10 = std::atan2(p_.a2, p_.c3);
+  const double tmp11 = std::acos((s1_2 - c2_2 - kappa_2) / tmp9);
+  const double tmp12 = std::acos((s2_2 - c2_2 - kappa_2) / tmp9);
+  const double theta3_i = tmp11 - tmp10;
+  const double theta3_ii = -tmp11 - tmp10;
+  const double theta3_iii = tmp12 - tmp10;
+  const double theta3_iv = -tmp12 - tmp10;
+
+  // Wrist joints for the 4 arm configurations, the flipped wrist gives the other 4 solutions
+  const std::array<double, 4> theta1 = {theta1_i, theta1_i, theta1_ii, theta1_ii};
+  const std::array<double, 4> theta2 = {theta2_i, theta2_ii, theta2_iii, theta2_iv};
+  const std::array<double, 4> theta3 = {theta3_i, theta3_ii, theta3_iii, theta3_iv};
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    const double sin1 = std::sin(theta1[i]);
+    const double cos1 = std::cos(theta1[i]);
+    const double s23 = std::sin(theta2[i] + theta3[i]);
+    const double c23 = std::cos(theta2[i] + theta3[i]);
+
+    const double m = r(0, 2) * s23 * cos1 + r(1, 2) * s23 * sin1 + r(2, 2) * c23;
+    const double theta4 = std::atan2(
+      r(1, 2) * cos1 - r(0, 2) * sin1,
+      r(0, 2) * c23 * cos1 + r(1, 2) * c23 * sin1 - r(2, 2) * s23);
+    const double theta5 = std::atan2(std::sqrt(std::max(0.0, 1 - m * m)), m);
+    const double theta6 = std::atan2(
+      r(0, 1) * s23 * cos1 + r(1, 1) * s23 * sin1 + r(2, 1) * c23,
+      -r(0, 0) * s23 * cos1 - r(1, 0) * s23 * sin1 - r(2, 0) * c23);
+
+    solutions[i] << theta1[i], theta2[i], theta3[i], theta4, theta5, theta6;
+    solutions[i + 4] << theta1[i], theta2[i], theta3[i], theta4 + M_PI, -theta5, theta6 - M_PI;
+  }
+
+  for (auto & solution : solutions)
+  {
+    solution = (solution + p_.offsets).cwiseProduct(p_.sign_corrections);
+  }
+}
+
+bool OPWKinematics::selectClosest(
+  const Solutions & solutions, const Vector6d & reference, Vector6d & result)
+{
+  double best_distance = std::numeric_limits<double>::infinity();
+  for (const auto & solution : solutions)
+  {
+    if (!solution.allFinite())
+    {
+      continue;
+    }
+    Vector6d candidate;
+    for (int i = 0; i < 6; ++i)
+    {
+      candidate[i] = reference[i] + std::remainder(solution[i] - reference[i], 2 * M_PI);
+    }
+    const double distance = (candidate - reference).squaredNorm();
+    if (distance < best_distance)
+    {
+      best_distance = distance;
+      result = candidate;
+    }
+  }
+  return std::isfinite(best_distance);
+}
+}  // namespace kuka_controllers
@@ -0,0 +1,130 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CONTACT_DETECTION_CONTROLLER__CONTACT_DETECTION_CONTROLLER_HPP_
+#define CONTACT_DETECTION_CONTROLLER__CONTACT_DETECTION_CONTROLLER_HPP_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "controller_interface/chainable_controller_interface.hpp"
+#include "kuka_driver_interfaces/msg/contact_event.hpp"
+#include "pluginlib/class_list_macros.hpp"
+#include "rclcpp/duration.hpp"
+#include "rclcpp/time.hpp"
+#include "realtime_tools/realtime_publisher.h"
+#include "std_srvs/srv/trigger.hpp"
+
+#include "contact_detection_controller/torque_monitor.hpp"
+#include "contact_detection_controller/visibility_control.h"
+#include "contact_detection_controller_parameters.hpp"
+
+namespace kuka_controllers
+{
+/**
+ * @brief Chainable controller that forwards the position references of an upstream controller
+ *  and overrides them in the same cycle, if the external torques indicate a contact
+ *
+ * The reaction is latched until it is reset with the ~/reset service.
+ */
+class ContactDetectionController : public controller_interface::ChainableControllerInterface
+{
+public:
+  CONTACT_DETECTION_CONTROLLER_PUBLIC controller_interface::InterfaceConfiguration
+  command_interface_configuration() const override;
+
+  CONTACT_DETECTION_CONTROLLER_PUBLIC controller_interface::InterfaceConfiguration
+  state_interface_configuration() const override;
+
+  CONTACT_DETECTION_CONTROLLER_PUBLIC controller_interface::return_type update_and_write_commands(
+    const rclcpp::Time & time, const rclcpp::Duration & period) override;
+
+  CONTACT_DETECTION_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_configure(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  CONTACT_DETECTION_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_activate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  CONTACT_DETECTION_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_deactivate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  CONTACT_DETECTION_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_init() override;
+
+protected:
+  std::vector<hardware_interface::CommandInterface> on_export_reference_interfaces() override;
+
+  controller_interface::return_type update_reference_from_subscribers(
+    const rclcpp::Time & time, const rclcpp::Duration & period) override;
+
+private:
+  enum class Reaction : std::uint8_t
+  {
+    STOP = 0,
+    RETRACT = 1,
+    COMPLIANT = 2
+  };
+
+  enum class State
+  {
+    CALIBRATING,
+    MONITORING,
+    REACTING
+  };
+
+  CONTACT_DETECTION_CONTROLLER_LOCAL void startReaction(
+    std::size_t joint, const rclcpp::Time & time);
+  CONTACT_DETECTION_CONTROLLER_LOCAL void writeReaction(const rclcpp::Time & time);
+  CONTACT_DETECTION_CONTROLLER_LOCAL void writeReferences();
+  CONTACT_DETECTION_CONTROLLER_LOCAL bool impedanceClaimed() const
+  {
+    return reaction_ == Reaction::COMPLIANT;
+  }
+
+  using Params = contact_detection_controller::Params;
+  using ParamListener = contact_detection_controller::ParamListener;
+
+  std::shared_ptr<ParamListener> param_listener_;
+  Params params_;
+  Reaction reaction_ = Reaction::STOP;
+  std::size_t interfaces_per_joint_ = 1;
+
+  TorqueMonitor monitor_;
+  State state_ = State::MONITORING;
+  int calibration_cycles_left_ = 0;
+  std::vector<double> torques_;
+  std::vector<double> torque_offsets_;
+
+  // Ring buffer of the commanded positions, indexed as [sample * joints + joint]
+  std::vector<double> position_history_;
+  std::size_t history_head_ = 0;
+  std::size_t history_size_ = 0;
+  std::size_t history_capacity_ = 1;
+
+  std::vector<double> reaction_start_;
+  std::vector<double> reaction_target_;
+  rclcpp::Time reaction_time_;
+
+  std::atomic<double> reference_deviation_{0.0};
+  std::atomic<bool> reacting_{false};
+  std::atomic<bool> reset_requested_{false};
+
+  rclcpp::Service<std_srvs::srv::Trigger>::SharedPtr reset_service_;
+  std::shared_ptr<rclcpp::Publisher<kuka_driver_interfaces::msg::ContactEvent>> event_publisher_;
+  std::unique_ptr<realtime_tools::RealtimePublisher<kuka_driver_interfaces::msg::ContactEvent>>
+    rt_event_publisher_;
+};
+}  // namespace kuka_controllers
+#endif  // CONTACT_DETECTION_CONTROLLER__CONTACT_DETECTION_CONTROLLER_HPP_
@@ -0,0 +1,71 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CONTACT_DETECTION_CONTROLLER__TORQUE_MONITOR_HPP_
+#define CONTACT_DETECTION_CONTROLLER__TORQUE_MONITOR_HPP_
+
+#include <cstddef>
+#include <vector>
+
+namespace kuka_controllers
+{
+/**
+ * @brief Detects contacts based on the low-pass filtered external torques and their derivatives
+ *
+ * Memory is allocated only in configure(), update() can be called from the control loop.
+ */
+class TorqueMonitor
+{
+public:
+  /**
+   * @brief Sets up the monitor for the given number of joints
+   *
+   * @param torque_thresholds: Absolute torque limit for every joint
+   * @param derivative_thresholds: Absolute limit of the torque derivative for every joint,
+   *  zero disables the derivative check of the joint, empty disables it for all joints
+   * @param cutoff_frequency: Cutoff frequency of the first order low-pass filter in Hz,
+   *  zero disables filtering
+   */
+  void configure(
+    const std::vector<double> & torque_thresholds,
+    const std::vector<double> & derivative_thresholds, double cutoff_frequency);
+
+  /**
+   * @brief Clears the filter states, the next sample initializes the filters
+   */
+  void reset();
+
+  /**
+   * @brief Processes one sample of external torques
+   *
+   * @param torques: Array with one external torque for every joint
+   * @param dt: Time elapsed since the previous sample in seconds
+   * @return int: Index of the first joint exceeding a threshold, -1 if there is no contact
+   */
+  int update(const double * torques, double dt);
+
+  double filteredTorque(std::size_t joint) const { return filtered_[joint]; }
+  double torqueDerivative(std::size_t joint) const { return derivatives_[joint]; }
+
+private:
+  std::vector<double> torque_thresholds_;
+  std::vector<double> derivative_thresholds_;
+  std::vector<double> filtered_;
+  std::vector<double> derivatives_;
+  double time_constant_ = 0;
+  bool initialized_ = false;
+};
+}  // namespace kuka_controllers
+
+#endif  // CONTACT_DETECTION_CONTROLLER__TORQUE_MONITOR_HPP_
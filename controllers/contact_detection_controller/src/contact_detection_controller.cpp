@@ -0,0 +1,370 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "kuka_drivers_core/hardware_interface_types.hpp"
+
+#include "contact_detection_controller/contact_detection_controller.hpp"
+
+namespace kuka_controllers
+{
+controller_interface::CallbackReturn ContactDetectionController::on_init()
+{
+  try
+  {
+    param_listener_ = std::make_shared<ParamListener>(get_node());
+    params_ = param_listener_->get_params();
+  }
+  catch (const std::exception & e)
+  {
+    fprintf(stderr, "Exception thrown during init stage with message: %s \n", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::InterfaceConfiguration
+ContactDetectionController::command_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_POSITION);
+    if (impedanceClaimed())
+    {
+      config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_STIFFNESS);
+      config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_DAMPING);
+    }
+  }
+  return config;
+}
+
+controller_interface::InterfaceConfiguration
+ContactDetectionController::state_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_POSITION);
+  }
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + params_.torque_interface);
+  }
+  return config;
+}
+
+controller_interface::CallbackReturn ContactDetectionController::on_configure(
+  const rclcpp_lifecycle::State &)
+{
+  params_ = param_listener_->get_params();
+  const std::size_t joints = params_.joints.size();
+  if (joints == 0)
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "'joints' parameter is empty");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  if (params_.torque_thresholds.size() != joints)
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "'torque_thresholds' must have a value for every joint");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  if (
+    !params_.torque_derivative_thresholds.empty() &&
+    params_.torque_derivative_thresholds.size() != joints)
+  {
+    RCLCPP_ERROR(
+      get_node()->get_logger(),
+      "'torque_derivative_thresholds' must be empty or have a value for every joint");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+
+  if (params_.reaction == "retract")
+  {
+    reaction_ = Reaction::RETRACT;
+  }
+  else if (params_.reaction == "compliant")
+  {
+    reaction_ = Reaction::COMPLIANT;
+    if (params_.compliant_stiffness.size() != joints || params_.compliant_damping.size() != joints)
+    {
+      RCLCPP_ERROR(
+        get_node()->get_logger(),
+        "'compliant_stiffness' and 'compliant_damping' must have a value for every joint");
+      return controller_interface::CallbackReturn::ERROR;
+    }
+  }
+  else
+  {
+    reaction_ = Reaction::STOP;
+  }
+  interfaces_per_joint_ = impedanceClaimed() ? 3 : 1;
+  reference_interfaces_.assign(
+    joints * interfaces_per_joint_, std::numeric_limits<double>::quiet_NaN());
+
+  monitor_.configure(
+    params_.torque_thresholds, params_.torque_derivative_thresholds,
+    params_.filter_cutoff_frequency);
+  torques_.assign(joints, 0.0);
+  torque_offsets_.assign(joints, 0.0);
+
+  history_capacity_ = std::max<std::size_t>(
+    1, static_cast<std::size_t>(std::lround(params_.retract_time * get_update_rate())));
+  position_history_.assign(history_capacity_ * joints, 0.0);
+  reaction_start_.assign(joints, 0.0);
+  reaction_target_.assign(joints, 0.0);
+
+  event_publisher_ = get_node()->create_publisher<kuka_driver_interfaces::msg::ContactEvent>(
+    "~/contact_event", rclcpp::SystemDefaultsQoS());
+  rt_event_publisher_ =
+    std::make_unique<realtime_tools::RealtimePublisher<kuka_driver_interfaces::msg::ContactEvent>>(
+      event_publisher_);
+
+  reset_service_ = get_node()->create_service<std_srvs::srv::Trigger>(
+    "~/reset",
+    [this](
+      const std_srvs::srv::Trigger::Request::SharedPtr,
+      std_srvs::srv::Trigger::Response::SharedPtr response)
+    {
+      if (!reacting_)
+      {
+        response->success = true;
+        response->message = "No active contact reaction";
+        return;
+      }
+      // Resuming is allowed only if the upstream references do not cause a jump
+      const double deviation = reference_deviation_;
+      if (deviation > params_.resume_tolerance)
+      {
+        response->success = false;
+        response->message = "References deviate by " + std::to_string(deviation) +
+                            " rad from the actual setpoints, update the references first";
+        return;
+      }
+      reset_requested_ = true;
+      response->success = true;
+      response->message = "Contact reaction reset";
+    });
+
+  RCLCPP_INFO(
+    get_node()->get_logger(), "Contact detection controller configured with '%s' reaction",
+    params_.reaction.c_str());
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn ContactDetectionController::on_activate(
+  const rclcpp_lifecycle::State &)
+{
+  const std::size_t joints = params_.joints.size();
+  for (std::size_t i = 0; i < joints; ++i)
+  {
+    reference_interfaces_[i * interfaces_per_joint_] = state_interfaces_[i].get_value();
+    if (impedanceClaimed())
+    {
+      reference_interfaces_[i * interfaces_per_joint_ + 1] =
+        command_interfaces_[i * interfaces_per_joint_ + 1].get_value();
+      reference_interfaces_[i * interfaces_per_joint_ + 2] =
+        command_interfaces_[i * interfaces_per_joint_ + 2].get_value();
+    }
+  }
+
+  std::fill(torque_offsets_.begin(), torque_offsets_.end(), 0.0);
+  calibration_cycles_left_ = static_cast<int>(params_.offset_calibration_cycles);
+  state_ = calibration_cycles_left_ > 0 ? State::CALIBRATING : State::MONITORING;
+  monitor_.reset();
+  history_head_ = 0;
+  history_size_ = 0;
+  reacting_ = false;
+  reset_requested_ = false;
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn ContactDetectionController::on_deactivate(
+  const rclcpp_lifecycle::State &)
+{
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+std::vector<hardware_interface::CommandInterface>
+ContactDetectionController::on_export_reference_interfaces()
+{
+  std::vector<hardware_interface::CommandInterface> reference_interfaces;
+  for (std::size_t i = 0; i < params_.joints.size(); ++i)
+  {
+    reference_interfaces.emplace_back(
+      get_node()->get_name(), params_.joints[i] + "/" + hardware_interface::HW_IF_POSITION,
+      &reference_interfaces_[i * interfaces_per_joint_]);
+    if (impedanceClaimed())
+    {
+      reference_interfaces.emplace_back(
+        get_node()->get_name(), params_.joints[i] + "/" + hardware_interface::HW_IF_STIFFNESS,
+        &reference_interfaces_[i * interfaces_per_joint_ + 1]);
+      reference_interfaces.emplace_back(
+        get_node()->get_name(), params_.joints[i] + "/" + hardware_interface::HW_IF_DAMPING,
+        &reference_interfaces_[i * interfaces_per_joint_ + 2]);
+    }
+  }
+  return reference_interfaces;
+}
+
+controller_interface::return_type ContactDetectionController::update_reference_from_subscribers(
+  const rclcpp::Time &, const rclcpp::Duration &)
+{
+  // Without an upstream controller the last references are held
+  return controller_interface::return_type::OK;
+}
+
+controller_interface::return_type ContactDetectionController::update_and_write_commands(
+  const rclcpp::Time & time, const rclcpp::Duration & period)
+{
+  const std::size_t joints = params_.joints.size();
+  if (reset_requested_.exchange(false) && state_ == State::REACTING)
+  {
+    monitor_.reset();
+    state_ = State::MONITORING;
+    reacting_ = false;
+  }
+
+  switch (state_)
+  {
+    case State::CALIBRATING:
+      for (std::size_t i = 0; i < joints; ++i)
+      {
+        torque_offsets_[i] +=
+          state_interfaces_[joints + i].get_value() / params_.offset_calibration_cycles;
+      }
+      if (--calibration_cycles_left_ <= 0)
+      {
+        state_ = State::MONITORING;
+      }
+      writeReferences();
+      break;
+    case State::MONITORING:
+    {
+      for (std::size_t i = 0; i < joints; ++i)
+      {
+        torques_[i] = state_interfaces_[joints + i].get_value() - torque_offsets_[i];
+      }
+      const int contact_joint = monitor_.update(torques_.data(), period.seconds());
+      if (contact_joint >= 0)
+      {
+        // React in the same cycle, the references of this cycle are not forwarded
+        startReaction(static_cast<std::size_t>(contact_joint), time);
+        writeReaction(time);
+      }
+      else
+      {
+        writeReferences();
+      }
+      break;
+    }
+    case State::REACTING:
+      writeReaction(time);
+      break;
+  }
+
+  return controller_interface::return_type::OK;
+}
+
+void ContactDetectionController::writeReferences()
+{
+  const std::size_t joints = params_.joints.size();
+  for (std::size_t i = 0; i < joints; ++i)
+  {
+    for (std::size_t k = 0; k < interfaces_per_joint_; ++k)
+    {
+      const double reference = reference_interfaces_[i * interfaces_per_joint_ + k];
+      if (!std::isnan(reference))
+      {
+        command_interfaces_[i * interfaces_per_joint_ + k].set_value(reference);
+      }
+    }
+    position_history_[history_head_ * joints + i] =
+      command_interfaces_[i * interfaces_per_joint_].get_value();
+  }
+  history_head_ = (history_head_ + 1) % history_capacity_;
+  history_size_ = std::min(history_size_ + 1, history_capacity_);
+}
+
+void ContactDetectionController::startReaction(std::size_t joint, const rclcpp::Time & time)
+{
+  const std::size_t joints = params_.joints.size();
+  state_ = State::REACTING;
+  reacting_ = true;
+  reaction_time_ = time;
+
+  // The oldest sample of the history is the position commanded 'retract_time' before the contact
+  const std::size_t oldest = history_size_ < history_capacity_ ? 0 : history_head_;
+  for (std::size_t i = 0; i < joints; ++i)
+  {
+    reaction_start_[i] = state_interfaces_[i].get_value();
+    reaction_target_[i] = reaction_ == Reaction::RETRACT && history_size_ > 0
+                            ? position_history_[oldest * joints + i]
+                            : reaction_start_[i];
+  }
+
+  if (rt_event_publisher_->trylock())
+  {
+    auto & msg = rt_event_publisher_->msg_;
+    msg.header.stamp = time;
+    msg.joint_name = params_.joints[joint];
+    msg.torque = monitor_.filteredTorque(joint);
+    msg.torque_derivative = monitor_.torqueDerivative(joint);
+    msg.reaction = static_cast<uint8_t>(reaction_);
+    rt_event_publisher_->unlockAndPublish();
+  }
+}
+
+void ContactDetectionController::writeReaction(const rclcpp::Time & time)
+{
+  const std::size_t joints = params_.joints.size();
+  double progress = 1.0;
+  if (reaction_ == Reaction::RETRACT && params_.retract_duration > 0)
+  {
+    const double s =
+      std::clamp((time - reaction_time_).seconds() / params_.retract_duration, 0.0, 1.0);
+    progress = 0.5 - 0.5 * std::cos(M_PI * s);
+  }
+
+  double deviation = 0;
+  for (std::size_t i = 0; i < joints; ++i)
+  {
+    double position;
+    if (reaction_ == Reaction::COMPLIANT)
+    {
+      // Commanding the measured position removes the spring force of the impedance control
+      position = state_interfaces_[i].get_value();
+      command_interfaces_[i * interfaces_per_joint_ + 1].set_value(params_.compliant_stiffness[i]);
+      command_interfaces_[i * interfaces_per_joint_ + 2].set_value(params_.compliant_damping[i]);
+    }
+    else
+    {
+      position = reaction_start_[i] + progress * (reaction_target_[i] - reaction_start_[i]);
+    }
+    command_interfaces_[i * interfaces_per_joint_].set_value(position);
+    deviation =
+      std::max(deviation, std::abs(reference_interfaces_[i * interfaces_per_joint_] - position));
+  }
+  reference_deviation_ = deviation;
+}
+}  // namespace kuka_controllers
+
+PLUGINLIB_EXPORT_CLASS(
+  kuka_controllers::ContactDetectionController, controller_interface::ChainableControllerInterface)
@@ -0,0 +1,73 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+
+#include "contact_detection_controller/torque_monitor.hpp"
+
+namespace kuka_controllers
+{
+void TorqueMonitor::configure(
+  const std::vector<double> & torque_thresholds,
+  const std::vector<double> & derivative_thresholds, double cutoff_frequency)
+{
+  torque_thresholds_ = torque_thresholds;
+  derivative_thresholds_ = derivative_thresholds;
+  if (derivative_thresholds_.empty())
+  {
+    derivative_thresholds_.assign(torque_thresholds_.size(), 0.0);
+  }
+  filtered_.assign(torque_thresholds_.size(), 0.0);
+  derivatives_.assign(torque_thresholds_.size(), 0.0);
+  time_constant_ = cutoff_frequency > 0 ? 1.0 / (2 * M_PI * cutoff_frequency) : 0.0;
+  initialized_ = false;
+}
+
+void TorqueMonitor::reset() { initialized_ = false; }
+
+int TorqueMonitor::update(const double * torques, double dt)
+{
+  const std::size_t joints = torque_thresholds_.size();
+  if (!initialized_ || dt <= 0)
+  {
+    for (std::size_t i = 0; i < joints; ++i)
+    {
+      filtered_[i] = torques[i];
+      derivatives_[i] = 0.0;
+    }
+    initialized_ = true;
+  }
+  else
+  {
+    const double alpha = dt / (time_constant_ + dt);
+    for (std::size_t i = 0; i < joints; ++i)
+    {
+      const double previous = filtered_[i];
+      filtered_[i] += alpha * (torques[i] - filtered_[i]);
+      derivatives_[i] = (filtered_[i] - previous) / dt;
+    }
+  }
+
+  for (std::size_t i = 0; i < joints; ++i)
+  {
+    if (
+      std::abs(filtered_[i]) > torque_thresholds_[i] ||
+      (derivative_thresholds_[i] > 0 && std::abs(derivatives_[i]) > derivative_thresholds_[i]))
+    {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+}  // namespace kuka_controllers
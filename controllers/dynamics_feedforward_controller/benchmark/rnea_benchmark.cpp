@@ -0,0 +1,119 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the runtime of the inverse dynamics kernel on a 7 axis model with approximately the
+//  geometry and inertial parameters of an LBR iiwa 14 R820.
+// Usage: ros2 run dynamics_feedforward_controller rnea_benchmark [iterations]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "dynamics_feedforward_controller/rnea_kernel.hpp"
+
+using kuka_controllers::RigidBody;
+using kuka_controllers::RneaKernel;
+
+namespace
+{
+RneaKernel::Joint joint(
+  double x, double y, double z, double roll, double pitch, double yaw, double mass,
+  const Eigen::Vector3d & com, const Eigen::Vector3d & inertia)
+{
+  RneaKernel::Joint result;
+  result.rotation = (Eigen::AngleAxisd(yaw, Eigen::Vector3d::UnitZ()) *
+                     Eigen::AngleAxisd(pitch, Eigen::Vector3d::UnitY()) *
+                     Eigen::AngleAxisd(roll, Eigen::Vector3d::UnitX()))
+                      .toRotationMatrix();
+  result.translation << x, y, z;
+  result.body.mass = mass;
+  result.body.com = com;
+  result.body.inertia = inertia.asDiagonal();
+  return result;
+}
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  const long iterations = argc > 1 ? std::atol(argv[1]) : 1000000;  // NOLINT(runtime/int)
+  if (iterations <= 0)
+  {
+    fprintf(stderr, "Number of iterations must be positive\n");
+    return 1;
+  }
+
+  RneaKernel kernel;
+  kernel.addJoint(joint(0, 0, 0.1575, 0, 0, 0, 4.0, {0, -0.03, 0.12}, {0.1, 0.09, 0.02}));
+  kernel.addJoint(
+    joint(0, 0, 0.2025, M_PI_2, 0, M_PI, 4.0, {0.0003, 0.059, 0.042}, {0.05, 0.018, 0.044}));
+  kernel.addJoint(joint(0, 0.2045, 0, M_PI_2, 0, M_PI, 3.0, {0, 0.03, 0.13}, {0.08, 0.075, 0.01}));
+  kernel.addJoint(joint(0, 0, 0.2155, M_PI_2, 0, 0, 2.7, {0, 0.067, 0.034}, {0.03, 0.01, 0.029}));
+  kernel.addJoint(
+    joint(0, 0.1845, 0, -M_PI_2, M_PI, 0, 1.7, {0.0001, 0.021, 0.076}, {0.02, 0.018, 0.005}));
+  kernel.addJoint(
+    joint(0, 0, 0.2155, M_PI_2, 0, 0, 1.8, {0, 0.0006, 0.0004}, {0.005, 0.0036, 0.0047}));
+  kernel.addJoint(joint(0, 0.081, 0, -M_PI_2, M_PI, 0, 0.3, {0, 0, 0.02}, {0.001, 0.001, 0.001}));
+
+  RigidBody payload;
+  payload.mass = 2.0;
+  payload.com << 0, 0, 0.1;
+  payload.inertia = Eigen::Vector3d(0.01, 0.01, 0.005).asDiagonal();
+
+  // Random states are prepared in advance, so that only the kernel is measured
+  constexpr std::size_t STATE_COUNT = 1024;
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> distribution(-2.0, 2.0);
+  std::vector<RneaKernel::Vector> positions(STATE_COUNT, RneaKernel::Vector(7));
+  std::vector<RneaKernel::Vector> velocities(STATE_COUNT, RneaKernel::Vector(7));
+  for (std::size_t i = 0; i < STATE_COUNT; ++i)
+  {
+    positions[i] = RneaKernel::Vector::NullaryExpr(7, [&]() { return distribution(generator); });
+    velocities[i] = RneaKernel::Vector::NullaryExpr(7, [&]() { return distribution(generator); });
+  }
+  const RneaKernel::Vector zeros = RneaKernel::Vector::Zero(7);
+  RneaKernel::Vector torques(7);
+
+  using Clock = std::chrono::steady_clock;
+  std::vector<double> durations(static_cast<std::size_t>(iterations));
+  double checksum = 0;
+  for (long i = 0; i < iterations; ++i)  // NOLINT(runtime/int)
+  {
+    const auto state = static_cast<std::size_t>(i) % STATE_COUNT;
+    const auto start = Clock::now();
+    kernel.compute(positions[state], velocities[state], zeros, payload, torques);
+    const auto end = Clock::now();
+    durations[static_cast<std::size_t>(i)] =
+      std::chrono::duration<double, std::micro>(end - start).count();
+    checksum += torques[0];
+  }
+
+  std::sort(durations.begin(), durations.end());
+  double sum = 0;
+  for (const double duration : durations)
+  {
+    sum += duration;
+  }
+  const auto percentile = [&durations](double p)
+  { return durations[static_cast<std::size_t>(p * static_cast<double>(durations.size() - 1))]; };
+  printf(
+    "Inverse dynamics of 7 joints, %ld iterations [us]: mean %.3f, median %.3f, 99%% %.3f, "
+    "99.9%% %.3f, max %.3f (checksum %g)\n",
+    iterations, sum / static_cast<double>(iterations), percentile(0.5), percentile(0.99),
+    percentile(0.999), durations.back(), checksum);
+  return 0;
+}
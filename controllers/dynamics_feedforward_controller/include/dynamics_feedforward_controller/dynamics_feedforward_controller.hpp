@@ -0,0 +1,99 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DYNAMICS_FEEDFORWARD_CONTROLLER__DYNAMICS_FEEDFORWARD_CONTROLLER_HPP_
+#define DYNAMICS_FEEDFORWARD_CONTROLLER__DYNAMICS_FEEDFORWARD_CONTROLLER_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include "controller_interface/chainable_controller_interface.hpp"
+#include "geometry_msgs/msg/inertia_stamped.hpp"
+#include "pluginlib/class_list_macros.hpp"
+#include "rclcpp/duration.hpp"
+#include "rclcpp/time.hpp"
+#include "realtime_tools/realtime_buffer.h"
+
+#include "dynamics_feedforward_controller/rnea_kernel.hpp"
+#include "dynamics_feedforward_controller/visibility_control.h"
+#include "dynamics_feedforward_controller_parameters.hpp"
+
+namespace kuka_controllers
+{
+/**
+ * @brief Chainable controller adding the gravity and Coriolis torques of the robot and the payload
+ *  to the effort references of an upstream controller
+ *
+ * The dynamic model is built from the robot description, the joint velocities are differentiated
+ *  from the positions.
+ */
+class DynamicsFeedforwardController : public controller_interface::ChainableControllerInterface
+{
+public:
+  DYNAMICS_FEEDFORWARD_CONTROLLER_PUBLIC controller_interface::InterfaceConfiguration
+  command_interface_configuration() const override;
+
+  DYNAMICS_FEEDFORWARD_CONTROLLER_PUBLIC controller_interface::InterfaceConfiguration
+  state_interface_configuration() const override;
+
+  DYNAMICS_FEEDFORWARD_CONTROLLER_PUBLIC controller_interface::return_type
+  update_and_write_commands(const rclcpp::Time & time, const rclcpp::Duration & period) override;
+
+  DYNAMICS_FEEDFORWARD_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_configure(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  DYNAMICS_FEEDFORWARD_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_activate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  DYNAMICS_FEEDFORWARD_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_deactivate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  DYNAMICS_FEEDFORWARD_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_init() override;
+
+protected:
+  std::vector<hardware_interface::CommandInterface> on_export_reference_interfaces() override;
+
+  controller_interface::return_type update_reference_from_subscribers(
+    const rclcpp::Time & time, const rclcpp::Duration & period) override;
+
+private:
+  DYNAMICS_FEEDFORWARD_CONTROLLER_LOCAL void onPayload(
+    const geometry_msgs::msg::InertiaStamped::SharedPtr msg);
+  DYNAMICS_FEEDFORWARD_CONTROLLER_LOCAL void setPayload(
+    double mass, const Eigen::Vector3d & com, const Eigen::Matrix3d & inertia);
+
+  using Params = dynamics_feedforward_controller::Params;
+  using ParamListener = dynamics_feedforward_controller::ParamListener;
+
+  std::shared_ptr<ParamListener> param_listener_;
+  Params params_;
+
+  RneaKernel kernel_;
+  Eigen::Isometry3d tip_transform_ = Eigen::Isometry3d::Identity();
+
+  rclcpp::Subscription<geometry_msgs::msg::InertiaStamped>::SharedPtr payload_subscriber_;
+  // Payload expressed in the frame of the last joint
+  realtime_tools::RealtimeBuffer<RigidBody> payload_buffer_;
+
+  RneaKernel::Vector positions_;
+  RneaKernel::Vector previous_positions_;
+  RneaKernel::Vector velocities_;
+  RneaKernel::Vector zeros_;
+  RneaKernel::Vector torques_;
+};
+}  // namespace kuka_controllers
+#endif  // DYNAMICS_FEEDFORWARD_CONTROLLER__DYNAMICS_FEEDFORWARD_CONTROLLER_HPP_
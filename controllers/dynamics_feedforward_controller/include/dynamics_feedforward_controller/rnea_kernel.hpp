@@ -0,0 +1,117 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DYNAMICS_FEEDFORWARD_CONTROLLER__RNEA_KERNEL_HPP_
+#define DYNAMICS_FEEDFORWARD_CONTROLLER__RNEA_KERNEL_HPP_
+
+#include <array>
+#include <cstddef>
+
+#include <Eigen/Geometry>
+
+namespace kuka_controllers
+{
+/**
+ * @brief Inertial parameters of a rigid body
+ */
+struct RigidBody
+{
+  double mass = 0;
+  // Center of mass in the frame of the body
+  Eigen::Vector3d com = Eigen::Vector3d::Zero();
+  // Inertia tensor around the center of mass, with the axes of the frame of the body
+  Eigen::Matrix3d inertia = Eigen::Matrix3d::Zero();
+
+  /**
+   * @brief Merges an other body expressed in the same frame into this one
+   */
+  void add(const RigidBody & other);
+
+  /**
+   * @brief Returns the body expressed in the parent frame of the given transform
+   */
+  RigidBody transformed(const Eigen::Isometry3d & transform) const;
+};
+
+/**
+ * @brief Inverse dynamics of serial robots with revolute joints, calculated with the recursive
+ *  Newton-Euler algorithm
+ *
+ * The chain is set up once, after that compute() uses fixed-size storage only, so it does not
+ *  allocate memory and its runtime depends only on the number of joints.
+ */
+class RneaKernel
+{
+public:
+  static constexpr std::size_t MAX_JOINTS = 7;
+  using Vector = Eigen::Matrix<double, Eigen::Dynamic, 1, Eigen::ColMajor, MAX_JOINTS, 1>;
+
+  struct Joint
+  {
+    // Pose of the joint frame at zero joint position in the frame of the previous joint
+    Eigen::Matrix3d rotation = Eigen::Matrix3d::Identity();
+    Eigen::Vector3d translation = Eigen::Vector3d::Zero();
+    // Unit rotation axis in the joint frame
+    Eigen::Vector3d axis = Eigen::Vector3d::UnitZ();
+    // All links moving rigidly with the joint, expressed in the joint frame
+    RigidBody body;
+  };
+
+  /**
+   * @brief Appends a joint to the end of the chain
+   *
+   * @return bool: False if the chain already has MAX_JOINTS joints
+   */
+  bool addJoint(const Joint & joint);
+
+  void clear() { size_ = 0; }
+  std::size_t size() const { return size_; }
+
+  /**
+   * @brief Sets the gravity vector in the base frame, the default is -9.81 m/s^2 along z
+   */
+  void setGravity(const Eigen::Vector3d & gravity) { gravity_ = gravity; }
+
+  /**
+   * @brief Selects whether the weight of the links is included in the result
+   *
+   * The weight of the payload is always included, this allows compensating only the payload if
+   *  the robot controller already compensates the gravity of the robot itself.
+   */
+  void setLinkGravity(bool enabled) { link_gravity_ = enabled; }
+
+  /**
+   * @brief Calculates the joint torques needed for the given motion
+   *
+   * With zero accelerations the result contains the gravity, Coriolis and centrifugal torques.
+   *
+   * @param positions: Joint positions [rad]
+   * @param velocities: Joint velocities [rad/s]
+   * @param accelerations: Joint accelerations [rad/s^2]
+   * @param payload: Payload attached to the last joint, expressed in its frame
+   * @param torques: The resulting joint torques [Nm]
+   */
+  void compute(
+    const Vector & positions, const Vector & velocities, const Vector & accelerations,
+    const RigidBody & payload, Vector & torques) const;
+
+private:
+  std::array<Joint, MAX_JOINTS> joints_;
+  std::size_t size_ = 0;
+  Eigen::Vector3d gravity_ = Eigen::Vector3d(0, 0, -9.81);
+  bool link_gravity_ = true;
+};
+}  // namespace kuka_controllers
+
+#endif  // DYNAMICS_FEEDFORWARD_CONTROLLER__RNEA_KERNEL_HPP_
@@ -0,0 +1,48 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DYNAMICS_FEEDFORWARD_CONTROLLER__URDF_CHAIN_HPP_
+#define DYNAMICS_FEEDFORWARD_CONTROLLER__URDF_CHAIN_HPP_
+
+#include <string>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include "dynamics_feedforward_controller/rnea_kernel.hpp"
+
+namespace kuka_controllers
+{
+/**
+ * @brief Sets up the kernel with the chain between two links of a robot description
+ *
+ * Links attached with fixed joints are merged into the body of the previous moving joint, this
+ *  includes the tool, if it is part of the description.
+ *
+ * @param robot_description: URDF of the robot
+ * @param base_link: First link of the chain, gravity is expressed in its frame
+ * @param tip_link: Last link of the chain, the payload is expressed in its frame
+ * @param joints: Expected names of the moving joints in the chain, in order
+ * @param kernel: The kernel to set up
+ * @param tip_transform: Pose of the tip link in the frame of the last joint
+ * @param error: Description of the problem, if the chain could not be set up
+ * @return bool: False if the description is invalid or the chain does not match the joints
+ */
+bool loadUrdfChain(
+  const std::string & robot_description, const std::string & base_link,
+  const std::string & tip_link, const std::vector<std::string> & joints, RneaKernel & kernel,
+  Eigen::Isometry3d & tip_transform, std::string & error);
+}  // namespace kuka_controllers
+
+#endif  // DYNAMICS_FEEDFORWARD_CONTROLLER__URDF_CHAIN_HPP_
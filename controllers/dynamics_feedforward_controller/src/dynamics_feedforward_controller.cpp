@@ -0,0 +1,219 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+
+#include "dynamics_feedforward_controller/dynamics_feedforward_controller.hpp"
+#include "dynamics_feedforward_controller/urdf_chain.hpp"
+
+namespace kuka_controllers
+{
+controller_interface::CallbackReturn DynamicsFeedforwardController::on_init()
+{
+  try
+  {
+    param_listener_ = std::make_shared<ParamListener>(get_node());
+    params_ = param_listener_->get_params();
+  }
+  catch (const std::exception & e)
+  {
+    fprintf(stderr, "Exception thrown during init stage with message: %s \n", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::InterfaceConfiguration
+DynamicsFeedforwardController::command_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_EFFORT);
+  }
+  return config;
+}
+
+controller_interface::InterfaceConfiguration
+DynamicsFeedforwardController::state_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_POSITION);
+  }
+  return config;
+}
+
+controller_interface::CallbackReturn DynamicsFeedforwardController::on_configure(
+  const rclcpp_lifecycle::State &)
+{
+  params_ = param_listener_->get_params();
+  if (params_.joints.empty())
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "'joints' parameter is empty");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+
+  std::string error;
+  if (!loadUrdfChain(
+        get_robot_description(), params_.base_link, params_.tip_link, params_.joints, kernel_,
+        tip_transform_, error))
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "Failed to set up the dynamic model: %s", error.c_str());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  kernel_.setGravity(Eigen::Map<const Eigen::Vector3d>(params_.gravity.data()));
+  kernel_.setLinkGravity(params_.link_gravity);
+
+  const auto & inertia = params_.payload.inertia;
+  Eigen::Matrix3d payload_inertia;
+  payload_inertia << inertia[0], inertia[1], inertia[2], inertia[1], inertia[3], inertia[4],
+    inertia[2], inertia[4], inertia[5];
+  setPayload(
+    params_.payload.mass, Eigen::Map<const Eigen::Vector3d>(params_.payload.center_of_mass.data()),
+    payload_inertia);
+
+  const auto joints = static_cast<Eigen::Index>(params_.joints.size());
+  positions_.setZero(joints);
+  previous_positions_.setZero(joints);
+  velocities_.setZero(joints);
+  zeros_.setZero(joints);
+  torques_.setZero(joints);
+  reference_interfaces_.assign(params_.joints.size(), 0.0);
+
+  payload_subscriber_ = get_node()->create_subscription<geometry_msgs::msg::InertiaStamped>(
+    "~/payload", rclcpp::SystemDefaultsQoS(),
+    [this](const geometry_msgs::msg::InertiaStamped::SharedPtr msg) { onPayload(msg); });
+
+  RCLCPP_INFO(
+    get_node()->get_logger(), "Dynamic model set up for the chain from '%s' to '%s'",
+    params_.base_link.c_str(), params_.tip_link.c_str());
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn DynamicsFeedforwardController::on_activate(
+  const rclcpp_lifecycle::State &)
+{
+  for (Eigen::Index i = 0; i < positions_.size(); ++i)
+  {
+    positions_[i] = state_interfaces_[static_cast<std::size_t>(i)].get_value();
+  }
+  previous_positions_ = positions_;
+  velocities_.setZero();
+
+  // Without an upstream controller only the feed-forward torques are commanded
+  std::fill(reference_interfaces_.begin(), reference_interfaces_.end(), 0.0);
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn DynamicsFeedforwardController::on_deactivate(
+  const rclcpp_lifecycle::State &)
+{
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+std::vector<hardware_interface::CommandInterface>
+DynamicsFeedforwardController::on_export_reference_interfaces()
+{
+  std::vector<hardware_interface::CommandInterface> reference_interfaces;
+  for (std::size_t i = 0; i < params_.joints.size(); ++i)
+  {
+    reference_interfaces.emplace_back(
+      get_node()->get_name(), params_.joints[i] + "/" + hardware_interface::HW_IF_EFFORT,
+      &reference_interfaces_[i]);
+  }
+  return reference_interfaces;
+}
+
+controller_interface::return_type DynamicsFeedforwardController::update_reference_from_subscribers(
+  const rclcpp::Time &, const rclcpp::Duration &)
+{
+  // Without an upstream controller the last references are held
+  return controller_interface::return_type::OK;
+}
+
+controller_interface::return_type DynamicsFeedforwardController::update_and_write_commands(
+  const rclcpp::Time &, const rclcpp::Duration & period)
+{
+  for (Eigen::Index i = 0; i < positions_.size(); ++i)
+  {
+    positions_[i] = state_interfaces_[static_cast<std::size_t>(i)].get_value();
+  }
+
+  // Differentiated velocities are filtered with a first order low-pass filter
+  const double dt = period.seconds();
+  if (dt > 0)
+  {
+    const double time_constant = 1.0 / (2 * M_PI * params_.velocity_filter_cutoff);
+    const double alpha = dt / (dt + time_constant);
+    velocities_ += alpha * ((positions_ - previous_positions_) / dt - velocities_);
+  }
+  previous_positions_ = positions_;
+
+  kernel_.compute(
+    positions_, params_.coriolis ? velocities_ : zeros_, zeros_, *payload_buffer_.readFromRT(),
+    torques_);
+
+  for (std::size_t i = 0; i < reference_interfaces_.size(); ++i)
+  {
+    const double reference = reference_interfaces_[i];
+    command_interfaces_[i].set_value(
+      (std::isnan(reference) ? 0.0 : reference) + torques_[static_cast<Eigen::Index>(i)]);
+  }
+  return controller_interface::return_type::OK;
+}
+
+void DynamicsFeedforwardController::onPayload(
+  const geometry_msgs::msg::InertiaStamped::SharedPtr msg)
+{
+  if (!msg->header.frame_id.empty() && msg->header.frame_id != params_.tip_link)
+  {
+    RCLCPP_ERROR(
+      get_node()->get_logger(), "Payload must be expressed in the '%s' frame, got '%s'",
+      params_.tip_link.c_str(), msg->header.frame_id.c_str());
+    return;
+  }
+  const auto & payload = msg->inertia;
+  if (!std::isfinite(payload.m) || payload.m < 0)
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "Invalid payload mass: %f", payload.m);
+    return;
+  }
+
+  Eigen::Matrix3d inertia;
+  inertia << payload.ixx, payload.ixy, payload.ixz, payload.ixy, payload.iyy, payload.iyz,
+    payload.ixz, payload.iyz, payload.izz;
+  setPayload(payload.m, Eigen::Vector3d(payload.com.x, payload.com.y, payload.com.z), inertia);
+}
+
+void DynamicsFeedforwardController::setPayload(
+  double mass, const Eigen::Vector3d & com, const Eigen::Matrix3d & inertia)
+{
+  RigidBody payload;
+  payload.mass = mass;
+  payload.com = com;
+  payload.inertia = inertia;
+  payload_buffer_.writeFromNonRT(payload.transformed(tip_transform_));
+}
+}  // namespace kuka_controllers
+
+PLUGINLIB_EXPORT_CLASS(
+  kuka_controllers::DynamicsFeedforwardController,
+  controller_interface::ChainableControllerInterface)
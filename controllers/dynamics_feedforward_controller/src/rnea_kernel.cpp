@@ -0,0 +1,141 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dynamics_feedforward_controller/rnea_kernel.hpp"
+
+namespace kuka_controllers
+{
+namespace
+{
+// Inertia of a point mass at the given offset, used for the parallel axis theorem
+Eigen::Matrix3d pointInertia(double mass, const Eigen::Vector3d & offset)
+{
+  return mass * (offset.squaredNorm() * Eigen::Matrix3d::Identity() - offset * offset.transpose());
+}
+
+// Force and moment around the frame origin needed to accelerate the body
+void bodyWrench(
+  const RigidBody & body, const Eigen::Vector3d & angular_velocity,
+  const Eigen::Vector3d & angular_acceleration, const Eigen::Vector3d & linear_acceleration,
+  Eigen::Vector3d & force, Eigen::Vector3d & moment)
+{
+  const Eigen::Vector3d com_acceleration =
+    linear_acceleration + angular_acceleration.cross(body.com) +
+    angular_velocity.cross(angular_velocity.cross(body.com));
+  force = body.mass * com_acceleration;
+  moment = body.inertia * angular_acceleration +
+           angular_velocity.cross(body.inertia * angular_velocity) + body.com.cross(force);
+}
+}  // namespace
+
+void RigidBody::add(const RigidBody & other)
+{
+  const double total_mass = mass + other.mass;
+  if (total_mass <= 0)
+  {
+    inertia += other.inertia;
+    return;
+  }
+  const Eigen::Vector3d total_com = (mass * com + other.mass * other.com) / total_mass;
+  inertia += pointInertia(mass, com - total_com) + other.inertia +
+             pointInertia(other.mass, other.com - total_com);
+  mass = total_mass;
+  com = total_com;
+}
+
+RigidBody RigidBody::transformed(const Eigen::Isometry3d & transform) const
+{
+  RigidBody result;
+  result.mass = mass;
+  result.com = transform * com;
+  result.inertia = transform.linear() * inertia * transform.linear().transpose();
+  return result;
+}
+
+bool RneaKernel::addJoint(const Joint & joint)
+{
+  if (size_ == MAX_JOINTS)
+  {
+    return false;
+  }
+  joints_[size_] = joint;
+  joints_[size_].axis.normalize();
+  ++size_;
+  return true;
+}
+
+void RneaKernel::compute(
+  const Vector & positions, const Vector & velocities, const Vector & accelerations,
+  const RigidBody & payload, Vector & torques) const
+{
+  std::array<Eigen::Matrix3d, MAX_JOINTS> rotations;
+  std::array<Eigen::Vector3d, MAX_JOINTS> forces;
+  std::array<Eigen::Vector3d, MAX_JOINTS> moments;
+
+  // Outward recursion: velocities and accelerations of the joint frames, expressed in their own
+  //  frame. Gravity is included as an upward acceleration of the base.
+  Eigen::Vector3d angular_velocity = Eigen::Vector3d::Zero();
+  Eigen::Vector3d angular_acceleration = Eigen::Vector3d::Zero();
+  Eigen::Vector3d linear_acceleration = -gravity_;
+  Eigen::Vector3d gravity = gravity_;
+  for (std::size_t i = 0; i < size_; ++i)
+  {
+    const Joint & joint = joints_[i];
+    const auto index = static_cast<Eigen::Index>(i);
+    rotations[i] =
+      joint.rotation * Eigen::AngleAxisd(positions[index], joint.axis).toRotationMatrix();
+    const Eigen::Matrix3d inverse = rotations[i].transpose();
+
+    linear_acceleration =
+      inverse * (linear_acceleration + angular_acceleration.cross(joint.translation) +
+                 angular_velocity.cross(angular_velocity.cross(joint.translation)));
+    gravity = inverse * gravity;
+
+    const Eigen::Vector3d inherited_velocity = inverse * angular_velocity;
+    const Eigen::Vector3d joint_velocity = joint.axis * velocities[index];
+    angular_velocity = inherited_velocity + joint_velocity;
+    angular_acceleration = inverse * angular_acceleration + joint.axis * accelerations[index] +
+                           inherited_velocity.cross(joint_velocity);
+
+    bodyWrench(
+      joint.body, angular_velocity, angular_acceleration,
+      link_gravity_ ? linear_acceleration : Eigen::Vector3d(linear_acceleration + gravity),
+      forces[i], moments[i]);
+    if (i + 1 == size_)
+    {
+      Eigen::Vector3d force, moment;
+      bodyWrench(
+        payload, angular_velocity, angular_acceleration, linear_acceleration, force, moment);
+      forces[i] += force;
+      moments[i] += moment;
+    }
+  }
+
+  // Inward recursion: wrenches transmitted by the joints
+  Eigen::Vector3d force = Eigen::Vector3d::Zero();
+  Eigen::Vector3d moment = Eigen::Vector3d::Zero();
+  for (std::size_t i = size_; i-- > 0;)
+  {
+    if (i + 1 < size_)
+    {
+      const Eigen::Vector3d child_force = rotations[i + 1] * force;
+      moment = rotations[i + 1] * moment + joints_[i + 1].translation.cross(child_force);
+      force = child_force;
+    }
+    force += forces[i];
+    moment += moments[i];
+    torques[static_cast<Eigen::Index>(i)] = joints_[i].axis.dot(moment);
+  }
+}
+}  // namespace kuka_controllers
@@ -0,0 +1,135 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include "urdf/model.h"
+
+#include "dynamics_feedforward_controller/urdf_chain.hpp"
+
+namespace kuka_controllers
+{
+namespace
+{
+Eigen::Isometry3d toIsometry(const urdf::Pose & pose)
+{
+  double x, y, z, w;
+  pose.rotation.getQuaternion(x, y, z, w);
+  Eigen::Isometry3d transform = Eigen::Isometry3d::Identity();
+  transform.linear() = Eigen::Quaterniond(w, x, y, z).normalized().toRotationMatrix();
+  transform.translation() << pose.position.x, pose.position.y, pose.position.z;
+  return transform;
+}
+
+// Inertial parameters of the link and all links attached to it with fixed joints
+RigidBody rigidSubtree(const urdf::Model & model, const urdf::Link & link)
+{
+  RigidBody body;
+  if (link.inertial)
+  {
+    const auto & inertial = *link.inertial;
+    body.mass = inertial.mass;
+    body.inertia << inertial.ixx, inertial.ixy, inertial.ixz, inertial.ixy, inertial.iyy,
+      inertial.iyz, inertial.ixz, inertial.iyz, inertial.izz;
+    body = body.transformed(toIsometry(inertial.origin));
+  }
+  for (const auto & joint : link.child_joints)
+  {
+    const auto child = model.getLink(joint->child_link_name);
+    if (joint->type == urdf::Joint::FIXED && child)
+    {
+      body.add(rigidSubtree(model, *child).transformed(
+        toIsometry(joint->parent_to_joint_origin_transform)));
+    }
+  }
+  return body;
+}
+}  // namespace
+
+bool loadUrdfChain(
+  const std::string & robot_description, const std::string & base_link,
+  const std::string & tip_link, const std::vector<std::string> & joints, RneaKernel & kernel,
+  Eigen::Isometry3d & tip_transform, std::string & error)
+{
+  urdf::Model model;
+  if (!model.initString(robot_description))
+  {
+    error = "Failed to parse the robot description";
+    return false;
+  }
+
+  // Collect the joints from the tip towards the base
+  std::vector<urdf::JointConstSharedPtr> chain;
+  auto link = model.getLink(tip_link);
+  if (!link)
+  {
+    error = "Link '" + tip_link + "' not found in the robot description";
+    return false;
+  }
+  while (link->name != base_link)
+  {
+    if (!link->parent_joint)
+    {
+      error = "Link '" + tip_link + "' is not a descendant of '" + base_link + "'";
+      return false;
+    }
+    chain.push_back(link->parent_joint);
+    link = model.getLink(link->parent_joint->parent_link_name);
+  }
+  std::reverse(chain.begin(), chain.end());
+
+  kernel.clear();
+  // Pose of the actual frame in the frame of the previous moving joint
+  Eigen::Isometry3d offset = Eigen::Isometry3d::Identity();
+  for (const auto & joint : chain)
+  {
+    offset = offset * toIsometry(joint->parent_to_joint_origin_transform);
+    if (joint->type == urdf::Joint::FIXED)
+    {
+      continue;
+    }
+    if (joint->type != urdf::Joint::REVOLUTE && joint->type != urdf::Joint::CONTINUOUS)
+    {
+      error = "Joint '" + joint->name + "' is not revolute";
+      return false;
+    }
+    if (kernel.size() >= joints.size() || joint->name != joints[kernel.size()])
+    {
+      error = "Joint '" + joint->name + "' of the chain does not match the 'joints' parameter";
+      return false;
+    }
+
+    RneaKernel::Joint kernel_joint;
+    kernel_joint.rotation = offset.linear();
+    kernel_joint.translation = offset.translation();
+    kernel_joint.axis << joint->axis.x, joint->axis.y, joint->axis.z;
+    kernel_joint.body = rigidSubtree(model, *model.getLink(joint->child_link_name));
+    if (!kernel.addJoint(kernel_joint))
+    {
+      error = "The chain has more than " + std::to_string(RneaKernel::MAX_JOINTS) + " joints";
+      return false;
+    }
+    offset = Eigen::Isometry3d::Identity();
+  }
+
+  if (kernel.size() != joints.size())
+  {
+    error = "The chain has " + std::to_string(kernel.size()) + " moving joints, expected " +
+            std::to_string(joints.size());
+    return false;
+  }
+  tip_transform = offset;
+  return true;
+}
+}  // namespace kuka_controllers
@@ -21,6 +21,8 @@
 
 #include "controller_interface/controller_interface.hpp"
 #include "kuka_driver_interfaces/msg/fri_configuration.hpp"
+#include "kuka_drivers_core/timing_diagnostics.hpp"
+#include "kuka_drivers_core/update_timer.hpp"
 #include "pluginlib/class_list_macros.hpp"
 #include "rclcpp/duration.hpp"
 #include "rclcpp/time.hpp"
@@ -53,6 +55,8 @@ public:
   FRI_CONFIGURATION_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_init() override;
 
 private:
+  kuka_drivers_core::UpdateTimer update_timer_;
+  std::unique_ptr<kuka_drivers_core::TimingDiagnostics> timing_diagnostics_;
   rclcpp::Subscription<kuka_driver_interfaces::msg::FriConfiguration>::SharedPtr fri_config_sub_;
   int receive_multiplier_ = 1;
   int send_period_ms_ = 10;
@@ -20,6 +20,7 @@ namespace kuka_controllers
 {
 controller_interface::CallbackReturn FRIConfigurationController::on_init()
 {
+  kuka_drivers_core::TimingDiagnostics::declareParameters(get_node(), true);
   auto callback = [this](const kuka_driver_interfaces::msg::FriConfiguration::SharedPtr msg)
   {
     receive_multiplier_ = msg->receive_multiplier;
@@ -52,6 +53,8 @@ FRIConfigurationController::state_interface_configuration() const
 controller_interface::CallbackReturn FRIConfigurationController::on_configure(
   const rclcpp_lifecycle::State &)
 {
+  timing_diagnostics_ =
+    std::make_unique<kuka_drivers_core::TimingDiagnostics>(get_node(), update_timer_);
   return controller_interface::CallbackReturn::SUCCESS;
 }
 
@@ -70,10 +73,16 @@ controller_interface::CallbackReturn FRIConfigurationController::on_deactivate(
 controller_interface::return_type FRIConfigurationController::update(
   const rclcpp::Time &, const rclcpp::Duration &)
 {
+  if (!update_timer_.start())
+  {
+    return controller_interface::return_type::OK;
+  }
+
   // TODO(Svastits): disable changes if HWIF is active
   command_interfaces_[0].set_value(receive_multiplier_);
   command_interfaces_[1].set_value(send_period_ms_);
 
+  update_timer_.stop();
   return controller_interface::return_type::OK;
 }
 
@@ -21,6 +21,8 @@
 
 #include "controller_interface/controller_interface.hpp"
 #include "kuka_driver_interfaces/msg/fri_state.hpp"
+#include "kuka_drivers_core/timing_diagnostics.hpp"
+#include "kuka_drivers_core/update_timer.hpp"
 #include "pluginlib/class_list_macros.hpp"
 #include "rclcpp/duration.hpp"
 #include "rclcpp/time.hpp"
@@ -53,6 +55,8 @@ public:
   FRI_STATE_BROADCASTER_PUBLIC controller_interface::CallbackReturn on_init() override;
 
 private:
+  kuka_drivers_core::UpdateTimer update_timer_;
+  std::unique_ptr<kuka_drivers_core::TimingDiagnostics> timing_diagnostics_;
   int counter_ = 0;
   rclcpp::Publisher<kuka_driver_interfaces::msg::FRIState>::SharedPtr robot_state_publisher_;
   kuka_driver_interfaces::msg::FRIState state_msg_;
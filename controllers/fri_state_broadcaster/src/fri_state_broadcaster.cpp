@@ -20,6 +20,7 @@ namespace kuka_controllers
 {
 controller_interface::CallbackReturn FRIStateBroadcaster::on_init()
 {
+  kuka_drivers_core::TimingDiagnostics::declareParameters(get_node(), false);
   robot_state_publisher_ = get_node()->create_publisher<kuka_driver_interfaces::msg::FRIState>(
     "~/fri_state", rclcpp::SystemDefaultsQoS());
   return controller_interface::CallbackReturn::SUCCESS;
@@ -63,6 +64,8 @@ controller_interface::InterfaceConfiguration FRIStateBroadcaster::state_interfac
 controller_interface::CallbackReturn FRIStateBroadcaster::on_configure(
   const rclcpp_lifecycle::State &)
 {
+  timing_diagnostics_ =
+    std::make_unique<kuka_drivers_core::TimingDiagnostics>(get_node(), update_timer_);
   return controller_interface::CallbackReturn::SUCCESS;
 }
 
@@ -81,6 +84,11 @@ controller_interface::CallbackReturn FRIStateBroadcaster::on_deactivate(
 controller_interface::return_type FRIStateBroadcaster::update(
   const rclcpp::Time &, const rclcpp::Duration &)
 {
+  if (!update_timer_.start())
+  {
+    return controller_interface::return_type::OK;
+  }
+
   state_msg_.session_state = static_cast<int>(state_interfaces_[0].get_value());
   state_msg_.connection_quality = static_cast<int>(state_interfaces_[1].get_value());
   state_msg_.safety_state = static_cast<int>(state_interfaces_[2].get_value());
@@ -97,6 +105,7 @@ controller_interface::return_type FRIStateBroadcaster::update(
     counter_ = 0;
   }
 
+  update_timer_.stop();
   return controller_interface::return_type::OK;
 }
 
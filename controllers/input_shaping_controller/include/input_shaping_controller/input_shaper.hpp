@@ -0,0 +1,124 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INPUT_SHAPING_CONTROLLER__INPUT_SHAPER_HPP_
+#define INPUT_SHAPING_CONTROLLER__INPUT_SHAPER_HPP_
+
+#include <cstddef>
+#include <string>
+
+#include <Eigen/Core>
+
+namespace kuka_controllers
+{
+/**
+ * @brief Suppresses the excitation of a structural mode of every axis by filtering the setpoints
+ *
+ * Every axis has one of the following filters, tuned to the frequency and damping ratio of its
+ *  dominant mode:
+ *  - ZV shaper: two impulses half a damped period apart, cancels the vibration of the mode
+ *  - ZVD shaper: three impulses spanning a damped period, also robust to errors of the frequency
+ *  - notch filter: second order filter attenuating the mode, without the delay of the shapers
+ *
+ * The impulses of the shapers are delayed by fractions of the sample period, so the delays are
+ *  realized by linear interpolation between the samples of a ring buffer. The buffer and the
+ *  filter states have fixed sizes, and every step is computed on all axes at once with Eigen
+ *  arrays (the samples are contiguous across the axes). Axes without a shaper pass their input
+ *  through an impulse of zero delay, axes without a notch through a unit biquad, so all axes are
+ *  processed without branches. The setpoints of a shaper reach their target after the delay of
+ *  the last impulse.
+ */
+class InputShaper
+{
+public:
+  static constexpr std::size_t MAX_AXES = 7;
+  // Number of samples in the ring buffer, a power of two
+  static constexpr std::size_t BUFFER_SIZE = 1024;
+  // Two interpolated samples for the delayed impulses of a ZVD shaper, the first is not delayed
+  static constexpr std::size_t MAX_TAPS = 5;
+
+  using Vector = Eigen::Array<double, Eigen::Dynamic, 1, Eigen::ColMajor, MAX_AXES, 1>;
+
+  enum class Type
+  {
+    NONE,
+    ZV,
+    ZVD,
+    NOTCH
+  };
+
+  // Parses the name of a filter type ("none", "zv", "zvd" or "notch")
+  static bool parseType(const std::string & name, Type & type);
+
+  /**
+   * @brief Sets the number of axes, all of them pass their input through unfiltered
+   *
+   * @return bool: False if there are more than MAX_AXES axes
+   */
+  bool resize(std::size_t axes);
+
+  /**
+   * @brief Sets the filter of an axis
+   *
+   * @param frequency: Undamped natural frequency of the mode [Hz]
+   * @param damping_ratio: Damping ratio of the mode, in [0, 1)
+   * @param notch_damping: Damping ratio of the poles of a notch filter, a larger value widens the
+   *  notch
+   * @param period: Sample period of the setpoints [s]
+   * @param error: Reason of the failure
+   * @return bool: False if the delays do not fit in the buffer or the frequency is not below the
+   *  Nyquist frequency
+   */
+  bool setFilter(
+    std::size_t axis, Type type, double frequency, double damping_ratio, double notch_damping,
+    double period, std::string & error);
+
+  // Fills the history of the filters with the given setpoints, as if these were held forever
+  void reset(const Vector & input);
+
+  // Filters the next setpoints of the axes, does not allocate memory
+  void filter(const Vector & input, Vector & output);
+
+  // Time after which a step of the input is fully passed to the output [s]
+  double delay(std::size_t axis) const { return delays_[axis]; }
+
+  std::size_t size() const { return static_cast<std::size_t>(b0_.size()); }
+
+private:
+  using TapOffsets = Eigen::Array<int, MAX_AXES, MAX_TAPS>;
+  using TapWeights = Eigen::Array<double, MAX_AXES, MAX_TAPS>;
+
+  // Samples of the inputs, one column per cycle
+  Eigen::Array<double, MAX_AXES, BUFFER_SIZE> buffer_;
+  std::size_t head_ = 0;
+
+  // Delayed impulses of the shapers as samples and interpolation weights
+  TapOffsets offsets_;
+  TapWeights weights_;
+  double delays_[MAX_AXES] = {};
+
+  // Biquads of the notch filters in transposed direct form II, normalized with a0
+  Vector b0_;
+  Vector b1_;
+  Vector b2_;
+  Vector a1_;
+  Vector a2_;
+  Vector state1_;
+  Vector state2_;
+
+  Vector shaped_;
+  Vector delayed_;
+};
+}  // namespace kuka_controllers
+#endif  // INPUT_SHAPING_CONTROLLER__INPUT_SHAPER_HPP_
@@ -0,0 +1,80 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef INPUT_SHAPING_CONTROLLER__INPUT_SHAPING_CONTROLLER_HPP_
+#define INPUT_SHAPING_CONTROLLER__INPUT_SHAPING_CONTROLLER_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "controller_interface/chainable_controller_interface.hpp"
+#include "pluginlib/class_list_macros.hpp"
+#include "rclcpp/duration.hpp"
+#include "rclcpp/time.hpp"
+
+#include "input_shaping_controller/input_shaper.hpp"
+#include "input_shaping_controller/visibility_control.h"
+#include "input_shaping_controller_parameters.hpp"
+
+namespace kuka_controllers
+{
+/**
+ * @brief Chainable controller filtering the position references of an upstream controller to
+ *  suppress the excitation of the structural modes of the robot
+ *
+ * The filters are tuned to the nominal period of the controller manager (see InputShaper).
+ */
+class InputShapingController : public controller_interface::ChainableControllerInterface
+{
+public:
+  INPUT_SHAPING_CONTROLLER_PUBLIC controller_interface::InterfaceConfiguration
+  command_interface_configuration() const override;
+
+  INPUT_SHAPING_CONTROLLER_PUBLIC controller_interface::InterfaceConfiguration
+  state_interface_configuration() const override;
+
+  INPUT_SHAPING_CONTROLLER_PUBLIC controller_interface::return_type update_and_write_commands(
+    const rclcpp::Time & time, const rclcpp::Duration & period) override;
+
+  INPUT_SHAPING_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_configure(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  INPUT_SHAPING_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_activate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  INPUT_SHAPING_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_deactivate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  INPUT_SHAPING_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_init() override;
+
+protected:
+  std::vector<hardware_interface::CommandInterface> on_export_reference_interfaces() override;
+
+  controller_interface::return_type update_reference_from_subscribers(
+    const rclcpp::Time & time, const rclcpp::Duration & period) override;
+
+private:
+  using Params = input_shaping_controller::Params;
+  using ParamListener = input_shaping_controller::ParamListener;
+
+  std::shared_ptr<ParamListener> param_listener_;
+  Params params_;
+
+  InputShaper shaper_;
+  InputShaper::Vector input_;
+  InputShaper::Vector output_;
+};
+}  // namespace kuka_controllers
+#endif  // INPUT_SHAPING_CONTROLLER__INPUT_SHAPING_CONTROLLER_HPP_
@@ -0,0 +1,210 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include "input_shaping_controller/input_shaper.hpp"
+
+namespace kuka_controllers
+{
+namespace
+{
+constexpr std::size_t BUFFER_MASK = InputShaper::BUFFER_SIZE - 1;
+static_assert(
+  (InputShaper::BUFFER_SIZE & BUFFER_MASK) == 0, "The size of the buffer must be a power of two");
+}  // namespace
+
+bool InputShaper::parseType(const std::string & name, Type & type)
+{
+  if (name == "none")
+  {
+    type = Type::NONE;
+  }
+  else if (name == "zv")
+  {
+    type = Type::ZV;
+  }
+  else if (name == "zvd")
+  {
+    type = Type::ZVD;
+  }
+  else if (name == "notch")
+  {
+    type = Type::NOTCH;
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+}
+
+bool InputShaper::resize(std::size_t axes)
+{
+  if (axes > MAX_AXES)
+  {
+    return false;
+  }
+  const auto size = static_cast<Eigen::Index>(axes);
+  buffer_.setZero();
+  head_ = 0;
+  offsets_.setZero();
+  weights_.setZero();
+  weights_.col(0).setOnes();
+  std::fill(std::begin(delays_), std::end(delays_), 0.0);
+
+  b0_.setOnes(size);
+  b1_.setZero(size);
+  b2_.setZero(size);
+  a1_.setZero(size);
+  a2_.setZero(size);
+  state1_.setZero(size);
+  state2_.setZero(size);
+  shaped_.setZero(size);
+  delayed_.setZero(size);
+  return true;
+}
+
+bool InputShaper::setFilter(
+  std::size_t axis, Type type, double frequency, double damping_ratio, double notch_damping,
+  double period, std::string & error)
+{
+  const auto row = static_cast<Eigen::Index>(axis);
+  if (axis >= size())
+  {
+    error = "invalid axis";
+    return false;
+  }
+  if (!(period > 0))
+  {
+    error = "the period must be positive";
+    return false;
+  }
+
+  // Pass through until the new filter is set up
+  offsets_.row(row).setZero();
+  weights_.row(row).setZero();
+  weights_(row, 0) = 1;
+  delays_[axis] = 0;
+  b0_[row] = 1;
+  b1_[row] = b2_[row] = a1_[row] = a2_[row] = 0;
+  if (type == Type::NONE)
+  {
+    return true;
+  }
+
+  if (!(frequency > 0) || !(damping_ratio >= 0 && damping_ratio < 1))
+  {
+    error = "the frequency must be positive and the damping ratio in [0, 1)";
+    return false;
+  }
+  const double omega = 2 * M_PI * frequency;
+
+  if (type == Type::NOTCH)
+  {
+    if (frequency >= 0.5 / period)
+    {
+      error = "the frequency of the notch must be below the Nyquist frequency";
+      return false;
+    }
+    if (!(notch_damping > damping_ratio))
+    {
+      error = "the damping of the notch must be larger than the damping ratio of the mode";
+      return false;
+    }
+    // Bilinear transform of (s^2 + 2*zeta*w*s + w^2) / (s^2 + 2*notch_damping*w*s + w^2),
+    //  prewarped to keep the frequency of the notch
+    const double k = omega / std::tan(omega * period / 2);
+    const double a0 = k * k + 2 * notch_damping * omega * k + omega * omega;
+    b0_[row] = (k * k + 2 * damping_ratio * omega * k + omega * omega) / a0;
+    b1_[row] = 2 * (omega * omega - k * k) / a0;
+    b2_[row] = (k * k - 2 * damping_ratio * omega * k + omega * omega) / a0;
+    a1_[row] = b1_[row];
+    a2_[row] = (k * k - 2 * notch_damping * omega * k + omega * omega) / a0;
+    return true;
+  }
+
+  // Impulses of the shaper at multiples of half the damped period of the mode
+  const double root = std::sqrt(1 - damping_ratio * damping_ratio);
+  const double half_period = M_PI / (omega * root);
+  // Ratio of the amplitudes of consecutive half periods of the vibration
+  const double decay = std::exp(-damping_ratio * M_PI / root);
+  const int impulses = type == Type::ZV ? 2 : 3;
+  const double zv_sum = 1 + decay;
+  const double zvd_sum = zv_sum * zv_sum;
+  const double amplitudes[3] = {
+    type == Type::ZV ? 1 / zv_sum : 1 / zvd_sum,
+    type == Type::ZV ? decay / zv_sum : 2 * decay / zvd_sum,
+    type == Type::ZV ? 0 : decay * decay / zvd_sum};
+
+  const double last_delay = (impulses - 1) * half_period / period;
+  if (last_delay + 1 >= BUFFER_SIZE)
+  {
+    error = "the delay of the shaper does not fit in the buffer, the frequency is too low";
+    return false;
+  }
+
+  weights_(row, 0) = amplitudes[0];
+  for (int i = 1; i < impulses; ++i)
+  {
+    // The delayed impulse is interpolated between the samples before and after it
+    const double delay = i * half_period / period;
+    const int sample = static_cast<int>(delay);
+    const double fraction = delay - sample;
+    offsets_(row, 2 * i - 1) = sample;
+    weights_(row, 2 * i - 1) = amplitudes[i] * (1 - fraction);
+    offsets_(row, 2 * i) = sample + 1;
+    weights_(row, 2 * i) = amplitudes[i] * fraction;
+  }
+  delays_[axis] = (impulses - 1) * half_period;
+  return true;
+}
+
+void InputShaper::reset(const Vector & input)
+{
+  const auto axes = input.size();
+  for (Eigen::Index i = 0; i < buffer_.cols(); ++i)
+  {
+    buffer_.col(i).head(axes) = input;
+  }
+  // Steady state of the biquads, the static gain is one
+  state2_ = (b2_ - a2_) * input;
+  state1_ = (b1_ - a1_) * input + state2_;
+}
+
+void InputShaper::filter(const Vector & input, Vector & output)
+{
+  const auto axes = input.size();
+  head_ = (head_ + 1) & BUFFER_MASK;
+  buffer_.col(static_cast<Eigen::Index>(head_)).head(axes) = input;
+
+  shaped_ = weights_.col(0).head(axes) * input;
+  for (Eigen::Index tap = 1; tap < static_cast<Eigen::Index>(MAX_TAPS); ++tap)
+  {
+    // The delays differ between the axes, so only the gather is done per axis
+    for (Eigen::Index axis = 0; axis < axes; ++axis)
+    {
+      const std::size_t column = (head_ + BUFFER_SIZE - offsets_(axis, tap)) & BUFFER_MASK;
+      delayed_[axis] = buffer_(axis, static_cast<Eigen::Index>(column));
+    }
+    shaped_ += weights_.col(tap).head(axes) * delayed_;
+  }
+
+  output = b0_ * shaped_ + state1_;
+  state1_ = b1_ * shaped_ - a1_ * output + state2_;
+  state2_ = b2_ * shaped_ - a2_ * output;
+}
+}  // namespace kuka_controllers
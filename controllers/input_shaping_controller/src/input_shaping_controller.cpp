@@ -0,0 +1,183 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+
+#include "input_shaping_controller/input_shaping_controller.hpp"
+
+namespace kuka_controllers
+{
+controller_interface::CallbackReturn InputShapingController::on_init()
+{
+  try
+  {
+    param_listener_ = std::make_shared<ParamListener>(get_node());
+    params_ = param_listener_->get_params();
+  }
+  catch (const std::exception & e)
+  {
+    fprintf(stderr, "Exception thrown during init stage with message: %s \n", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::InterfaceConfiguration
+InputShapingController::command_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_POSITION);
+  }
+  return config;
+}
+
+controller_interface::InterfaceConfiguration
+InputShapingController::state_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_POSITION);
+  }
+  return config;
+}
+
+controller_interface::CallbackReturn InputShapingController::on_configure(
+  const rclcpp_lifecycle::State &)
+{
+  params_ = param_listener_->get_params();
+  const std::size_t joints = params_.joints.size();
+  if (joints == 0)
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "'joints' parameter is empty");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  if (
+    params_.filters.size() != joints || params_.frequencies.size() != joints ||
+    params_.damping_ratios.size() != joints)
+  {
+    RCLCPP_ERROR(
+      get_node()->get_logger(),
+      "'filters', 'frequencies' and 'damping_ratios' must have one value for every joint");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  if (!shaper_.resize(joints))
+  {
+    RCLCPP_ERROR(
+      get_node()->get_logger(), "At most %zu joints are supported", InputShaper::MAX_AXES);
+    return controller_interface::CallbackReturn::ERROR;
+  }
+
+  // The samples of the setpoints are assumed to be equidistant
+  const double period = 1.0 / get_update_rate();
+  for (std::size_t i = 0; i < joints; ++i)
+  {
+    InputShaper::Type type;
+    std::string error;
+    if (!InputShaper::parseType(params_.filters[i], type))
+    {
+      RCLCPP_ERROR(get_node()->get_logger(), "Unknown filter '%s'", params_.filters[i].c_str());
+      return controller_interface::CallbackReturn::ERROR;
+    }
+    if (!shaper_.setFilter(
+          i, type, params_.frequencies[i], params_.damping_ratios[i], params_.notch_damping,
+          period, error))
+    {
+      RCLCPP_ERROR(
+        get_node()->get_logger(), "Invalid filter of joint '%s': %s", params_.joints[i].c_str(),
+        error.c_str());
+      return controller_interface::CallbackReturn::ERROR;
+    }
+    RCLCPP_INFO(
+      get_node()->get_logger(), "Joint '%s': '%s' filter with %.3f s delay",
+      params_.joints[i].c_str(), params_.filters[i].c_str(), shaper_.delay(i));
+  }
+
+  input_.setZero(static_cast<Eigen::Index>(joints));
+  output_.setZero(static_cast<Eigen::Index>(joints));
+  reference_interfaces_.assign(joints, 0.0);
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn InputShapingController::on_activate(
+  const rclcpp_lifecycle::State &)
+{
+  // The filters start at rest in the current position, which is held without an upstream
+  //  controller
+  for (std::size_t i = 0; i < state_interfaces_.size(); ++i)
+  {
+    input_[static_cast<Eigen::Index>(i)] = state_interfaces_[i].get_value();
+    reference_interfaces_[i] = input_[static_cast<Eigen::Index>(i)];
+  }
+  shaper_.reset(input_);
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn InputShapingController::on_deactivate(
+  const rclcpp_lifecycle::State &)
+{
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+std::vector<hardware_interface::CommandInterface>
+InputShapingController::on_export_reference_interfaces()
+{
+  std::vector<hardware_interface::CommandInterface> reference_interfaces;
+  for (std::size_t i = 0; i < params_.joints.size(); ++i)
+  {
+    reference_interfaces.emplace_back(
+      get_node()->get_name(), params_.joints[i] + "/" + hardware_interface::HW_IF_POSITION,
+      &reference_interfaces_[i]);
+  }
+  return reference_interfaces;
+}
+
+controller_interface::return_type InputShapingController::update_reference_from_subscribers(
+  const rclcpp::Time &, const rclcpp::Duration &)
+{
+  // Without an upstream controller the last references are held
+  return controller_interface::return_type::OK;
+}
+
+controller_interface::return_type InputShapingController::update_and_write_commands(
+  const rclcpp::Time &, const rclcpp::Duration &)
+{
+  for (std::size_t i = 0; i < reference_interfaces_.size(); ++i)
+  {
+    // Invalid references hold the last valid one
+    const double reference = reference_interfaces_[i];
+    if (std::isfinite(reference))
+    {
+      input_[static_cast<Eigen::Index>(i)] = reference;
+    }
+  }
+
+  shaper_.filter(input_, output_);
+
+  for (std::size_t i = 0; i < command_interfaces_.size(); ++i)
+  {
+    command_interfaces_[i].set_value(output_[static_cast<Eigen::Index>(i)]);
+  }
+  return controller_interface::return_type::OK;
+}
+}  // namespace kuka_controllers
+
+PLUGINLIB_EXPORT_CLASS(
+  kuka_controllers::InputShapingController, controller_interface::ChainableControllerInterface)
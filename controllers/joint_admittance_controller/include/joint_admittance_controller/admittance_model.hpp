@@ -0,0 +1,93 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef JOINT_ADMITTANCE_CONTROLLER__ADMITTANCE_MODEL_HPP_
+#define JOINT_ADMITTANCE_CONTROLLER__ADMITTANCE_MODEL_HPP_
+
+#include <Eigen/Core>
+
+namespace kuka_controllers
+{
+/**
+ * @brief Virtual mass-spring-damper model with diagonal gains, integrated once per control cycle
+ *
+ * The model describes the deviation x from the equilibrium position:
+ *  M * x'' + D * x' + K * x = tau
+ * It uses fixed-size Eigen types only, so none of the methods allocate memory.
+ *
+ * @tparam DOF: Number of joints
+ */
+template <int DOF>
+class AdmittanceModel
+{
+public:
+  using Vector = Eigen::Matrix<double, DOF, 1>;
+
+  struct Gains
+  {
+    Vector mass = Vector::Ones();
+    Vector damping = Vector::Zero();
+    Vector stiffness = Vector::Zero();
+  };
+
+  /**
+   * @brief Restarts the model from standstill with the given equilibrium position
+   */
+  void reset(const Vector & equilibrium)
+  {
+    equilibrium_ = equilibrium;
+    deviation_.setZero();
+    velocity_.setZero();
+  }
+
+  /**
+   * @brief Integrates the model for one cycle with the implicit Euler method
+   *
+   * The damping and stiffness terms are evaluated at the end of the cycle, which keeps the
+   *  integration stable for all positive gains, independent of the cycle time.
+   *
+   * @param torque: External torque acting on the joints
+   * @param gains: Actual gains of the model, all masses must be positive
+   * @param dt: Cycle time in seconds
+   * @param max_velocity: Velocity limit of the joints, applied after the integration
+   * @return const Vector&: The new position setpoint (equilibrium + deviation)
+   */
+  const Vector & update(
+    const Vector & torque, const Gains & gains, double dt, const Vector & max_velocity)
+  {
+    if (dt > 0)
+    {
+      velocity_ = ((gains.mass.array() * velocity_.array() +
+                    dt * (torque.array() - gains.stiffness.array() * deviation_.array())) /
+                   (gains.mass.array() + dt * gains.damping.array() +
+                    dt * dt * gains.stiffness.array()))
+                    .matrix();
+      velocity_ = velocity_.cwiseMax(-max_velocity).cwiseMin(max_velocity);
+      deviation_ += dt * velocity_;
+    }
+    position_ = equilibrium_ + deviation_;
+    return position_;
+  }
+
+  const Vector & velocity() const { return velocity_; }
+
+private:
+  Vector equilibrium_ = Vector::Zero();
+  Vector deviation_ = Vector::Zero();
+  Vector velocity_ = Vector::Zero();
+  Vector position_ = Vector::Zero();
+};
+}  // namespace kuka_controllers
+
+#endif  // JOINT_ADMITTANCE_CONTROLLER__ADMITTANCE_MODEL_HPP_
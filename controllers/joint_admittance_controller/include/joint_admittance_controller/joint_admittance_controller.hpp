@@ -0,0 +1,86 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef JOINT_ADMITTANCE_CONTROLLER__JOINT_ADMITTANCE_CONTROLLER_HPP_
+#define JOINT_ADMITTANCE_CONTROLLER__JOINT_ADMITTANCE_CONTROLLER_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "controller_interface/controller_interface.hpp"
+#include "kuka_driver_interfaces/msg/joint_admittance_gains.hpp"
+#include "pluginlib/class_list_macros.hpp"
+#include "rclcpp/duration.hpp"
+#include "rclcpp/time.hpp"
+#include "realtime_tools/realtime_buffer.h"
+
+#include "joint_admittance_controller/admittance_model.hpp"
+#include "joint_admittance_controller/visibility_control.h"
+#include "joint_admittance_controller_parameters.hpp"
+
+namespace kuka_controllers
+{
+/**
+ * @brief Controller for hand guiding and compliant motions of the 7 DOF LBR robots
+ *
+ * The external torques are fed into a virtual mass-spring-damper model, which is integrated in
+ *  every cycle and provides the position commands of the joints.
+ */
+class JointAdmittanceController : public controller_interface::ControllerInterface
+{
+public:
+  JOINT_ADMITTANCE_CONTROLLER_PUBLIC controller_interface::InterfaceConfiguration
+  command_interface_configuration() const override;
+
+  JOINT_ADMITTANCE_CONTROLLER_PUBLIC controller_interface::InterfaceConfiguration
+  state_interface_configuration() const override;
+
+  JOINT_ADMITTANCE_CONTROLLER_PUBLIC controller_interface::return_type update(
+    const rclcpp::Time & time, const rclcpp::Duration & period) override;
+
+  JOINT_ADMITTANCE_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_configure(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  JOINT_ADMITTANCE_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_activate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  JOINT_ADMITTANCE_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_deactivate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  JOINT_ADMITTANCE_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_init() override;
+
+private:
+  static constexpr int DOF = 7;
+  using Model = AdmittanceModel<DOF>;
+
+  JOINT_ADMITTANCE_CONTROLLER_LOCAL void onGains(
+    const kuka_driver_interfaces::msg::JointAdmittanceGains::SharedPtr msg);
+
+  using Params = joint_admittance_controller::Params;
+  using ParamListener = joint_admittance_controller::ParamListener;
+
+  std::shared_ptr<ParamListener> param_listener_;
+  Params params_;
+
+  rclcpp::Subscription<kuka_driver_interfaces::msg::JointAdmittanceGains>::SharedPtr
+    gains_subscriber_;
+  realtime_tools::RealtimeBuffer<Model::Gains> gains_buffer_;
+
+  Model model_;
+  Model::Vector torques_;
+  Model::Vector max_velocity_;
+};
+}  // namespace kuka_controllers
+#endif  // JOINT_ADMITTANCE_CONTROLLER__JOINT_ADMITTANCE_CONTROLLER_HPP_
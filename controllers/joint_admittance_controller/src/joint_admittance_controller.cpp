@@ -0,0 +1,171 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "kuka_drivers_core/hardware_interface_types.hpp"
+
+#include "joint_admittance_controller/joint_admittance_controller.hpp"
+
+namespace kuka_controllers
+{
+controller_interface::CallbackReturn JointAdmittanceController::on_init()
+{
+  try
+  {
+    param_listener_ = std::make_shared<ParamListener>(get_node());
+    params_ = param_listener_->get_params();
+  }
+  catch (const std::exception & e)
+  {
+    fprintf(stderr, "Exception thrown during init stage with message: %s \n", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::InterfaceConfiguration
+JointAdmittanceController::command_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_POSITION);
+  }
+  return config;
+}
+
+controller_interface::InterfaceConfiguration
+JointAdmittanceController::state_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_POSITION);
+  }
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + params_.torque_interface);
+  }
+  return config;
+}
+
+controller_interface::CallbackReturn JointAdmittanceController::on_configure(
+  const rclcpp_lifecycle::State &)
+{
+  params_ = param_listener_->get_params();
+  if (params_.joints.size() != DOF)
+  {
+    RCLCPP_ERROR(
+      get_node()->get_logger(), "'joints' parameter must contain %i joints, got %zu", DOF,
+      params_.joints.size());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+
+  Model::Gains gains;
+  gains.mass = Eigen::Map<const Model::Vector>(params_.mass.data());
+  gains.damping = Eigen::Map<const Model::Vector>(params_.damping.data());
+  gains.stiffness = Eigen::Map<const Model::Vector>(params_.stiffness.data());
+  gains_buffer_.writeFromNonRT(gains);
+  max_velocity_.setConstant(params_.max_velocity);
+
+  gains_subscriber_ =
+    get_node()->create_subscription<kuka_driver_interfaces::msg::JointAdmittanceGains>(
+      "~/gains", rclcpp::SystemDefaultsQoS(),
+      [this](const kuka_driver_interfaces::msg::JointAdmittanceGains::SharedPtr msg)
+      { onGains(msg); });
+
+  RCLCPP_INFO(get_node()->get_logger(), "Joint admittance controller configured");
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn JointAdmittanceController::on_activate(
+  const rclcpp_lifecycle::State &)
+{
+  // The equilibrium of the virtual spring is the position at activation
+  Model::Vector position;
+  for (int i = 0; i < DOF; ++i)
+  {
+    position[i] = state_interfaces_[i].get_value();
+  }
+  model_.reset(position);
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn JointAdmittanceController::on_deactivate(
+  const rclcpp_lifecycle::State &)
+{
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::return_type JointAdmittanceController::update(
+  const rclcpp::Time &, const rclcpp::Duration & period)
+{
+  for (int i = 0; i < DOF; ++i)
+  {
+    const double torque = state_interfaces_[DOF + i].get_value();
+    // Subtract the deadband to get a continuous input
+    torques_[i] = std::abs(torque) > params_.torque_deadband
+                    ? torque - std::copysign(params_.torque_deadband, torque)
+                    : 0.0;
+  }
+
+  const Model::Vector & position =
+    model_.update(torques_, *gains_buffer_.readFromRT(), period.seconds(), max_velocity_);
+  for (int i = 0; i < DOF; ++i)
+  {
+    command_interfaces_[i].set_value(position[i]);
+  }
+
+  return controller_interface::return_type::OK;
+}
+
+void JointAdmittanceController::onGains(
+  const kuka_driver_interfaces::msg::JointAdmittanceGains::SharedPtr msg)
+{
+  if (msg->mass.size() != DOF || msg->damping.size() != DOF || msg->stiffness.size() != DOF)
+  {
+    RCLCPP_ERROR(
+      get_node()->get_logger(), "Gains must contain %i values for every attribute, ignoring them",
+      DOF);
+    return;
+  }
+
+  const auto non_positive = [](double value) { return value <= 0; };
+  const auto negative = [](double value) { return value < 0; };
+  if (
+    std::any_of(msg->mass.begin(), msg->mass.end(), non_positive) ||
+    std::any_of(msg->damping.begin(), msg->damping.end(), negative) ||
+    std::any_of(msg->stiffness.begin(), msg->stiffness.end(), negative))
+  {
+    RCLCPP_ERROR(
+      get_node()->get_logger(),
+      "Masses must be positive, damping and stiffness values non-negative, ignoring gains");
+    return;
+  }
+
+  Model::Gains gains;
+  gains.mass = Eigen::Map<const Model::Vector>(msg->mass.data());
+  gains.damping = Eigen::Map<const Model::Vector>(msg->damping.data());
+  gains.stiffness = Eigen::Map<const Model::Vector>(msg->stiffness.data());
+  gains_buffer_.writeFromNonRT(gains);
+}
+}  // namespace kuka_controllers
+
+PLUGINLIB_EXPORT_CLASS(
+  kuka_controllers::JointAdmittanceController, controller_interface::ControllerInterface)
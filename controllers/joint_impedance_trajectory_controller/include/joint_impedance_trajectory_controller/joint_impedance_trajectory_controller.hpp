@@ -0,0 +1,100 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef JOINT_IMPEDANCE_TRAJECTORY_CONTROLLER__JOINT_IMPEDANCE_TRAJECTORY_CONTROLLER_HPP_
+#define JOINT_IMPEDANCE_TRAJECTORY_CONTROLLER__JOINT_IMPEDANCE_TRAJECTORY_CONTROLLER_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "builtin_interfaces/msg/time.hpp"
+#include "controller_interface/controller_interface.hpp"
+#include "kuka_driver_interfaces/msg/joint_impedance_trajectory.hpp"
+#include "pluginlib/class_list_macros.hpp"
+#include "rclcpp/duration.hpp"
+#include "rclcpp/time.hpp"
+#include "realtime_tools/realtime_buffer.h"
+
+#include "joint_impedance_trajectory_controller/spline_trajectory.hpp"
+#include "joint_impedance_trajectory_controller/visibility_control.h"
+#include "joint_impedance_trajectory_controller_parameters.hpp"
+
+namespace kuka_controllers
+{
+class JointImpedanceTrajectoryController : public controller_interface::ControllerInterface
+{
+public:
+  JOINT_IMPEDANCE_TRAJECTORY_CONTROLLER_PUBLIC controller_interface::InterfaceConfiguration
+  command_interface_configuration() const override;
+
+  JOINT_IMPEDANCE_TRAJECTORY_CONTROLLER_PUBLIC controller_interface::InterfaceConfiguration
+  state_interface_configuration() const override;
+
+  JOINT_IMPEDANCE_TRAJECTORY_CONTROLLER_PUBLIC controller_interface::return_type update(
+    const rclcpp::Time & time, const rclcpp::Duration & period) override;
+
+  JOINT_IMPEDANCE_TRAJECTORY_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_configure(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  JOINT_IMPEDANCE_TRAJECTORY_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_activate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  JOINT_IMPEDANCE_TRAJECTORY_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_deactivate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  JOINT_IMPEDANCE_TRAJECTORY_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_init()
+    override;
+
+private:
+  // Trajectory with the precomputed splines, passed from the subscription to the control loop
+  struct TrajectoryCommand
+  {
+    std::shared_ptr<const SplineTrajectory> spline;
+    builtin_interfaces::msg::Time start_stamp;
+  };
+
+  JOINT_IMPEDANCE_TRAJECTORY_CONTROLLER_LOCAL void onTrajectory(
+    const kuka_driver_interfaces::msg::JointImpedanceTrajectory::SharedPtr msg);
+  JOINT_IMPEDANCE_TRAJECTORY_CONTROLLER_LOCAL void startTrajectory(
+    const TrajectoryCommand & command, const rclcpp::Time & time);
+
+  using Params = joint_impedance_trajectory_controller::Params;
+  using ParamListener = joint_impedance_trajectory_controller::ParamListener;
+
+  std::shared_ptr<ParamListener> param_listener_;
+  Params params_;
+
+  rclcpp::Subscription<kuka_driver_interfaces::msg::JointImpedanceTrajectory>::SharedPtr
+    trajectory_subscriber_;
+  realtime_tools::RealtimeBuffer<TrajectoryCommand> trajectory_buffer_;
+
+  std::shared_ptr<const SplineTrajectory> active_trajectory_;
+  rclcpp::Time trajectory_start_;
+  std::size_t segment_hint_ = 0;
+
+  // Segment from the actual command to the first knot of the active trajectory
+  std::vector<SplineTrajectory::Coefficients> entry_segment_;
+  double entry_start_ = 0;
+
+  // Interpolated channels in the order of positions, stiffness and damping values
+  std::vector<double> channel_values_;
+  std::vector<double> channel_velocities_;
+
+  // Command interfaces of one joint: position, stiffness, damping and effort
+  static constexpr std::size_t INTERFACES_PER_JOINT = 4;
+  static constexpr std::size_t CHANNELS_PER_JOINT = 3;
+};
+}  // namespace kuka_controllers
+#endif  // JOINT_IMPEDANCE_TRAJECTORY_CONTROLLER__JOINT_IMPEDANCE_TRAJECTORY_CONTROLLER_HPP_
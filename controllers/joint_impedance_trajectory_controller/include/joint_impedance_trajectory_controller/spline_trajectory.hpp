@@ -0,0 +1,98 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef JOINT_IMPEDANCE_TRAJECTORY_CONTROLLER__SPLINE_TRAJECTORY_HPP_
+#define JOINT_IMPEDANCE_TRAJECTORY_CONTROLLER__SPLINE_TRAJECTORY_HPP_
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace kuka_controllers
+{
+/**
+ * @brief Cubic spline through the knots of a multi-channel trajectory
+ *
+ * The polynomial coefficients of every segment are calculated in the constructor, therefore the
+ *  evaluation does not allocate memory and consists only of a segment lookup and a Horner scheme.
+ * The second derivative is zero at the first knot and the velocity is zero at the last one, so the
+ *  trajectory can be entered with any velocity and comes to a rest at its end.
+ */
+class SplineTrajectory
+{
+public:
+  using Coefficients = std::array<double, 4>;
+
+  /**
+   * @brief Calculates the spline coefficients
+   *
+   * @param knot_times: Strictly increasing times of the knots relative to the trajectory start
+   * @param knot_values: Values of every channel at every knot, indexed as [knot][channel]
+   * @exception std::invalid_argument: the knots are empty, inconsistent or not ordered in time
+   */
+  SplineTrajectory(
+    const std::vector<double> & knot_times, const std::vector<std::vector<double>> & knot_values);
+
+  /**
+   * @brief Evaluates every channel of the trajectory at the given time
+   *
+   * Before the first knot the values of the first knot are returned, after the last knot the
+   *  trajectory holds the values of the last knot.
+   *
+   * @param t: Time relative to the trajectory start
+   * @param segment_hint: Index of the segment found in the previous call, updated in place
+   * @param values: Output array with one element per channel
+   * @param velocities: Output array with one element per channel
+   */
+  void evaluate(double t, std::size_t & segment_hint, double * values, double * velocities) const;
+
+  std::size_t channelCount() const { return channels_; }
+  double startTime() const { return knot_times_.front(); }
+  double endTime() const { return knot_times_.back(); }
+  double startValue(std::size_t channel) const { return start_values_[channel]; }
+  double startVelocity(std::size_t channel) const { return start_velocities_[channel]; }
+
+  /**
+   * @brief Calculates the coefficients of a cubic Hermite segment with the given boundary values
+   *
+   * @param p0: Value at the beginning of the segment
+   * @param v0: Velocity at the beginning of the segment
+   * @param p1: Value at the end of the segment
+   * @param v1: Velocity at the end of the segment
+   * @param duration: Length of the segment, must be positive
+   */
+  static Coefficients hermite(double p0, double v0, double p1, double v1, double duration);
+
+  static double value(const Coefficients & c, double tau)
+  {
+    return ((c[3] * tau + c[2]) * tau + c[1]) * tau + c[0];
+  }
+
+  static double velocity(const Coefficients & c, double tau)
+  {
+    return (3 * c[3] * tau + 2 * c[2]) * tau + c[1];
+  }
+
+private:
+  std::size_t channels_;
+  std::vector<double> knot_times_;
+  // Coefficients of the segments, indexed as [segment * channels_ + channel]
+  std::vector<Coefficients> coefficients_;
+  std::vector<double> start_values_;
+  std::vector<double> start_velocities_;
+  std::vector<double> end_values_;
+};
+}  // namespace kuka_controllers
+
+#endif  // JOINT_IMPEDANCE_TRAJECTORY_CONTROLLER__SPLINE_TRAJECTORY_HPP_
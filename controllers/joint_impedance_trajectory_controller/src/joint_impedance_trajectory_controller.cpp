@@ -0,0 +1,271 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "kuka_drivers_core/hardware_interface_types.hpp"
+
+#include "joint_impedance_trajectory_controller/joint_impedance_trajectory_controller.hpp"
+
+namespace kuka_controllers
+{
+controller_interface::CallbackReturn JointImpedanceTrajectoryController::on_init()
+{
+  try
+  {
+    param_listener_ = std::make_shared<ParamListener>(get_node());
+    params_ = param_listener_->get_params();
+  }
+  catch (const std::exception & e)
+  {
+    fprintf(stderr, "Exception thrown during init stage with message: %s \n", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::InterfaceConfiguration
+JointImpedanceTrajectoryController::command_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_POSITION);
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_STIFFNESS);
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_DAMPING);
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_EFFORT);
+  }
+  return config;
+}
+
+controller_interface::InterfaceConfiguration
+JointImpedanceTrajectoryController::state_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_POSITION);
+  }
+  return config;
+}
+
+controller_interface::CallbackReturn JointImpedanceTrajectoryController::on_configure(
+  const rclcpp_lifecycle::State &)
+{
+  params_ = param_listener_->get_params();
+  if (params_.joints.empty())
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "'joints' parameter is empty");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+
+  const std::size_t channels = params_.joints.size() * CHANNELS_PER_JOINT;
+  channel_values_.assign(channels, 0.0);
+  channel_velocities_.assign(channels, 0.0);
+  entry_segment_.assign(channels, SplineTrajectory::Coefficients{});
+
+  trajectory_subscriber_ =
+    get_node()->create_subscription<kuka_driver_interfaces::msg::JointImpedanceTrajectory>(
+      "~/joint_trajectory", rclcpp::SystemDefaultsQoS(),
+      [this](const kuka_driver_interfaces::msg::JointImpedanceTrajectory::SharedPtr msg)
+      { onTrajectory(msg); });
+
+  RCLCPP_INFO(get_node()->get_logger(), "Joint impedance trajectory controller configured");
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn JointImpedanceTrajectoryController::on_activate(
+  const rclcpp_lifecycle::State &)
+{
+  // Start from the measured positions and the impedance values currently set in the hardware
+  const std::size_t joints = params_.joints.size();
+  for (std::size_t i = 0; i < joints; ++i)
+  {
+    channel_values_[i] = state_interfaces_[i].get_value();
+    channel_values_[joints + i] = command_interfaces_[i * INTERFACES_PER_JOINT + 1].get_value();
+    channel_values_[2 * joints + i] =
+      command_interfaces_[i * INTERFACES_PER_JOINT + 2].get_value();
+  }
+  std::fill(channel_velocities_.begin(), channel_velocities_.end(), 0.0);
+
+  active_trajectory_.reset();
+  trajectory_buffer_.writeFromNonRT(TrajectoryCommand{});
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn JointImpedanceTrajectoryController::on_deactivate(
+  const rclcpp_lifecycle::State &)
+{
+  active_trajectory_.reset();
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::return_type JointImpedanceTrajectoryController::update(
+  const rclcpp::Time & time, const rclcpp::Duration &)
+{
+  const TrajectoryCommand * command = trajectory_buffer_.readFromRT();
+  if (command->spline && command->spline != active_trajectory_)
+  {
+    startTrajectory(*command, time);
+  }
+
+  if (active_trajectory_)
+  {
+    const double t = (time - trajectory_start_).seconds();
+    if (t < entry_start_)
+    {
+      // Trajectory starts in the future, hold the actual values
+    }
+    else if (t < active_trajectory_->startTime())
+    {
+      for (std::size_t c = 0; c < channel_values_.size(); ++c)
+      {
+        channel_values_[c] = SplineTrajectory::value(entry_segment_[c], t - entry_start_);
+        channel_velocities_[c] = SplineTrajectory::velocity(entry_segment_[c], t - entry_start_);
+      }
+    }
+    else
+    {
+      active_trajectory_->evaluate(
+        t, segment_hint_, channel_values_.data(), channel_velocities_.data());
+    }
+  }
+
+  const std::size_t joints = params_.joints.size();
+  for (std::size_t i = 0; i < joints; ++i)
+  {
+    command_interfaces_[i * INTERFACES_PER_JOINT].set_value(channel_values_[i]);
+    // Spline overshoot must not result in negative impedance attributes
+    command_interfaces_[i * INTERFACES_PER_JOINT + 1].set_value(
+      std::max(0.0, channel_values_[joints + i]));
+    command_interfaces_[i * INTERFACES_PER_JOINT + 2].set_value(
+      std::max(0.0, channel_values_[2 * joints + i]));
+    // No additional torque is commanded on top of the impedance control
+    command_interfaces_[i * INTERFACES_PER_JOINT + 3].set_value(0.0);
+  }
+
+  return controller_interface::return_type::OK;
+}
+
+void JointImpedanceTrajectoryController::startTrajectory(
+  const TrajectoryCommand & command, const rclcpp::Time & time)
+{
+  active_trajectory_ = command.spline;
+  segment_hint_ = 0;
+
+  const rclcpp::Time stamp(command.start_stamp, time.get_clock_type());
+  trajectory_start_ = stamp.nanoseconds() == 0 ? time : stamp;
+
+  // A trajectory with a start time in the future is entered from standstill
+  entry_start_ = (time - trajectory_start_).seconds();
+  if (entry_start_ < 0)
+  {
+    entry_start_ = 0;
+    std::fill(channel_velocities_.begin(), channel_velocities_.end(), 0.0);
+  }
+
+  // Connect the actual state smoothly to the first knot, if there is time left until reaching it
+  const double entry_duration = active_trajectory_->startTime() - entry_start_;
+  if (entry_duration <= 0)
+  {
+    return;
+  }
+  for (std::size_t c = 0; c < channel_values_.size(); ++c)
+  {
+    entry_segment_[c] = SplineTrajectory::hermite(
+      channel_values_[c], channel_velocities_[c], active_trajectory_->startValue(c),
+      active_trajectory_->startVelocity(c), entry_duration);
+  }
+}
+
+void JointImpedanceTrajectoryController::onTrajectory(
+  const kuka_driver_interfaces::msg::JointImpedanceTrajectory::SharedPtr msg)
+{
+  if (msg->points.empty())
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "Received trajectory without points, ignoring it");
+    return;
+  }
+
+  // Map the joints of the message to the order of the controlled joints
+  const std::size_t joints = params_.joints.size();
+  std::vector<std::size_t> msg_index(joints);
+  for (std::size_t i = 0; i < joints; ++i)
+  {
+    auto it = std::find(msg->joint_names.begin(), msg->joint_names.end(), params_.joints[i]);
+    if (it == msg->joint_names.end())
+    {
+      RCLCPP_ERROR(
+        get_node()->get_logger(), "Joint '%s' is missing from the trajectory, ignoring it",
+        params_.joints[i].c_str());
+      return;
+    }
+    msg_index[i] = static_cast<std::size_t>(std::distance(msg->joint_names.begin(), it));
+  }
+
+  std::vector<double> knot_times;
+  std::vector<std::vector<double>> knot_values;
+  knot_times.reserve(msg->points.size());
+  knot_values.reserve(msg->points.size());
+  for (const auto & point : msg->points)
+  {
+    const std::size_t size = msg->joint_names.size();
+    if (
+      point.positions.size() != size || point.stiffness.size() != size ||
+      point.damping.size() != size)
+    {
+      RCLCPP_ERROR(
+        get_node()->get_logger(),
+        "Every trajectory point must contain position, stiffness and damping values for all "
+        "joints, ignoring trajectory");
+      return;
+    }
+
+    std::vector<double> values(joints * CHANNELS_PER_JOINT);
+    for (std::size_t i = 0; i < joints; ++i)
+    {
+      values[i] = point.positions[msg_index[i]];
+      values[joints + i] = point.stiffness[msg_index[i]];
+      values[2 * joints + i] = point.damping[msg_index[i]];
+      if (values[joints + i] < 0 || values[2 * joints + i] < 0)
+      {
+        RCLCPP_ERROR(
+          get_node()->get_logger(),
+          "Stiffness and damping values must be non-negative, ignoring trajectory");
+        return;
+      }
+    }
+    knot_times.push_back(rclcpp::Duration(point.time_from_start).seconds());
+    knot_values.push_back(std::move(values));
+  }
+
+  try
+  {
+    trajectory_buffer_.writeFromNonRT(TrajectoryCommand{
+      std::make_shared<const SplineTrajectory>(knot_times, knot_values), msg->header.stamp});
+  }
+  catch (const std::invalid_argument & e)
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "Invalid trajectory: %s", e.what());
+  }
+}
+}  // namespace kuka_controllers
+
+PLUGINLIB_EXPORT_CLASS(
+  kuka_controllers::JointImpedanceTrajectoryController, controller_interface::ControllerInterface)
@@ -0,0 +1,151 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdexcept>
+
+#include "joint_impedance_trajectory_controller/spline_trajectory.hpp"
+
+namespace kuka_controllers
+{
+SplineTrajectory::SplineTrajectory(
+  const std::vector<double> & knot_times, const std::vector<std::vector<double>> & knot_values)
+: knot_times_(knot_times)
+{
+  if (knot_times.empty() || knot_times.size() != knot_values.size())
+  {
+    throw std::invalid_argument("Number of knot times and knot values must match");
+  }
+  channels_ = knot_values.front().size();
+  for (const auto & knot : knot_values)
+  {
+    if (knot.size() != channels_)
+    {
+      throw std::invalid_argument("Every knot must contain the same number of values");
+    }
+  }
+  for (std::size_t i = 1; i < knot_times.size(); ++i)
+  {
+    if (knot_times[i] <= knot_times[i - 1])
+    {
+      throw std::invalid_argument("Knot times must be strictly increasing");
+    }
+  }
+
+  const std::size_t knots = knot_times.size();
+  start_values_ = knot_values.front();
+  end_values_ = knot_values.back();
+  start_velocities_.assign(channels_, 0.0);
+  if (knots == 1)
+  {
+    return;
+  }
+
+  const std::size_t segments = knots - 1;
+  std::vector<double> h(segments);
+  for (std::size_t i = 0; i < segments; ++i)
+  {
+    h[i] = knot_times[i + 1] - knot_times[i];
+  }
+
+  // The tridiagonal system for the second derivatives (M) only depends on the knot times, so the
+  //  forward elimination factors are shared by all channels (Thomas algorithm)
+  // First row: M_0 = 0, last row: zero velocity at the last knot
+  std::vector<double> lower(knots, 0.0);
+  std::vector<double> pivot(knots, 1.0);
+  std::vector<double> upper_eliminated(knots, 0.0);
+  for (std::size_t i = 1; i < knots; ++i)
+  {
+    const bool last = i == knots - 1;
+    lower[i] = h[i - 1];
+    const double diag = last ? 2 * h[i - 1] : 2 * (h[i - 1] + h[i]);
+    const double upper = last ? 0.0 : h[i];
+    pivot[i] = diag - lower[i] * upper_eliminated[i - 1];
+    upper_eliminated[i] = upper / pivot[i];
+  }
+
+  coefficients_.resize(segments * channels_);
+  std::vector<double> rhs(knots);
+  std::vector<double> moments(knots);
+  for (std::size_t c = 0; c < channels_; ++c)
+  {
+    rhs[0] = 0.0;
+    for (std::size_t i = 1; i < knots; ++i)
+    {
+      const double slope_before = (knot_values[i][c] - knot_values[i - 1][c]) / h[i - 1];
+      const double slope_after =
+        i == knots - 1 ? 0.0 : (knot_values[i + 1][c] - knot_values[i][c]) / h[i];
+      rhs[i] = (6 * (slope_after - slope_before) - lower[i] * rhs[i - 1]) / pivot[i];
+    }
+    moments[knots - 1] = rhs[knots - 1];
+    for (std::size_t i = knots - 1; i-- > 0;)
+    {
+      moments[i] = rhs[i] - upper_eliminated[i] * moments[i + 1];
+    }
+
+    for (std::size_t s = 0; s < segments; ++s)
+    {
+      const double y0 = knot_values[s][c];
+      const double y1 = knot_values[s + 1][c];
+      auto & coeff = coefficients_[s * channels_ + c];
+      coeff[0] = y0;
+      coeff[1] = (y1 - y0) / h[s] - h[s] * (2 * moments[s] + moments[s + 1]) / 6;
+      coeff[2] = moments[s] / 2;
+      coeff[3] = (moments[s + 1] - moments[s]) / (6 * h[s]);
+    }
+    start_velocities_[c] = coefficients_[c][1];
+  }
+}
+
+void SplineTrajectory::evaluate(
+  double t, std::size_t & segment_hint, double * values, double * velocities) const
+{
+  if (t <= knot_times_.front() || t >= knot_times_.back())
+  {
+    const auto & hold = t <= knot_times_.front() ? start_values_ : end_values_;
+    for (std::size_t c = 0; c < channels_; ++c)
+    {
+      values[c] = hold[c];
+      velocities[c] = t <= knot_times_.front() ? start_velocities_[c] : 0.0;
+    }
+    return;
+  }
+
+  // Time is monotonic in the control loop, so the search starts from the previous segment
+  const std::size_t segments = knot_times_.size() - 1;
+  if (segment_hint >= segments || t < knot_times_[segment_hint])
+  {
+    segment_hint = 0;
+  }
+  while (segment_hint + 1 < segments && t >= knot_times_[segment_hint + 1])
+  {
+    ++segment_hint;
+  }
+
+  const double tau = t - knot_times_[segment_hint];
+  const Coefficients * coeff = &coefficients_[segment_hint * channels_];
+  for (std::size_t c = 0; c < channels_; ++c)
+  {
+    values[c] = value(coeff[c], tau);
+    velocities[c] = velocity(coeff[c], tau);
+  }
+}
+
+SplineTrajectory::Coefficients SplineTrajectory::hermite(
+  double p0, double v0, double p1, double v1, double duration)
+{
+  const double slope = (p1 - p0) / duration;
+  return {
+    p0, v0, (3 * slope - 2 * v0 - v1) / duration, (v0 + v1 - 2 * slope) / (duration * duration)};
+}
+}  // namespace kuka_controllers
@@ -0,0 +1,111 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef JOINT_STREAMING_CONTROLLER__JITTER_BUFFER_HPP_
+#define JOINT_STREAMING_CONTROLLER__JITTER_BUFFER_HPP_
+
+#include <cstdint>
+#include <vector>
+
+namespace kuka_controllers
+{
+/**
+ * @brief Buffer of timestamped joint setpoints ordered by their stamps, which is sampled at a
+ *  playback time
+ *
+ * Memory is allocated only in configure(), all other methods can be called from the control loop.
+ */
+class JitterBuffer
+{
+public:
+  enum class InsertResult
+  {
+    INSERTED,
+    LATE,       // Stamp is not after the last playback time, setpoint was dropped
+    OVERFLOWED  // Buffer was full, the oldest setpoint was dropped
+  };
+
+  enum class SampleResult
+  {
+    EMPTY,         // No setpoint has been reached yet, output is not valid
+    INTERPOLATED,  // Output is interpolated between two setpoints
+    EXTRAPOLATED,  // Playback time is after the newest setpoint, output is extrapolated
+    HELD           // Extrapolation time limit was reached, output is held
+  };
+
+  /**
+   * @brief Allocates the buffer
+   *
+   * @param capacity: Maximum number of stored setpoints, at least 2
+   * @param dof: Number of joint positions in a setpoint
+   */
+  void configure(std::size_t capacity, std::size_t dof);
+
+  /**
+   * @brief Removes all setpoints and resets the playback time
+   */
+  void clear();
+
+  /**
+   * @brief Inserts a setpoint according to its stamp
+   *
+   * @param stamp: Time of the setpoint in nanoseconds
+   * @param positions: Array with the positions of all joints
+   */
+  InsertResult insert(int64_t stamp, const double * positions);
+
+  /**
+   * @brief Calculates the positions at the given playback time, playback time must not decrease
+   *
+   * Setpoints are interpolated linearly, so gaps in the stream result in a smooth motion. After
+   *  the newest setpoint the velocity of the last segment is kept for at most max_extrapolation
+   *  nanoseconds, then the positions are held.
+   *
+   * @param time: Playback time in nanoseconds
+   * @param max_extrapolation: Maximum duration of extrapolation in nanoseconds
+   * @param max_velocity: Velocity limit of extrapolation in rad/s
+   * @param output: Array for the positions of all joints
+   */
+  SampleResult sample(
+    int64_t time, int64_t max_extrapolation, double max_velocity, double * output);
+
+  /**
+   * @brief Number of setpoints after the last playback time
+   */
+  std::size_t depth() const;
+
+private:
+  std::size_t slot(std::size_t index) const { return (begin_ + index) % capacity_; }
+  double * positions(std::size_t index) { return &positions_[slot(index) * dof_]; }
+  void popFront();
+
+  std::size_t capacity_ = 0;
+  std::size_t dof_ = 0;
+  std::vector<int64_t> stamps_;
+  std::vector<double> positions_;
+  std::size_t begin_ = 0;
+  std::size_t size_ = 0;
+
+  // Last playback time, setpoints with earlier stamps are dropped
+  int64_t playback_time_ = 0;
+  bool started_ = false;
+
+  // Setpoint removed most recently from the front, used for the extrapolation velocity
+  int64_t previous_stamp_ = 0;
+  std::vector<double> previous_positions_;
+  bool has_previous_ = false;
+};
+}  // namespace kuka_controllers
+
+#endif  // JOINT_STREAMING_CONTROLLER__JITTER_BUFFER_HPP_
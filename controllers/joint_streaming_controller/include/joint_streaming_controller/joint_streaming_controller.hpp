@@ -0,0 +1,105 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef JOINT_STREAMING_CONTROLLER__JOINT_STREAMING_CONTROLLER_HPP_
+#define JOINT_STREAMING_CONTROLLER__JOINT_STREAMING_CONTROLLER_HPP_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "controller_interface/controller_interface.hpp"
+#include "kuka_driver_interfaces/msg/joint_setpoint.hpp"
+#include "kuka_driver_interfaces/msg/streaming_statistics.hpp"
+#include "pluginlib/class_list_macros.hpp"
+#include "rclcpp/duration.hpp"
+#include "rclcpp/time.hpp"
+#include "realtime_tools/realtime_publisher.h"
+
+#include "joint_streaming_controller/jitter_buffer.hpp"
+#include "joint_streaming_controller/setpoint_queue.hpp"
+#include "joint_streaming_controller/visibility_control.h"
+#include "joint_streaming_controller_parameters.hpp"
+
+namespace kuka_controllers
+{
+/**
+ * @brief Controller for executing joint position setpoints streamed at a high rate
+ *
+ * The setpoints are played back with a fixed latency after their stamps, so the transport jitter
+ *  does not affect the motion.
+ */
+class JointStreamingController : public controller_interface::ControllerInterface
+{
+public:
+  JOINT_STREAMING_CONTROLLER_PUBLIC controller_interface::InterfaceConfiguration
+  command_interface_configuration() const override;
+
+  JOINT_STREAMING_CONTROLLER_PUBLIC controller_interface::InterfaceConfiguration
+  state_interface_configuration() const override;
+
+  JOINT_STREAMING_CONTROLLER_PUBLIC controller_interface::return_type update(
+    const rclcpp::Time & time, const rclcpp::Duration & period) override;
+
+  JOINT_STREAMING_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_configure(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  JOINT_STREAMING_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_activate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  JOINT_STREAMING_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_deactivate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  JOINT_STREAMING_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_init() override;
+
+private:
+  JOINT_STREAMING_CONTROLLER_LOCAL void onSetpoint(
+    const kuka_driver_interfaces::msg::JointSetpoint::SharedPtr msg);
+  JOINT_STREAMING_CONTROLLER_LOCAL void publishStatistics(const rclcpp::Time & time);
+
+  using Params = joint_streaming_controller::Params;
+  using ParamListener = joint_streaming_controller::ParamListener;
+
+  std::shared_ptr<ParamListener> param_listener_;
+  Params params_;
+  bool use_arrival_stamps_ = false;
+  int64_t latency_ns_ = 0;
+  int64_t max_extrapolation_ns_ = 0;
+
+  rclcpp::Subscription<kuka_driver_interfaces::msg::JointSetpoint>::SharedPtr
+    setpoint_subscriber_;
+  // Passes the setpoints from the subscription to the control loop
+  SetpointQueue setpoint_queue_;
+  std::atomic<bool> accept_setpoints_{false};
+  std::atomic<uint64_t> queue_overflows_{0};
+
+  JitterBuffer jitter_buffer_;
+  std::vector<double> positions_;
+  bool underrun_ = false;
+
+  uint64_t received_ = 0;
+  uint64_t underruns_ = 0;
+  uint64_t late_drops_ = 0;
+  uint64_t overflow_drops_ = 0;
+
+  std::shared_ptr<rclcpp::Publisher<kuka_driver_interfaces::msg::StreamingStatistics>>
+    statistics_publisher_;
+  std::unique_ptr<
+    realtime_tools::RealtimePublisher<kuka_driver_interfaces::msg::StreamingStatistics>>
+    rt_statistics_publisher_;
+  int64_t last_statistics_ns_ = 0;
+};
+}  // namespace kuka_controllers
+#endif  // JOINT_STREAMING_CONTROLLER__JOINT_STREAMING_CONTROLLER_HPP_
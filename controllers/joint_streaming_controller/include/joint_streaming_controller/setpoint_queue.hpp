@@ -0,0 +1,95 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef JOINT_STREAMING_CONTROLLER__SETPOINT_QUEUE_HPP_
+#define JOINT_STREAMING_CONTROLLER__SETPOINT_QUEUE_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace kuka_controllers
+{
+/**
+ * @brief Lock-free single producer, single consumer queue of joint setpoints
+ *
+ * The slots are allocated in configure(), pushing and popping only copies the values, so the
+ *  consumer side can be used from the control loop.
+ */
+class SetpointQueue
+{
+public:
+  struct Setpoint
+  {
+    int64_t stamp = 0;
+    std::vector<double> positions;
+  };
+
+  /**
+   * @brief Allocates the slots of the queue, must not be called while the queue is in use
+   */
+  void configure(std::size_t capacity, std::size_t dof)
+  {
+    slots_.assign(capacity + 1, Setpoint{0, std::vector<double>(dof, 0.0)});
+    head_ = 0;
+    tail_ = 0;
+  }
+
+  /**
+   * @brief Adds a setpoint to the queue, called by the producer
+   *
+   * @return bool: False if the queue is full and the setpoint was dropped
+   */
+  bool push(int64_t stamp, const std::vector<double> & positions)
+  {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    const std::size_t next = (tail + 1) % slots_.size();
+    if (next == head_.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+    slots_[tail].stamp = stamp;
+    std::copy(positions.begin(), positions.end(), slots_[tail].positions.begin());
+    tail_.store(next, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Returns the oldest setpoint of the queue or nullptr if it is empty, called by the
+   *  consumer
+   */
+  const Setpoint * front() const
+  {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    return head == tail_.load(std::memory_order_acquire) ? nullptr : &slots_[head];
+  }
+
+  /**
+   * @brief Removes the oldest setpoint, called by the consumer after processing front()
+   */
+  void pop()
+  {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    head_.store((head + 1) % slots_.size(), std::memory_order_release);
+  }
+
+private:
+  std::vector<Setpoint> slots_;
+  std::atomic<std::size_t> head_{0};
+  std::atomic<std::size_t> tail_{0};
+};
+}  // namespace kuka_controllers
+
+#endif  // JOINT_STREAMING_CONTROLLER__SETPOINT_QUEUE_HPP_
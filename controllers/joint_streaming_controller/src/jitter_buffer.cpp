@@ -0,0 +1,155 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include "joint_streaming_controller/jitter_buffer.hpp"
+
+namespace kuka_controllers
+{
+void JitterBuffer::configure(std::size_t capacity, std::size_t dof)
+{
+  capacity_ = std::max<std::size_t>(capacity, 2);
+  dof_ = dof;
+  stamps_.assign(capacity_, 0);
+  positions_.assign(capacity_ * dof_, 0.0);
+  previous_positions_.assign(dof_, 0.0);
+  clear();
+}
+
+void JitterBuffer::clear()
+{
+  begin_ = 0;
+  size_ = 0;
+  playback_time_ = 0;
+  started_ = false;
+  has_previous_ = false;
+}
+
+JitterBuffer::InsertResult JitterBuffer::insert(int64_t stamp, const double * positions)
+{
+  if (started_ && stamp <= playback_time_)
+  {
+    return InsertResult::LATE;
+  }
+
+  // Setpoints usually arrive in order, so the search starts from the back
+  std::size_t index = size_;
+  while (index > 0 && stamps_[slot(index - 1)] > stamp)
+  {
+    --index;
+  }
+  if (index > 0 && stamps_[slot(index - 1)] == stamp)
+  {
+    // Setpoint was sent again, the new values replace the old ones
+    std::copy(positions, positions + dof_, this->positions(index - 1));
+    return InsertResult::INSERTED;
+  }
+
+  InsertResult result = InsertResult::INSERTED;
+  if (size_ == capacity_)
+  {
+    if (index == 0)
+    {
+      // The new setpoint would be the oldest one
+      return InsertResult::OVERFLOWED;
+    }
+    popFront();
+    --index;
+    result = InsertResult::OVERFLOWED;
+  }
+
+  for (std::size_t i = size_; i > index; --i)
+  {
+    stamps_[slot(i)] = stamps_[slot(i - 1)];
+    std::copy(this->positions(i - 1), this->positions(i - 1) + dof_, this->positions(i));
+  }
+  stamps_[slot(index)] = stamp;
+  std::copy(positions, positions + dof_, this->positions(index));
+  ++size_;
+  return result;
+}
+
+JitterBuffer::SampleResult JitterBuffer::sample(
+  int64_t time, int64_t max_extrapolation, double max_velocity, double * output)
+{
+  playback_time_ = time;
+  started_ = true;
+
+  // Keep the newest setpoint that is not after the playback time at the front
+  while (size_ >= 2 && stamps_[slot(1)] <= time)
+  {
+    popFront();
+  }
+  if (size_ == 0 || time < stamps_[slot(0)])
+  {
+    return SampleResult::EMPTY;
+  }
+
+  const int64_t t0 = stamps_[slot(0)];
+  const double * p0 = positions(0);
+  if (size_ >= 2)
+  {
+    const double * p1 = positions(1);
+    const double ratio =
+      static_cast<double>(time - t0) / static_cast<double>(stamps_[slot(1)] - t0);
+    for (std::size_t j = 0; j < dof_; ++j)
+    {
+      output[j] = p0[j] + ratio * (p1[j] - p0[j]);
+    }
+    return SampleResult::INTERPOLATED;
+  }
+  if (time == t0)
+  {
+    std::copy(p0, p0 + dof_, output);
+    return SampleResult::INTERPOLATED;
+  }
+
+  if (!has_previous_)
+  {
+    std::copy(p0, p0 + dof_, output);
+    return SampleResult::HELD;
+  }
+
+  // Continue with the velocity of the last segment
+  const double segment = static_cast<double>(t0 - previous_stamp_) * 1e-9;
+  const double elapsed = static_cast<double>(std::min(time - t0, max_extrapolation)) * 1e-9;
+  for (std::size_t j = 0; j < dof_; ++j)
+  {
+    const double velocity =
+      std::clamp((p0[j] - previous_positions_[j]) / segment, -max_velocity, max_velocity);
+    output[j] = p0[j] + velocity * elapsed;
+  }
+  return time - t0 <= max_extrapolation ? SampleResult::EXTRAPOLATED : SampleResult::HELD;
+}
+
+std::size_t JitterBuffer::depth() const
+{
+  std::size_t depth = 0;
+  while (depth < size_ && stamps_[slot(size_ - depth - 1)] > playback_time_)
+  {
+    ++depth;
+  }
+  return depth;
+}
+
+void JitterBuffer::popFront()
+{
+  previous_stamp_ = stamps_[slot(0)];
+  std::copy(positions(0), positions(0) + dof_, previous_positions_.begin());
+  has_previous_ = true;
+  begin_ = slot(1);
+  --size_;
+}
+}  // namespace kuka_controllers
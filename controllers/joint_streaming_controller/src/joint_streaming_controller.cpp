@@ -0,0 +1,225 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+
+#include "joint_streaming_controller/joint_streaming_controller.hpp"
+
+namespace kuka_controllers
+{
+controller_interface::CallbackReturn JointStreamingController::on_init()
+{
+  try
+  {
+    param_listener_ = std::make_shared<ParamListener>(get_node());
+    params_ = param_listener_->get_params();
+  }
+  catch (const std::exception & e)
+  {
+    fprintf(stderr, "Exception thrown during init stage with message: %s \n", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::InterfaceConfiguration
+JointStreamingController::command_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_POSITION);
+  }
+  return config;
+}
+
+controller_interface::InterfaceConfiguration
+JointStreamingController::state_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_POSITION);
+  }
+  return config;
+}
+
+controller_interface::CallbackReturn JointStreamingController::on_configure(
+  const rclcpp_lifecycle::State &)
+{
+  params_ = param_listener_->get_params();
+  if (params_.joints.empty())
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "'joints' parameter is empty");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+
+  use_arrival_stamps_ = params_.timestamp_source == "arrival";
+  latency_ns_ = rclcpp::Duration::from_seconds(params_.latency).nanoseconds();
+  max_extrapolation_ns_ =
+    rclcpp::Duration::from_seconds(params_.max_extrapolation_time).nanoseconds();
+
+  const auto capacity = static_cast<std::size_t>(params_.buffer_capacity);
+  setpoint_subscriber_.reset();
+  setpoint_queue_.configure(capacity, params_.joints.size());
+  jitter_buffer_.configure(capacity, params_.joints.size());
+  positions_.assign(params_.joints.size(), 0.0);
+
+  setpoint_subscriber_ =
+    get_node()->create_subscription<kuka_driver_interfaces::msg::JointSetpoint>(
+      "~/setpoints", rclcpp::SensorDataQoS(),
+      [this](const kuka_driver_interfaces::msg::JointSetpoint::SharedPtr msg) { onSetpoint(msg); });
+
+  statistics_publisher_ =
+    get_node()->create_publisher<kuka_driver_interfaces::msg::StreamingStatistics>(
+      "~/statistics", rclcpp::SystemDefaultsQoS());
+  rt_statistics_publisher_ = std::make_unique<
+    realtime_tools::RealtimePublisher<kuka_driver_interfaces::msg::StreamingStatistics>>(
+    statistics_publisher_);
+
+  RCLCPP_INFO(
+    get_node()->get_logger(), "Joint streaming controller configured with %.1f ms latency",
+    params_.latency * 1000);
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn JointStreamingController::on_activate(
+  const rclcpp_lifecycle::State &)
+{
+  // Hold the actual position until the first setpoint is reached
+  for (std::size_t i = 0; i < params_.joints.size(); ++i)
+  {
+    command_interfaces_[i].set_value(state_interfaces_[i].get_value());
+  }
+
+  // Setpoints received before activation are discarded
+  while (setpoint_queue_.front() != nullptr)
+  {
+    setpoint_queue_.pop();
+  }
+  jitter_buffer_.clear();
+  underrun_ = false;
+  received_ = 0;
+  underruns_ = 0;
+  late_drops_ = 0;
+  overflow_drops_ = 0;
+  queue_overflows_ = 0;
+  last_statistics_ns_ = 0;
+  accept_setpoints_ = true;
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn JointStreamingController::on_deactivate(
+  const rclcpp_lifecycle::State &)
+{
+  accept_setpoints_ = false;
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::return_type JointStreamingController::update(
+  const rclcpp::Time & time, const rclcpp::Duration &)
+{
+  while (const SetpointQueue::Setpoint * setpoint = setpoint_queue_.front())
+  {
+    ++received_;
+    switch (jitter_buffer_.insert(setpoint->stamp, setpoint->positions.data()))
+    {
+      case JitterBuffer::InsertResult::LATE:
+        ++late_drops_;
+        break;
+      case JitterBuffer::InsertResult::OVERFLOWED:
+        ++overflow_drops_;
+        break;
+      case JitterBuffer::InsertResult::INSERTED:
+        break;
+    }
+    setpoint_queue_.pop();
+  }
+
+  const auto result = jitter_buffer_.sample(
+    time.nanoseconds() - latency_ns_, max_extrapolation_ns_, params_.max_extrapolation_velocity,
+    positions_.data());
+  if (result != JitterBuffer::SampleResult::EMPTY)
+  {
+    // Count every period without new setpoints only once
+    const bool underrun = result != JitterBuffer::SampleResult::INTERPOLATED;
+    if (underrun && !underrun_)
+    {
+      ++underruns_;
+    }
+    underrun_ = underrun;
+
+    for (std::size_t i = 0; i < positions_.size(); ++i)
+    {
+      command_interfaces_[i].set_value(positions_[i]);
+    }
+  }
+
+  publishStatistics(time);
+  return controller_interface::return_type::OK;
+}
+
+void JointStreamingController::publishStatistics(const rclcpp::Time & time)
+{
+  if (
+    params_.statistics_publish_rate <= 0 ||
+    static_cast<double>(time.nanoseconds() - last_statistics_ns_) * 1e-9 <
+      1.0 / params_.statistics_publish_rate)
+  {
+    return;
+  }
+
+  if (rt_statistics_publisher_->trylock())
+  {
+    auto & msg = rt_statistics_publisher_->msg_;
+    msg.header.stamp = time;
+    msg.buffer_depth = static_cast<uint32_t>(jitter_buffer_.depth());
+    msg.received = received_;
+    msg.underruns = underruns_;
+    msg.late_drops = late_drops_;
+    msg.overflow_drops = overflow_drops_ + queue_overflows_.load();
+    rt_statistics_publisher_->unlockAndPublish();
+    last_statistics_ns_ = time.nanoseconds();
+  }
+}
+
+void JointStreamingController::onSetpoint(
+  const kuka_driver_interfaces::msg::JointSetpoint::SharedPtr msg)
+{
+  if (!accept_setpoints_)
+  {
+    return;
+  }
+  if (msg->positions.size() != params_.joints.size())
+  {
+    RCLCPP_ERROR_THROTTLE(
+      get_node()->get_logger(), *get_node()->get_clock(), 1000,
+      "Setpoint must contain %zu positions, ignoring it", params_.joints.size());
+    return;
+  }
+
+  const int64_t stamp = use_arrival_stamps_
+                          ? get_node()->now().nanoseconds()
+                          : rclcpp::Time(msg->header.stamp).nanoseconds();
+  if (!setpoint_queue_.push(stamp, msg->positions))
+  {
+    ++queue_overflows_;
+  }
+}
+}  // namespace kuka_controllers
+
+PLUGINLIB_EXPORT_CLASS(
+  kuka_controllers::JointStreamingController, controller_interface::ControllerInterface)
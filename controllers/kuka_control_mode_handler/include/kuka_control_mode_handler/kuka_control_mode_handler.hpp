@@ -21,6 +21,8 @@
 
 #include "controller_interface/controller_interface.hpp"
 #include "kuka_drivers_core/control_mode.hpp"
+#include "kuka_drivers_core/timing_diagnostics.hpp"
+#include "kuka_drivers_core/update_timer.hpp"
 #include "pluginlib/class_list_macros.hpp"
 #include "rclcpp/duration.hpp"
 #include "rclcpp/time.hpp"
@@ -54,6 +56,8 @@ public:
   KUKA_CONTROL_MODE_HANDLER_PUBLIC controller_interface::CallbackReturn on_init() override;
 
 private:
+  kuka_drivers_core::UpdateTimer update_timer_;
+  std::unique_ptr<kuka_drivers_core::TimingDiagnostics> timing_diagnostics_;
   rclcpp::Subscription<std_msgs::msg::UInt32>::SharedPtr control_mode_subscriber_;
   kuka_drivers_core::ControlMode control_mode_ =
     kuka_drivers_core::ControlMode::CONTROL_MODE_UNSPECIFIED;
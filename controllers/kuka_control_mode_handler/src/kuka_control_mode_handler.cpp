@@ -20,6 +20,7 @@ namespace kuka_controllers
 {
 controller_interface::CallbackReturn ControlModeHandler::on_init()
 {
+  kuka_drivers_core::TimingDiagnostics::declareParameters(get_node(), true);
   return controller_interface::CallbackReturn::SUCCESS;
 }
 
@@ -52,6 +53,8 @@ controller_interface::CallbackReturn ControlModeHandler::on_configure(
       RCLCPP_INFO(get_node()->get_logger(), "Control mode changed to %u", msg->data);
     });
   RCLCPP_INFO(get_node()->get_logger(), "Control mode handler configured");
+  timing_diagnostics_ =
+    std::make_unique<kuka_drivers_core::TimingDiagnostics>(get_node(), update_timer_);
   return controller_interface::CallbackReturn::SUCCESS;
 }
 
@@ -75,7 +78,13 @@ controller_interface::CallbackReturn ControlModeHandler::on_deactivate(
 controller_interface::return_type ControlModeHandler::update(
   const rclcpp::Time &, const rclcpp::Duration &)
 {
+  if (!update_timer_.start())
+  {
+    return controller_interface::return_type::OK;
+  }
+
   command_interfaces_[0].set_value(static_cast<double>(control_mode_));
+  update_timer_.stop();
   return controller_interface::return_type::OK;
 }
 
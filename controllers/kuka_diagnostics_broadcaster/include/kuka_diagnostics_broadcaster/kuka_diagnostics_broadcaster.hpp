@@ -0,0 +1,113 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef KUKA_DIAGNOSTICS_BROADCASTER__KUKA_DIAGNOSTICS_BROADCASTER_HPP_
+#define KUKA_DIAGNOSTICS_BROADCASTER__KUKA_DIAGNOSTICS_BROADCASTER_HPP_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "controller_interface/controller_interface.hpp"
+#include "diagnostic_msgs/msg/diagnostic_array.hpp"
+#include "kuka_drivers_core/timing_diagnostics.hpp"
+#include "kuka_drivers_core/update_timer.hpp"
+#include "pluginlib/class_list_macros.hpp"
+#include "rclcpp/duration.hpp"
+#include "rclcpp/time.hpp"
+
+#include "kuka_diagnostics_broadcaster/visibility_control.h"
+#include "kuka_diagnostics_broadcaster_parameters.hpp"
+
+namespace kuka_controllers
+{
+/**
+ * @brief Broadcaster publishing the health of KUKA drivers on the /diagnostics topic
+ *
+ * Every hardware component has its own diagnostic status. The health state interfaces are read in
+ *  every cycle and their statistics are collected over the publish period without allocation. The
+ *  statistics of a finished period are handed over to a timer of the controller node, which
+ *  evaluates and publishes them outside of the control loop.
+ */
+class DiagnosticsBroadcaster : public controller_interface::ControllerInterface
+{
+public:
+  KUKA_DIAGNOSTICS_BROADCASTER_PUBLIC controller_interface::InterfaceConfiguration
+  command_interface_configuration() const override;
+
+  KUKA_DIAGNOSTICS_BROADCASTER_PUBLIC controller_interface::InterfaceConfiguration
+  state_interface_configuration() const override;
+
+  KUKA_DIAGNOSTICS_BROADCASTER_PUBLIC controller_interface::return_type update(
+    const rclcpp::Time & time, const rclcpp::Duration & period) override;
+
+  KUKA_DIAGNOSTICS_BROADCASTER_PUBLIC controller_interface::CallbackReturn on_configure(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  KUKA_DIAGNOSTICS_BROADCASTER_PUBLIC controller_interface::CallbackReturn on_activate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  KUKA_DIAGNOSTICS_BROADCASTER_PUBLIC controller_interface::CallbackReturn on_deactivate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  KUKA_DIAGNOSTICS_BROADCASTER_PUBLIC controller_interface::CallbackReturn on_init() override;
+
+private:
+  // Statistics of a state interface in one publish period
+  struct Statistics
+  {
+    double first = 0;
+    double last = 0;
+    double min = 0;
+    double max = 0;
+    double sum = 0;
+    uint64_t count = 0;
+  };
+
+  KUKA_DIAGNOSTICS_BROADCASTER_LOCAL void publish();
+
+  // Updates the diagnostic status of a hardware component from the statistics of all components
+  KUKA_DIAGNOSTICS_BROADCASTER_LOCAL void evaluate(
+    std::size_t component, const std::vector<Statistics> & statistics);
+
+  using Params = kuka_diagnostics_broadcaster::Params;
+  using ParamListener = kuka_diagnostics_broadcaster::ParamListener;
+
+  std::shared_ptr<ParamListener> param_listener_;
+  Params params_;
+
+  kuka_drivers_core::UpdateTimer update_timer_;
+  std::unique_ptr<kuka_drivers_core::TimingDiagnostics> timing_diagnostics_;
+
+  // Written only by the control loop, the interfaces of every hardware component in a row
+  std::vector<Statistics> period_statistics_;
+  int64_t period_start_ns_ = 0;
+  int64_t period_ns_ = 0;
+
+  // Last finished period, handed over to the publisher timer
+  std::mutex statistics_mutex_;
+  std::vector<Statistics> finished_statistics_;
+  bool has_finished_statistics_ = false;
+
+  // Missed cycles of the hardware components at the end of the previous period, negative before
+  //  the first period
+  std::vector<double> previous_missed_cycles_;
+
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr diagnostics_publisher_;
+  rclcpp::TimerBase::SharedPtr publish_timer_;
+  diagnostic_msgs::msg::DiagnosticArray diagnostics_msg_;
+};
+}  // namespace kuka_controllers
+#endif  // KUKA_DIAGNOSTICS_BROADCASTER__KUKA_DIAGNOSTICS_BROADCASTER_HPP_
@@ -0,0 +1,287 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "kuka_drivers_core/hardware_event.hpp"
+#include "kuka_drivers_core/hardware_interface_types.hpp"
+
+#include "kuka_diagnostics_broadcaster/kuka_diagnostics_broadcaster.hpp"
+
+namespace kuka_controllers
+{
+controller_interface::CallbackReturn DiagnosticsBroadcaster::on_init()
+{
+  kuka_drivers_core::TimingDiagnostics::declareParameters(get_node(), false);
+  try
+  {
+    param_listener_ = std::make_shared<ParamListener>(get_node());
+    params_ = param_listener_->get_params();
+  }
+  catch (const std::exception & e)
+  {
+    fprintf(stderr, "Exception thrown during init stage with message: %s \n", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::InterfaceConfiguration
+DiagnosticsBroadcaster::command_interface_configuration() const
+{
+  return controller_interface::InterfaceConfiguration{
+    controller_interface::interface_configuration_type::NONE};
+}
+
+controller_interface::InterfaceConfiguration
+DiagnosticsBroadcaster::state_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & component : params_.hardware_components)
+  {
+    for (const auto & interface : params_.interfaces)
+    {
+      // The server state is shared with the event broadcaster
+      const std::string prefix = interface == hardware_interface::SERVER_STATE
+                                   ? std::string(hardware_interface::STATE_PREFIX)
+                                   : component;
+      config.names.emplace_back(prefix + "/" + interface);
+    }
+  }
+  return config;
+}
+
+controller_interface::CallbackReturn DiagnosticsBroadcaster::on_configure(
+  const rclcpp_lifecycle::State &)
+{
+  params_ = param_listener_->get_params();
+  if (params_.interfaces.empty())
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "'interfaces' parameter is empty");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  if (params_.hardware_components.empty())
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "'hardware_components' parameter is empty");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  timing_diagnostics_ =
+    std::make_unique<kuka_drivers_core::TimingDiagnostics>(get_node(), update_timer_);
+
+  period_ns_ = static_cast<int64_t>(1e9 / params_.publish_rate);
+  const std::size_t components = params_.hardware_components.size();
+  period_statistics_.assign(components * params_.interfaces.size(), Statistics());
+  finished_statistics_.assign(period_statistics_.size(), Statistics());
+  previous_missed_cycles_.assign(components, -1);
+
+  diagnostics_msg_.status.resize(components);
+  for (std::size_t c = 0; c < components; ++c)
+  {
+    auto & status = diagnostics_msg_.status[c];
+    status.name = std::string(get_node()->get_name()) + ": " + params_.hardware_components[c] +
+                  " health";
+    status.hardware_id = params_.hardware_components[c];
+  }
+
+  diagnostics_publisher_ = get_node()->create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+    "/diagnostics", rclcpp::SystemDefaultsQoS());
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn DiagnosticsBroadcaster::on_activate(
+  const rclcpp_lifecycle::State &)
+{
+  std::fill(period_statistics_.begin(), period_statistics_.end(), Statistics());
+  period_start_ns_ = 0;
+  {
+    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    has_finished_statistics_ = false;
+  }
+  std::fill(previous_missed_cycles_.begin(), previous_missed_cycles_.end(), -1);
+  publish_timer_ = get_node()->create_wall_timer(
+    std::chrono::nanoseconds(period_ns_), [this]() { publish(); });
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn DiagnosticsBroadcaster::on_deactivate(
+  const rclcpp_lifecycle::State &)
+{
+  publish_timer_.reset();
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::return_type DiagnosticsBroadcaster::update(
+  const rclcpp::Time & time, const rclcpp::Duration &)
+{
+  if (!update_timer_.start())
+  {
+    return controller_interface::return_type::OK;
+  }
+
+  for (std::size_t i = 0; i < period_statistics_.size(); ++i)
+  {
+    const double value = state_interfaces_[i].get_value();
+    auto & statistics = period_statistics_[i];
+    if (statistics.count == 0)
+    {
+      statistics.first = value;
+      statistics.min = value;
+      statistics.max = value;
+    }
+    statistics.last = value;
+    statistics.min = std::min(statistics.min, value);
+    statistics.max = std::max(statistics.max, value);
+    statistics.sum += value;
+    statistics.count++;
+  }
+
+  if (period_start_ns_ == 0)
+  {
+    period_start_ns_ = time.nanoseconds();
+  }
+  else if (time.nanoseconds() - period_start_ns_ >= period_ns_)
+  {
+    // The period is extended if the publisher is busy, so no cycles are lost
+    std::unique_lock<std::mutex> lock(statistics_mutex_, std::try_to_lock);
+    if (lock.owns_lock())
+    {
+      std::copy(
+        period_statistics_.begin(), period_statistics_.end(), finished_statistics_.begin());
+      has_finished_statistics_ = true;
+      lock.unlock();
+      std::fill(period_statistics_.begin(), period_statistics_.end(), Statistics());
+      period_start_ns_ = time.nanoseconds();
+    }
+  }
+
+  update_timer_.stop();
+  return controller_interface::return_type::OK;
+}
+
+void DiagnosticsBroadcaster::publish()
+{
+  std::vector<Statistics> statistics;
+  {
+    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    if (!has_finished_statistics_)
+    {
+      return;
+    }
+    statistics = finished_statistics_;
+    has_finished_statistics_ = false;
+  }
+
+  for (std::size_t c = 0; c < diagnostics_msg_.status.size(); ++c)
+  {
+    evaluate(c, statistics);
+  }
+
+  diagnostics_msg_.header.stamp = get_node()->now();
+  diagnostics_publisher_->publish(diagnostics_msg_);
+}
+
+void DiagnosticsBroadcaster::evaluate(
+  std::size_t component, const std::vector<Statistics> & statistics)
+{
+  auto & status = diagnostics_msg_.status[component];
+  double & previous_missed_cycles = previous_missed_cycles_[component];
+  status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+  status.message.clear();
+  status.values.clear();
+  auto report = [&status](unsigned char level, const std::string & message)
+  {
+    status.level = std::max(status.level, level);
+    status.message += (status.message.empty() ? "" : ", ") + message;
+  };
+  auto add_value = [&status](const std::string & key, double value)
+  {
+    diagnostic_msgs::msg::KeyValue key_value;
+    key_value.key = key;
+    key_value.value = std::to_string(value);
+    status.values.push_back(key_value);
+  };
+
+  const std::size_t interfaces = params_.interfaces.size();
+  for (std::size_t i = 0; i < interfaces; ++i)
+  {
+    const std::string & name = params_.interfaces[i];
+    const auto & values = statistics[component * interfaces + i];
+    if (values.count == 0)
+    {
+      continue;
+    }
+
+    if (name == hardware_interface::SERVER_STATE)
+    {
+      add_value(name, values.last);
+      if (
+        static_cast<kuka_drivers_core::HardwareEvent>(static_cast<int>(values.last)) ==
+        kuka_drivers_core::HardwareEvent::ERROR)
+      {
+        report(diagnostic_msgs::msg::DiagnosticStatus::ERROR, "Robot controller reported an error");
+      }
+    }
+    else if (name == hardware_interface::MISSED_CYCLES)
+    {
+      // The interface counts since activation
+      const double missed =
+        values.last - (previous_missed_cycles >= 0 ? previous_missed_cycles : values.first);
+      previous_missed_cycles = values.last;
+      add_value(name, values.last);
+      add_value(name + " in period", missed);
+      if (missed > 0)
+      {
+        report(
+          diagnostic_msgs::msg::DiagnosticStatus::WARN,
+          std::to_string(static_cast<uint64_t>(missed)) + " cycles missed");
+      }
+    }
+    else
+    {
+      add_value(name + " last", values.last);
+      add_value(name + " min", values.min);
+      add_value(name + " max", values.max);
+      add_value(name + " mean", values.sum / static_cast<double>(values.count));
+      if (name == hardware_interface::CONNECTION_QUALITY)
+      {
+        if (values.min < params_.connection_quality_error)
+        {
+          report(diagnostic_msgs::msg::DiagnosticStatus::ERROR, "Connection quality is bad");
+        }
+        else if (values.min < params_.connection_quality_warning)
+        {
+          report(diagnostic_msgs::msg::DiagnosticStatus::WARN, "Connection quality is degraded");
+        }
+      }
+      else if (
+        name == hardware_interface::RECEIVE_PERIOD && params_.max_receive_period > 0 &&
+        values.max > params_.max_receive_period)
+      {
+        report(diagnostic_msgs::msg::DiagnosticStatus::WARN, "Receive period exceeded");
+      }
+    }
+  }
+  if (status.message.empty())
+  {
+    status.message = "Connection healthy";
+  }
+}
+}  // namespace kuka_controllers
+
+PLUGINLIB_EXPORT_CLASS(
+  kuka_controllers::DiagnosticsBroadcaster, controller_interface::ControllerInterface)
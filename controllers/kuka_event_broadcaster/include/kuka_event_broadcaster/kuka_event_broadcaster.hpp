@@ -20,6 +20,8 @@
 #include <vector>
 
 #include "controller_interface/controller_interface.hpp"
+#include "kuka_drivers_core/timing_diagnostics.hpp"
+#include "kuka_drivers_core/update_timer.hpp"
 #include "pluginlib/class_list_macros.hpp"
 #include "rclcpp/duration.hpp"
 #include "rclcpp/time.hpp"
@@ -53,6 +55,8 @@ public:
   KUKA_EVENT_BROADCASTER_PUBLIC controller_interface::CallbackReturn on_init() override;
 
 private:
+  kuka_drivers_core::UpdateTimer update_timer_;
+  std::unique_ptr<kuka_drivers_core::TimingDiagnostics> timing_diagnostics_;
   rclcpp::Publisher<std_msgs::msg::UInt8>::SharedPtr event_publisher_;
   std_msgs::msg::UInt8 event_msg_;
   int last_event_ = 0;
@@ -20,6 +20,7 @@ namespace kuka_controllers
 {
 controller_interface::CallbackReturn EventBroadcaster::on_init()
 {
+  kuka_drivers_core::TimingDiagnostics::declareParameters(get_node(), false);
   event_publisher_ = get_node()->create_publisher<std_msgs::msg::UInt8>(
     "~/hardware_event", rclcpp::SystemDefaultsQoS());
   return controller_interface::CallbackReturn::SUCCESS;
@@ -43,6 +44,8 @@ controller_interface::InterfaceConfiguration EventBroadcaster::state_interface_c
 
 controller_interface::CallbackReturn EventBroadcaster::on_configure(const rclcpp_lifecycle::State &)
 {
+  timing_diagnostics_ =
+    std::make_unique<kuka_drivers_core::TimingDiagnostics>(get_node(), update_timer_);
   return controller_interface::CallbackReturn::SUCCESS;
 }
 
@@ -60,6 +63,11 @@ controller_interface::CallbackReturn EventBroadcaster::on_deactivate(
 controller_interface::return_type EventBroadcaster::update(
   const rclcpp::Time &, const rclcpp::Duration &)
 {
+  if (!update_timer_.start())
+  {
+    return controller_interface::return_type::OK;
+  }
+
   auto current_event = static_cast<uint8_t>(state_interfaces_[0].get_value());
   if (current_event != last_event_)
   {
@@ -67,6 +75,7 @@ controller_interface::return_type EventBroadcaster::update(
     event_publisher_->publish(event_msg_);
     last_event_ = current_event;
   }
+  update_timer_.stop();
   return controller_interface::return_type::OK;
 }
 }  // namespace kuka_controllers
@@ -0,0 +1,134 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI_ROBOT_SYNCHRONIZER__MULTI_ROBOT_SYNCHRONIZER_HPP_
+#define MULTI_ROBOT_SYNCHRONIZER__MULTI_ROBOT_SYNCHRONIZER_HPP_
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "controller_interface/controller_interface.hpp"
+#include "kuka_driver_interfaces/msg/synchronization_state.hpp"
+#include "pluginlib/class_list_macros.hpp"
+#include "rclcpp/duration.hpp"
+#include "rclcpp/time.hpp"
+#include "realtime_tools/realtime_buffer.h"
+#include "realtime_tools/realtime_publisher.h"
+#include "trajectory_msgs/msg/joint_trajectory.hpp"
+
+#include "multi_robot_synchronizer/synchronized_trajectory.hpp"
+#include "multi_robot_synchronizer/visibility_control.h"
+#include "multi_robot_synchronizer_parameters.hpp"
+
+namespace kuka_controllers
+{
+/**
+ * @brief Controller executing a joint trajectory of several robots on a common time base
+ *
+ * All robots must be claimed by the controller manager running this controller. The controllers
+ *  of the robots run with their own clocks, so the state received in a control cycle was measured
+ *  at a different time for every robot. The times of the states mapped to ROS time (or the
+ *  controller times, if the clocks of the controllers are synchronized) are used to measure this
+ *  phase offset on a common time base and to estimate the cycle time of every robot, and every
+ *  robot gets the setpoint belonging to the time its controller executes it, instead of the time
+ *  of the control cycle.
+ */
+class MultiRobotSynchronizer : public controller_interface::ControllerInterface
+{
+public:
+  MULTI_ROBOT_SYNCHRONIZER_PUBLIC controller_interface::InterfaceConfiguration
+  command_interface_configuration() const override;
+
+  MULTI_ROBOT_SYNCHRONIZER_PUBLIC controller_interface::InterfaceConfiguration
+  state_interface_configuration() const override;
+
+  MULTI_ROBOT_SYNCHRONIZER_PUBLIC controller_interface::return_type update(
+    const rclcpp::Time & time, const rclcpp::Duration & period) override;
+
+  MULTI_ROBOT_SYNCHRONIZER_PUBLIC controller_interface::CallbackReturn on_configure(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  MULTI_ROBOT_SYNCHRONIZER_PUBLIC controller_interface::CallbackReturn on_activate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  MULTI_ROBOT_SYNCHRONIZER_PUBLIC controller_interface::CallbackReturn on_deactivate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  MULTI_ROBOT_SYNCHRONIZER_PUBLIC controller_interface::CallbackReturn on_init() override;
+
+private:
+  struct Robot
+  {
+    std::string name;
+    // Range of the robot in the joints of the controller
+    std::size_t first_joint = 0;
+    std::size_t joint_count = 0;
+    bool use_timestamp = false;
+    std::size_t timestamp_index = 0;
+
+    double last_timestamp = 0;
+    // Estimated difference between the clock of the robot and the controller clock, only used with
+    //  synchronized clocks [s]
+    double clock_offset = 0;
+    double cycle_time = 0;
+    bool has_timing = false;
+    // Time of the last state relative to the control cycle [s]
+    double phase = 0;
+  };
+
+  MULTI_ROBOT_SYNCHRONIZER_LOCAL void onTrajectory(
+    const trajectory_msgs::msg::JointTrajectory::SharedPtr msg);
+  MULTI_ROBOT_SYNCHRONIZER_LOCAL void updateTiming(double now, double period);
+  MULTI_ROBOT_SYNCHRONIZER_LOCAL void publishState(const rclcpp::Time & time);
+
+  using Params = multi_robot_synchronizer::Params;
+  using ParamListener = multi_robot_synchronizer::ParamListener;
+
+  std::shared_ptr<ParamListener> param_listener_;
+  Params params_;
+
+  std::vector<Robot> robots_;
+  std::vector<std::string> joints_;
+  std::size_t timestamp_count_ = 0;
+
+  rclcpp::Subscription<trajectory_msgs::msg::JointTrajectory>::SharedPtr trajectory_subscriber_;
+  std::atomic<bool> accept_trajectories_{false};
+
+  // Trajectories are owned by the non-realtime side until the control loop moved past them
+  std::mutex mutex_;
+  std::deque<std::unique_ptr<SynchronizedTrajectory>> trajectories_;
+  uint64_t next_trajectory_id_ = 1;
+  realtime_tools::RealtimeBuffer<SynchronizedTrajectory *> trajectory_buffer_;
+  std::atomic<uint64_t> active_trajectory_id_{0};
+
+  SynchronizedTrajectory * active_trajectory_ = nullptr;
+  int64_t trajectory_start_ns_ = 0;
+  std::vector<double> commands_;
+
+  double skew_ = 0;
+  double max_skew_ = 0;
+
+  std::shared_ptr<rclcpp::Publisher<kuka_driver_interfaces::msg::SynchronizationState>>
+    state_publisher_;
+  std::unique_ptr<
+    realtime_tools::RealtimePublisher<kuka_driver_interfaces::msg::SynchronizationState>>
+    rt_state_publisher_;
+  int64_t last_state_ns_ = 0;
+};
+}  // namespace kuka_controllers
+#endif  // MULTI_ROBOT_SYNCHRONIZER__MULTI_ROBOT_SYNCHRONIZER_HPP_
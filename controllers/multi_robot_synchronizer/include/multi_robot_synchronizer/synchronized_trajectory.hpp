@@ -0,0 +1,91 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI_ROBOT_SYNCHRONIZER__SYNCHRONIZED_TRAJECTORY_HPP_
+#define MULTI_ROBOT_SYNCHRONIZER__SYNCHRONIZED_TRAJECTORY_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "trajectory_msgs/msg/joint_trajectory.hpp"
+
+namespace kuka_controllers
+{
+/**
+ * @brief Joint trajectory of all synchronized robots on a common time base
+ *
+ * The first point is reserved for the positions at the start, which are set by the control loop
+ *  when it takes over the trajectory. Memory is allocated only in assign(), the other methods can
+ *  be called from the control loop.
+ */
+class SynchronizedTrajectory
+{
+public:
+  /**
+   * @brief Stores the points of the message in the order of the given joints
+   *
+   * @param msg: Trajectory containing all joints, with increasing, positive point times
+   * @param joints: Joints of all robots
+   * @param error: Reason of the failure
+   * @return false if the message is not a valid trajectory of the joints
+   */
+  bool assign(
+    const trajectory_msgs::msg::JointTrajectory & msg, const std::vector<std::string> & joints,
+    std::string & error);
+
+  /**
+   * @brief Sets the positions at the start of the trajectory
+   *
+   * @param positions: Array with the positions of all joints
+   */
+  void setStartPositions(const double * positions);
+
+  /**
+   * @brief Calculates the positions of a range of joints at the given time
+   *
+   * The points are interpolated with cubic Hermite splines if the message contained velocities,
+   *  otherwise linearly. Before the start the start positions, after the end the last positions
+   *  are returned.
+   *
+   * @param time: Time since the start of the trajectory [s]
+   * @param first_joint: Index of the first joint of the range
+   * @param joint_count: Number of joints in the range
+   * @param output: Array for the positions of the range
+   */
+  void sample(
+    double time, std::size_t first_joint, std::size_t joint_count, double * output) const;
+
+  // Requested start in nanoseconds of the controller clock, zero to start immediately
+  int64_t startTime() const { return start_time_; }
+
+  double duration() const { return times_.empty() ? 0.0 : times_.back(); }
+
+  uint64_t id() const { return id_; }
+  void setId(uint64_t id) { id_ = id; }
+
+private:
+  std::size_t dof_ = 0;
+  // Time of the points since the start [s]
+  std::vector<double> times_;
+  // Positions and velocities of the points, stored point by point
+  std::vector<double> positions_;
+  std::vector<double> velocities_;
+  bool has_velocities_ = false;
+  int64_t start_time_ = 0;
+  uint64_t id_ = 0;
+};
+}  // namespace kuka_controllers
+
+#endif  // MULTI_ROBOT_SYNCHRONIZER__SYNCHRONIZED_TRAJECTORY_HPP_
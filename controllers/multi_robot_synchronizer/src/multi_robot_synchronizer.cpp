@@ -0,0 +1,340 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "kuka_drivers_core/hardware_interface_types.hpp"
+
+#include "multi_robot_synchronizer/multi_robot_synchronizer.hpp"
+
+namespace kuka_controllers
+{
+controller_interface::CallbackReturn MultiRobotSynchronizer::on_init()
+{
+  try
+  {
+    param_listener_ = std::make_shared<ParamListener>(get_node());
+    params_ = param_listener_->get_params();
+  }
+  catch (const std::exception & e)
+  {
+    fprintf(stderr, "Exception thrown during init stage with message: %s \n", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::InterfaceConfiguration
+MultiRobotSynchronizer::command_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & joint : joints_)
+  {
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_POSITION);
+  }
+  return config;
+}
+
+controller_interface::InterfaceConfiguration
+MultiRobotSynchronizer::state_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & joint : joints_)
+  {
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_POSITION);
+  }
+  // Timestamps follow the joint positions in the order of the robots. Without synchronized
+  //  controller clocks the states are compared in ROS time, the common time base of the robots
+  const char * timestamp =
+    params_.synchronized_clocks ? hardware_interface::TIMESTAMP : hardware_interface::ROS_TIMESTAMP;
+  for (const auto & robot : robots_)
+  {
+    if (robot.use_timestamp)
+    {
+      config.names.emplace_back(robot.name + "/" + timestamp);
+    }
+  }
+  return config;
+}
+
+controller_interface::CallbackReturn MultiRobotSynchronizer::on_configure(
+  const rclcpp_lifecycle::State &)
+{
+  params_ = param_listener_->get_params();
+  if (params_.robots.empty())
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "'robots' parameter is empty");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+
+  robots_.clear();
+  joints_.clear();
+  timestamp_count_ = 0;
+  for (const auto & name : params_.robots)
+  {
+    const auto & robot_params = params_.robot.robots_map.at(name);
+    if (robot_params.joints.empty())
+    {
+      RCLCPP_ERROR(get_node()->get_logger(), "'robot.%s.joints' parameter is empty", name.c_str());
+      return controller_interface::CallbackReturn::ERROR;
+    }
+    Robot robot;
+    robot.name = name;
+    robot.first_joint = joints_.size();
+    robot.joint_count = robot_params.joints.size();
+    robot.use_timestamp = robot_params.use_timestamp;
+    robots_.push_back(robot);
+    joints_.insert(joints_.end(), robot_params.joints.begin(), robot_params.joints.end());
+  }
+  // Timestamp interfaces are placed after all joints
+  for (auto & robot : robots_)
+  {
+    if (robot.use_timestamp)
+    {
+      robot.timestamp_index = joints_.size() + timestamp_count_++;
+    }
+  }
+  commands_.assign(joints_.size(), 0.0);
+
+  trajectory_subscriber_ = get_node()->create_subscription<trajectory_msgs::msg::JointTrajectory>(
+    "~/joint_trajectory", rclcpp::SystemDefaultsQoS(),
+    [this](const trajectory_msgs::msg::JointTrajectory::SharedPtr msg) { onTrajectory(msg); });
+
+  state_publisher_ =
+    get_node()->create_publisher<kuka_driver_interfaces::msg::SynchronizationState>(
+      "~/synchronization_state", rclcpp::SystemDefaultsQoS());
+  rt_state_publisher_ = std::make_unique<
+    realtime_tools::RealtimePublisher<kuka_driver_interfaces::msg::SynchronizationState>>(
+    state_publisher_);
+  // Allocate the message, so publishing does not allocate memory in the control loop
+  rt_state_publisher_->lock();
+  auto & msg = rt_state_publisher_->msg_;
+  msg.robots = params_.robots;
+  msg.timestamps.assign(robots_.size(), 0.0);
+  msg.phase_offsets.assign(robots_.size(), 0.0);
+  msg.cycle_times.assign(robots_.size(), 0.0);
+  rt_state_publisher_->unlock();
+
+  RCLCPP_INFO(
+    get_node()->get_logger(),
+    "Multi-robot synchronizer configured with %zu robots, %zu of them timestamped", robots_.size(),
+    timestamp_count_);
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn MultiRobotSynchronizer::on_activate(
+  const rclcpp_lifecycle::State &)
+{
+  // Hold the actual positions until the first trajectory arrives
+  for (std::size_t i = 0; i < joints_.size(); ++i)
+  {
+    commands_[i] = state_interfaces_[i].get_value();
+    command_interfaces_[i].set_value(commands_[i]);
+  }
+  for (auto & robot : robots_)
+  {
+    robot.last_timestamp = 0;
+    robot.clock_offset = 0;
+    robot.cycle_time = 0;
+    robot.has_timing = false;
+    robot.phase = 0;
+  }
+  skew_ = 0;
+  max_skew_ = 0;
+  last_state_ns_ = 0;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    trajectories_.clear();
+  }
+  active_trajectory_ = nullptr;
+  active_trajectory_id_.store(0);
+  trajectory_buffer_.writeFromNonRT(nullptr);
+  accept_trajectories_ = true;
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn MultiRobotSynchronizer::on_deactivate(
+  const rclcpp_lifecycle::State &)
+{
+  accept_trajectories_ = false;
+  trajectory_buffer_.writeFromNonRT(nullptr);
+  active_trajectory_ = nullptr;
+  std::lock_guard<std::mutex> lock(mutex_);
+  trajectories_.clear();
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::return_type MultiRobotSynchronizer::update(
+  const rclcpp::Time & time, const rclcpp::Duration & period)
+{
+  const double now = time.seconds();
+  updateTiming(now, period.seconds());
+
+  SynchronizedTrajectory * pending = *trajectory_buffer_.readFromRT();
+  if (
+    pending != nullptr &&
+    (active_trajectory_ == nullptr || pending->id() > active_trajectory_->id()))
+  {
+    // The new trajectory starts from the last setpoints, which replaces the active one smoothly
+    pending->setStartPositions(commands_.data());
+    trajectory_start_ns_ = pending->startTime() > 0 ? pending->startTime() : time.nanoseconds();
+    active_trajectory_ = pending;
+    active_trajectory_id_.store(pending->id());
+  }
+
+  if (active_trajectory_ != nullptr)
+  {
+    const double start = static_cast<double>(trajectory_start_ns_) * 1e-9;
+    for (const auto & robot : robots_)
+    {
+      // The setpoint is executed by the robot one of its cycles after its last state
+      const double robot_time = now + robot.phase + robot.cycle_time;
+      active_trajectory_->sample(
+        robot_time - start, robot.first_joint, robot.joint_count, &commands_[robot.first_joint]);
+    }
+  }
+
+  for (std::size_t i = 0; i < joints_.size(); ++i)
+  {
+    command_interfaces_[i].set_value(commands_[i]);
+  }
+
+  publishState(time);
+  return controller_interface::return_type::OK;
+}
+
+void MultiRobotSynchronizer::updateTiming(double now, double period)
+{
+  const double gain = params_.offset_filter_gain;
+  // With synchronized clocks the offset of the first timestamped robot is used for every robot,
+  //  so the phases also contain the offsets between the robots
+  const Robot * reference = nullptr;
+  for (auto & robot : robots_)
+  {
+    if (!robot.use_timestamp)
+    {
+      robot.phase = 0;
+      robot.cycle_time = period;
+      continue;
+    }
+
+    const double timestamp = state_interfaces_[robot.timestamp_index].get_value();
+    if (timestamp <= 0)
+    {
+      // No state received yet
+      robot.phase = 0;
+      robot.cycle_time = period;
+      continue;
+    }
+    if (!robot.has_timing)
+    {
+      robot.clock_offset = params_.synchronized_clocks ? timestamp - now : 0.0;
+      robot.cycle_time = period;
+      robot.has_timing = true;
+    }
+    else if (timestamp != robot.last_timestamp)
+    {
+      robot.cycle_time += gain * ((timestamp - robot.last_timestamp) - robot.cycle_time);
+      if (params_.synchronized_clocks)
+      {
+        robot.clock_offset += gain * ((timestamp - now) - robot.clock_offset);
+      }
+    }
+    robot.last_timestamp = timestamp;
+
+    // The ROS timestamps are already in the clock of the control loop, the constant offsets between
+    //  the robots remain in the phases
+    if (params_.synchronized_clocks && reference == nullptr)
+    {
+      reference = &robot;
+    }
+    const double clock_offset = params_.synchronized_clocks ? reference->clock_offset : 0.0;
+    robot.phase = timestamp - clock_offset - now;
+  }
+
+  double min_phase = std::numeric_limits<double>::max();
+  double max_phase = std::numeric_limits<double>::lowest();
+  for (const auto & robot : robots_)
+  {
+    min_phase = std::min(min_phase, robot.phase);
+    max_phase = std::max(max_phase, robot.phase);
+  }
+  skew_ = max_phase - min_phase;
+  max_skew_ = std::max(max_skew_, skew_);
+}
+
+void MultiRobotSynchronizer::publishState(const rclcpp::Time & time)
+{
+  if (
+    params_.state_publish_rate > 0 &&
+    static_cast<double>(time.nanoseconds() - last_state_ns_) * 1e-9 <
+      1.0 / params_.state_publish_rate)
+  {
+    return;
+  }
+
+  if (rt_state_publisher_->trylock())
+  {
+    auto & msg = rt_state_publisher_->msg_;
+    msg.header.stamp = time;
+    for (std::size_t i = 0; i < robots_.size(); ++i)
+    {
+      msg.timestamps[i] = robots_[i].last_timestamp;
+      msg.phase_offsets[i] = robots_[i].phase;
+      msg.cycle_times[i] = robots_[i].cycle_time;
+    }
+    msg.skew = skew_;
+    msg.max_skew = max_skew_;
+    rt_state_publisher_->unlockAndPublish();
+    last_state_ns_ = time.nanoseconds();
+  }
+}
+
+void MultiRobotSynchronizer::onTrajectory(
+  const trajectory_msgs::msg::JointTrajectory::SharedPtr msg)
+{
+  if (!accept_trajectories_)
+  {
+    return;
+  }
+
+  auto trajectory = std::make_unique<SynchronizedTrajectory>();
+  std::string error;
+  if (!trajectory->assign(*msg, joints_, error))
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "Rejected trajectory: %s", error.c_str());
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // The control loop only moves to newer trajectories, so the older ones can be freed
+  const uint64_t active_id = active_trajectory_id_.load();
+  while (!trajectories_.empty() && trajectories_.front()->id() < active_id)
+  {
+    trajectories_.pop_front();
+  }
+  trajectory->setId(next_trajectory_id_++);
+  trajectory_buffer_.writeFromNonRT(trajectory.get());
+  trajectories_.push_back(std::move(trajectory));
+}
+}  // namespace kuka_controllers
+
+PLUGINLIB_EXPORT_CLASS(
+  kuka_controllers::MultiRobotSynchronizer, controller_interface::ControllerInterface)
@@ -0,0 +1,133 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <iterator>
+
+#include "rclcpp/duration.hpp"
+#include "rclcpp/time.hpp"
+
+#include "multi_robot_synchronizer/synchronized_trajectory.hpp"
+
+namespace kuka_controllers
+{
+bool SynchronizedTrajectory::assign(
+  const trajectory_msgs::msg::JointTrajectory & msg, const std::vector<std::string> & joints,
+  std::string & error)
+{
+  // Index of every controlled joint in the message
+  std::vector<std::size_t> indices;
+  for (const auto & joint : joints)
+  {
+    const auto it = std::find(msg.joint_names.begin(), msg.joint_names.end(), joint);
+    if (it == msg.joint_names.end())
+    {
+      error = "Joint " + joint + " is missing from the trajectory";
+      return false;
+    }
+    indices.push_back(static_cast<std::size_t>(std::distance(msg.joint_names.begin(), it)));
+  }
+  if (msg.points.empty())
+  {
+    error = "Trajectory has no points";
+    return false;
+  }
+
+  dof_ = joints.size();
+  has_velocities_ = true;
+  for (const auto & point : msg.points)
+  {
+    if (point.positions.size() != msg.joint_names.size())
+    {
+      error = "Number of positions does not match the number of joints";
+      return false;
+    }
+    has_velocities_ &= point.velocities.size() == msg.joint_names.size();
+  }
+
+  const std::size_t points = msg.points.size() + 1;
+  times_.assign(points, 0.0);
+  positions_.assign(points * dof_, 0.0);
+  velocities_.assign(points * dof_, 0.0);
+  for (std::size_t p = 1; p < points; ++p)
+  {
+    const auto & point = msg.points[p - 1];
+    times_[p] = rclcpp::Duration(point.time_from_start).seconds();
+    if (times_[p] <= times_[p - 1])
+    {
+      error = "Point times must be positive and increasing";
+      return false;
+    }
+    for (std::size_t j = 0; j < dof_; ++j)
+    {
+      positions_[p * dof_ + j] = point.positions[indices[j]];
+      if (has_velocities_)
+      {
+        velocities_[p * dof_ + j] = point.velocities[indices[j]];
+      }
+    }
+  }
+  start_time_ = rclcpp::Time(msg.header.stamp).nanoseconds();
+  return true;
+}
+
+void SynchronizedTrajectory::setStartPositions(const double * positions)
+{
+  std::copy(positions, positions + dof_, positions_.begin());
+}
+
+void SynchronizedTrajectory::sample(
+  double time, std::size_t first_joint, std::size_t joint_count, double * output) const
+{
+  if (time <= 0)
+  {
+    std::copy_n(positions_.begin() + first_joint, joint_count, output);
+    return;
+  }
+  if (time >= times_.back())
+  {
+    std::copy_n(positions_.end() - dof_ + first_joint, joint_count, output);
+    return;
+  }
+
+  // Segment between the points p - 1 and p
+  const std::size_t p = static_cast<std::size_t>(
+    std::distance(times_.begin(), std::upper_bound(times_.begin(), times_.end(), time)));
+  const double h = times_[p] - times_[p - 1];
+  const double s = (time - times_[p - 1]) / h;
+  const double * p0 = &positions_[(p - 1) * dof_ + first_joint];
+  const double * p1 = &positions_[p * dof_ + first_joint];
+  if (!has_velocities_)
+  {
+    for (std::size_t j = 0; j < joint_count; ++j)
+    {
+      output[j] = p0[j] + s * (p1[j] - p0[j]);
+    }
+    return;
+  }
+
+  const double * v0 = &velocities_[(p - 1) * dof_ + first_joint];
+  const double * v1 = &velocities_[p * dof_ + first_joint];
+  const double s2 = s * s;
+  const double s3 = s2 * s;
+  const double h00 = 2 * s3 - 3 * s2 + 1;
+  const double h10 = s3 - 2 * s2 + s;
+  const double h01 = -2 * s3 + 3 * s2;
+  const double h11 = s3 - s2;
+  for (std::size_t j = 0; j < joint_count; ++j)
+  {
+    output[j] = h00 * p0[j] + h10 * h * v0[j] + h01 * p1[j] + h11 * h * v1[j];
+  }
+}
+}  // namespace kuka_controllers
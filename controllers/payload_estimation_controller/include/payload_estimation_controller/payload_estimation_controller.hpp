@@ -0,0 +1,99 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PAYLOAD_ESTIMATION_CONTROLLER__PAYLOAD_ESTIMATION_CONTROLLER_HPP_
+#define PAYLOAD_ESTIMATION_CONTROLLER__PAYLOAD_ESTIMATION_CONTROLLER_HPP_
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "controller_interface/controller_interface.hpp"
+#include "dynamics_feedforward_controller/rnea_kernel.hpp"
+#include "geometry_msgs/msg/inertia_stamped.hpp"
+#include "pluginlib/class_list_macros.hpp"
+#include "rclcpp/duration.hpp"
+#include "rclcpp/time.hpp"
+#include "realtime_tools/realtime_publisher.h"
+
+#include "payload_estimation_controller/payload_estimator.hpp"
+#include "payload_estimation_controller/visibility_control.h"
+#include "payload_estimation_controller_parameters.hpp"
+
+namespace kuka_controllers
+{
+/**
+ * @brief Controller estimating the mass and center of mass of the payload from the measured joint
+ *  torques, while the robot is standing or moving slowly
+ *
+ * The controller does not claim command interfaces, so it can run beside any other controller.
+ */
+class PayloadEstimationController : public controller_interface::ControllerInterface
+{
+public:
+  PAYLOAD_ESTIMATION_CONTROLLER_PUBLIC controller_interface::InterfaceConfiguration
+  command_interface_configuration() const override;
+
+  PAYLOAD_ESTIMATION_CONTROLLER_PUBLIC controller_interface::InterfaceConfiguration
+  state_interface_configuration() const override;
+
+  PAYLOAD_ESTIMATION_CONTROLLER_PUBLIC controller_interface::return_type update(
+    const rclcpp::Time & time, const rclcpp::Duration & period) override;
+
+  PAYLOAD_ESTIMATION_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_configure(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  PAYLOAD_ESTIMATION_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_activate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  PAYLOAD_ESTIMATION_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_deactivate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  PAYLOAD_ESTIMATION_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_init() override;
+
+private:
+  PAYLOAD_ESTIMATION_CONTROLLER_LOCAL void addSample();
+  PAYLOAD_ESTIMATION_CONTROLLER_LOCAL void publishEstimate(const rclcpp::Time & time);
+
+  using Params = payload_estimation_controller::Params;
+  using ParamListener = payload_estimation_controller::ParamListener;
+
+  std::shared_ptr<ParamListener> param_listener_;
+  Params params_;
+  bool external_torques_ = true;
+
+  // Models of the payload alone and of the robot without payload
+  RneaKernel payload_kernel_;
+  RneaKernel robot_kernel_;
+  // Unit mass at the origin and on the axes of the tip frame, expressed in the last joint frame
+  std::array<RigidBody, PayloadEstimator::PARAMETER_COUNT> unit_payloads_;
+  PayloadEstimator estimator_;
+
+  RneaKernel::Vector positions_;
+  RneaKernel::Vector previous_positions_;
+  RneaKernel::Vector velocities_;
+  RneaKernel::Vector torques_;
+  RneaKernel::Vector model_torques_;
+  RneaKernel::Vector zeros_;
+  PayloadEstimator::Regressor regressor_;
+  int64_t cycle_ = 0;
+  int64_t last_publish_ns_ = 0;
+
+  std::shared_ptr<rclcpp::Publisher<geometry_msgs::msg::InertiaStamped>> payload_publisher_;
+  std::unique_ptr<realtime_tools::RealtimePublisher<geometry_msgs::msg::InertiaStamped>>
+    rt_payload_publisher_;
+};
+}  // namespace kuka_controllers
+#endif  // PAYLOAD_ESTIMATION_CONTROLLER__PAYLOAD_ESTIMATION_CONTROLLER_HPP_
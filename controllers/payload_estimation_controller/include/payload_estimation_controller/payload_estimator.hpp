@@ -0,0 +1,104 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PAYLOAD_ESTIMATION_CONTROLLER__PAYLOAD_ESTIMATOR_HPP_
+#define PAYLOAD_ESTIMATION_CONTROLLER__PAYLOAD_ESTIMATOR_HPP_
+
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "dynamics_feedforward_controller/rnea_kernel.hpp"
+
+namespace kuka_controllers
+{
+/**
+ * @brief Least squares estimation of the mass and center of mass of a payload over a sliding
+ *  window of static torque samples
+ *
+ * The payload torques are linear in the parameters [m, m*cx, m*cy, m*cz]. The normal equations
+ *  of the window are updated recursively: every new sample is added and the sample leaving the
+ *  window is removed, so the cost of a sample does not depend on the window size.
+ * Memory is allocated only in configure(), all other methods can be called from the control loop.
+ */
+class PayloadEstimator
+{
+public:
+  static constexpr int PARAMETER_COUNT = 4;
+  using Vector = RneaKernel::Vector;
+  using Regressor = Eigen::Matrix<
+    double, Eigen::Dynamic, PARAMETER_COUNT, Eigen::ColMajor, RneaKernel::MAX_JOINTS,
+    PARAMETER_COUNT>;
+  using Parameters = Eigen::Matrix<double, PARAMETER_COUNT, 1>;
+
+  /**
+   * @brief Allocates the window
+   *
+   * @param joints: Number of joints
+   * @param window_size: Number of samples in the window
+   * @param regularization: Added to the diagonal of the normal equations, keeps the solution
+   *  bounded if the samples do not excite all parameters
+   */
+  void configure(std::size_t joints, std::size_t window_size, double regularization);
+
+  /**
+   * @brief Removes all samples
+   */
+  void reset();
+
+  /**
+   * @brief Adds a sample to the window, dropping the oldest one if the window is full
+   *
+   * @param regressor: Joint torques caused by the unit parameters in the actual configuration
+   * @param torques: Measured joint torques caused by the payload
+   */
+  void addSample(const Regressor & regressor, const Vector & torques);
+
+  /**
+   * @brief Solves the normal equations of the window
+   *
+   * @param parameters: The estimated [m, m*cx, m*cy, m*cz]
+   * @return bool: False if the window is empty
+   */
+  bool estimate(Parameters & parameters) const;
+
+  /**
+   * @brief Smallest eigenvalue of the normal equations divided by the number of samples
+   *
+   * It is small if the configurations in the window do not allow distinguishing all parameters,
+   *  e.g. the center of mass along the gravity vector if the tool orientation did not change.
+   */
+  double excitation() const;
+
+  std::size_t size() const { return size_; }
+
+private:
+  using Matrix = Eigen::Matrix<double, PARAMETER_COUNT, PARAMETER_COUNT>;
+
+  std::size_t joints_ = 0;
+  std::size_t capacity_ = 0;
+  std::size_t head_ = 0;
+  std::size_t size_ = 0;
+  double regularization_ = 0;
+
+  // Samples of the window, indexed as [sample * joints + joint]
+  std::vector<Eigen::Matrix<double, 1, PARAMETER_COUNT>> regressors_;
+  std::vector<double> torques_;
+
+  Matrix information_ = Matrix::Zero();
+  Parameters correlation_ = Parameters::Zero();
+};
+}  // namespace kuka_controllers
+
+#endif  // PAYLOAD_ESTIMATION_CONTROLLER__PAYLOAD_ESTIMATOR_HPP_
@@ -0,0 +1,240 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "dynamics_feedforward_controller/urdf_chain.hpp"
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+
+#include "payload_estimation_controller/payload_estimation_controller.hpp"
+
+namespace kuka_controllers
+{
+controller_interface::CallbackReturn PayloadEstimationController::on_init()
+{
+  try
+  {
+    param_listener_ = std::make_shared<ParamListener>(get_node());
+    params_ = param_listener_->get_params();
+  }
+  catch (const std::exception & e)
+  {
+    fprintf(stderr, "Exception thrown during init stage with message: %s \n", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::InterfaceConfiguration
+PayloadEstimationController::command_interface_configuration() const
+{
+  return controller_interface::InterfaceConfiguration{
+    controller_interface::interface_configuration_type::NONE};
+}
+
+controller_interface::InterfaceConfiguration
+PayloadEstimationController::state_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_POSITION);
+  }
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + params_.torque_interface);
+  }
+  return config;
+}
+
+controller_interface::CallbackReturn PayloadEstimationController::on_configure(
+  const rclcpp_lifecycle::State &)
+{
+  params_ = param_listener_->get_params();
+  if (params_.joints.empty())
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "'joints' parameter is empty");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  external_torques_ = params_.torque_interface == "external_torque";
+
+  std::string error;
+  Eigen::Isometry3d tip_transform;
+  if (!loadUrdfChain(
+        get_robot_description(), params_.base_link, params_.tip_link, params_.joints,
+        robot_kernel_, tip_transform, error))
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "Failed to set up the dynamic model: %s", error.c_str());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  robot_kernel_.setGravity(Eigen::Map<const Eigen::Vector3d>(params_.gravity.data()));
+  payload_kernel_ = robot_kernel_;
+  payload_kernel_.setLinkGravity(false);
+
+  for (std::size_t i = 0; i < unit_payloads_.size(); ++i)
+  {
+    RigidBody unit;
+    unit.mass = 1.0;
+    if (i > 0)
+    {
+      unit.com[static_cast<Eigen::Index>(i - 1)] = 1.0;
+    }
+    unit_payloads_[i] = unit.transformed(tip_transform);
+  }
+
+  const auto joints = static_cast<Eigen::Index>(params_.joints.size());
+  positions_.setZero(joints);
+  previous_positions_.setZero(joints);
+  velocities_.setZero(joints);
+  torques_.setZero(joints);
+  model_torques_.setZero(joints);
+  zeros_.setZero(joints);
+  regressor_.setZero(joints, PayloadEstimator::PARAMETER_COUNT);
+  estimator_.configure(
+    params_.joints.size(), static_cast<std::size_t>(params_.window_size),
+    params_.regularization);
+
+  payload_publisher_ = get_node()->create_publisher<geometry_msgs::msg::InertiaStamped>(
+    params_.payload_topic, rclcpp::SystemDefaultsQoS());
+  rt_payload_publisher_ =
+    std::make_unique<realtime_tools::RealtimePublisher<geometry_msgs::msg::InertiaStamped>>(
+      payload_publisher_);
+  rt_payload_publisher_->msg_.header.frame_id = params_.tip_link;
+
+  RCLCPP_INFO(
+    get_node()->get_logger(), "Payload estimation configured with a window of %.1f s",
+    static_cast<double>(params_.window_size * params_.sample_decimation) / get_update_rate());
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn PayloadEstimationController::on_activate(
+  const rclcpp_lifecycle::State &)
+{
+  for (Eigen::Index i = 0; i < positions_.size(); ++i)
+  {
+    positions_[i] = state_interfaces_[static_cast<std::size_t>(i)].get_value();
+  }
+  previous_positions_ = positions_;
+  velocities_.setZero();
+  estimator_.reset();
+  cycle_ = 0;
+  last_publish_ns_ = 0;
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn PayloadEstimationController::on_deactivate(
+  const rclcpp_lifecycle::State &)
+{
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::return_type PayloadEstimationController::update(
+  const rclcpp::Time & time, const rclcpp::Duration & period)
+{
+  const auto joints = static_cast<std::size_t>(positions_.size());
+  for (std::size_t i = 0; i < joints; ++i)
+  {
+    positions_[static_cast<Eigen::Index>(i)] = state_interfaces_[i].get_value();
+  }
+
+  // Differentiated velocities are filtered with a first order low-pass filter
+  const double dt = period.seconds();
+  if (dt > 0)
+  {
+    const double time_constant = 1.0 / (2 * M_PI * params_.velocity_filter_cutoff);
+    const double alpha = dt / (dt + time_constant);
+    velocities_ += alpha * ((positions_ - previous_positions_) / dt - velocities_);
+  }
+  previous_positions_ = positions_;
+
+  if (
+    ++cycle_ >= params_.sample_decimation &&
+    velocities_.cwiseAbs().maxCoeff() < params_.max_velocity)
+  {
+    cycle_ = 0;
+    for (std::size_t i = 0; i < joints; ++i)
+    {
+      torques_[static_cast<Eigen::Index>(i)] = state_interfaces_[joints + i].get_value();
+    }
+    addSample();
+  }
+
+  publishEstimate(time);
+  return controller_interface::return_type::OK;
+}
+
+void PayloadEstimationController::addSample()
+{
+  // The payload torques are linear in [m, m*cx, m*cy, m*cz], the columns of the regressor are
+  //  the torques of the unit parameters
+  payload_kernel_.compute(positions_, zeros_, zeros_, unit_payloads_[0], model_torques_);
+  regressor_.col(0) = model_torques_;
+  for (std::size_t i = 1; i < unit_payloads_.size(); ++i)
+  {
+    payload_kernel_.compute(positions_, zeros_, zeros_, unit_payloads_[i], model_torques_);
+    regressor_.col(static_cast<Eigen::Index>(i)) = model_torques_ - regressor_.col(0);
+  }
+
+  if (external_torques_)
+  {
+    // The weight of an unknown payload is measured as external torque acting against the motors
+    torques_ = -torques_;
+  }
+  else
+  {
+    robot_kernel_.compute(positions_, zeros_, zeros_, RigidBody(), model_torques_);
+    torques_ -= model_torques_;
+  }
+  estimator_.addSample(regressor_, torques_);
+}
+
+void PayloadEstimationController::publishEstimate(const rclcpp::Time & time)
+{
+  if (
+    estimator_.size() == 0 ||
+    static_cast<double>(time.nanoseconds() - last_publish_ns_) * 1e-9 < 1.0 / params_.publish_rate)
+  {
+    return;
+  }
+  last_publish_ns_ = time.nanoseconds();
+
+  PayloadEstimator::Parameters parameters;
+  if (estimator_.excitation() < params_.min_excitation || !estimator_.estimate(parameters))
+  {
+    return;
+  }
+
+  if (rt_payload_publisher_->trylock())
+  {
+    auto & msg = rt_payload_publisher_->msg_;
+    msg.header.stamp = time;
+    msg.inertia.m = std::max(parameters[0], 0.0);
+    msg.inertia.com.x = 0.0;
+    msg.inertia.com.y = 0.0;
+    msg.inertia.com.z = 0.0;
+    if (parameters[0] >= params_.min_mass)
+    {
+      msg.inertia.com.x = parameters[1] / parameters[0];
+      msg.inertia.com.y = parameters[2] / parameters[0];
+      msg.inertia.com.z = parameters[3] / parameters[0];
+    }
+    rt_payload_publisher_->unlockAndPublish();
+  }
+}
+}  // namespace kuka_controllers
+
+PLUGINLIB_EXPORT_CLASS(
+  kuka_controllers::PayloadEstimationController, controller_interface::ControllerInterface)
@@ -0,0 +1,91 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include <Eigen/Cholesky>
+#include <Eigen/Eigenvalues>
+
+#include "payload_estimation_controller/payload_estimator.hpp"
+
+namespace kuka_controllers
+{
+void PayloadEstimator::configure(
+  std::size_t joints, std::size_t window_size, double regularization)
+{
+  joints_ = joints;
+  capacity_ = std::max<std::size_t>(1, window_size);
+  regularization_ = regularization;
+  regressors_.assign(capacity_ * joints_, Eigen::Matrix<double, 1, PARAMETER_COUNT>::Zero());
+  torques_.assign(capacity_ * joints_, 0.0);
+  reset();
+}
+
+void PayloadEstimator::reset()
+{
+  head_ = 0;
+  size_ = 0;
+  information_.setZero();
+  correlation_.setZero();
+}
+
+void PayloadEstimator::addSample(const Regressor & regressor, const Vector & torques)
+{
+  const std::size_t offset = head_ * joints_;
+  if (size_ == capacity_)
+  {
+    for (std::size_t i = 0; i < joints_; ++i)
+    {
+      const auto & row = regressors_[offset + i];
+      information_.noalias() -= row.transpose() * row;
+      correlation_.noalias() -= row.transpose() * torques_[offset + i];
+    }
+  }
+  else
+  {
+    ++size_;
+  }
+
+  for (std::size_t i = 0; i < joints_; ++i)
+  {
+    const auto index = static_cast<Eigen::Index>(i);
+    regressors_[offset + i] = regressor.row(index);
+    torques_[offset + i] = torques[index];
+    information_.noalias() += regressor.row(index).transpose() * regressor.row(index);
+    correlation_.noalias() += regressor.row(index).transpose() * torques[index];
+  }
+  head_ = (head_ + 1) % capacity_;
+}
+
+bool PayloadEstimator::estimate(Parameters & parameters) const
+{
+  if (size_ == 0)
+  {
+    return false;
+  }
+  const Matrix regularized = information_ + regularization_ * Matrix::Identity();
+  parameters = Eigen::LDLT<Matrix>(regularized).solve(correlation_);
+  return true;
+}
+
+double PayloadEstimator::excitation() const
+{
+  if (size_ == 0)
+  {
+    return 0.0;
+  }
+  const Eigen::SelfAdjointEigenSolver<Matrix> solver(information_, Eigen::EigenvaluesOnly);
+  return solver.eigenvalues()[0] / static_cast<double>(size_);
+}
+}  // namespace kuka_controllers
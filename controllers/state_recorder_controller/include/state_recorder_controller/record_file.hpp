@@ -0,0 +1,129 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef STATE_RECORDER_CONTROLLER__RECORD_FILE_HPP_
+#define STATE_RECORDER_CONTROLLER__RECORD_FILE_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace kuka_controllers
+{
+/**
+ * @brief Memory-mapped file storing timestamped rows of double values in columnar layout
+ *
+ * The file consists of a header, the newline-separated column names and the data: a column of
+ *  int64 timestamps followed by a column of doubles for every value, each with room for the same
+ *  number of rows. Rows are written circularly, after the file is full the oldest row is
+ *  overwritten. The total number of written rows is stored in the header, so readers can restore
+ *  the order of the rows.
+ *
+ * The file is allocated and its pages are touched on creation, write() only copies the values to
+ *  the mapped memory, so it can be called from the control loop.
+ */
+class RecordFile
+{
+public:
+  static constexpr char MAGIC[8] = {'K', 'U', 'K', 'A', 'R', 'E', 'C', '\0'};
+  static constexpr uint32_t VERSION = 1;
+
+  struct Header
+  {
+    char magic[8];
+    uint32_t version;
+    uint32_t column_count;
+    uint64_t capacity;
+    uint64_t names_size;
+    uint64_t data_offset;
+    // Number of rows written since creation, updated after the values of the row
+    std::atomic<uint64_t> rows;
+  };
+
+  /**
+   * @brief Creates and maps a new file, an existing file with the same path is overwritten
+   *
+   * @param path: Path of the file
+   * @param columns: Names of the value columns
+   * @param capacity: Number of rows in the file
+   * @param lock_memory: Lock the mapped pages in memory, so they are never swapped out
+   * @param error: Description of the problem, if the file could not be created
+   * @return std::unique_ptr<RecordFile>: The file or nullptr on failure
+   */
+  static std::unique_ptr<RecordFile> create(
+    const std::string & path, const std::vector<std::string> & columns, std::size_t capacity,
+    bool lock_memory, std::string & error);
+
+  /**
+   * @brief Maps an existing file for reading
+   *
+   * @return std::unique_ptr<RecordFile>: The file or nullptr if it is not a valid record file
+   */
+  static std::unique_ptr<RecordFile> open(const std::string & path, std::string & error);
+
+  ~RecordFile();
+
+  RecordFile(const RecordFile &) = delete;
+  RecordFile & operator=(const RecordFile &) = delete;
+
+  /**
+   * @brief Appends a row, overwriting the oldest one if the file is full
+   *
+   * @param stamp: Time of the row in nanoseconds
+   * @param values: Array with a value for every column
+   */
+  void write(int64_t stamp, const double * values);
+
+  /**
+   * @brief Writes the modified pages to the disk
+   *
+   * @param wait: Block until the pages are written, otherwise the writing is only scheduled
+   */
+  void flush(bool wait);
+
+  const std::string & path() const { return path_; }
+  const std::vector<std::string> & columns() const { return columns_; }
+  std::size_t capacity() const { return capacity_; }
+  uint64_t rows() const { return header_->rows.load(std::memory_order_acquire); }
+  bool full() const { return rows() >= capacity_; }
+
+  /**
+   * @brief Timestamp and value access of the row stored at the given index
+   */
+  int64_t stamp(std::size_t index) const { return stamps_[index]; }
+  double value(std::size_t index, std::size_t column) const
+  {
+    return values_[column * capacity_ + index];
+  }
+
+private:
+  RecordFile() = default;
+
+  std::string path_;
+  std::vector<std::string> columns_;
+  std::size_t capacity_ = 0;
+  int fd_ = -1;
+  void * mapping_ = nullptr;
+  std::size_t size_ = 0;
+  bool locked_ = false;
+
+  Header * header_ = nullptr;
+  int64_t * stamps_ = nullptr;
+  double * values_ = nullptr;
+};
+}  // namespace kuka_controllers
+
+#endif  // STATE_RECORDER_CONTROLLER__RECORD_FILE_HPP_
@@ -0,0 +1,96 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef STATE_RECORDER_CONTROLLER__STATE_RECORDER_CONTROLLER_HPP_
+#define STATE_RECORDER_CONTROLLER__STATE_RECORDER_CONTROLLER_HPP_
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "controller_interface/controller_interface.hpp"
+#include "pluginlib/class_list_macros.hpp"
+#include "rclcpp/duration.hpp"
+#include "rclcpp/time.hpp"
+
+#include "state_recorder_controller/record_file.hpp"
+#include "state_recorder_controller/visibility_control.h"
+#include "state_recorder_controller_parameters.hpp"
+
+namespace kuka_controllers
+{
+/**
+ * @brief Controller recording state interfaces in every cycle into memory-mapped files
+ *
+ * The control loop only copies the values into the mapped memory. A background thread prepares
+ *  the next file before the actual one is full, flushes the files to the disk and removes the
+ *  oldest files.
+ */
+class StateRecorderController : public controller_interface::ControllerInterface
+{
+public:
+  STATE_RECORDER_CONTROLLER_PUBLIC ~StateRecorderController() override;
+
+  STATE_RECORDER_CONTROLLER_PUBLIC controller_interface::InterfaceConfiguration
+  command_interface_configuration() const override;
+
+  STATE_RECORDER_CONTROLLER_PUBLIC controller_interface::InterfaceConfiguration
+  state_interface_configuration() const override;
+
+  STATE_RECORDER_CONTROLLER_PUBLIC controller_interface::return_type update(
+    const rclcpp::Time & time, const rclcpp::Duration & period) override;
+
+  STATE_RECORDER_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_configure(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  STATE_RECORDER_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_activate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  STATE_RECORDER_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_deactivate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  STATE_RECORDER_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_init() override;
+
+private:
+  STATE_RECORDER_CONTROLLER_LOCAL std::unique_ptr<RecordFile> createFile();
+  STATE_RECORDER_CONTROLLER_LOCAL void closeFile(std::unique_ptr<RecordFile> file);
+  STATE_RECORDER_CONTROLLER_LOCAL void removeOldFiles(std::size_t open_files);
+  STATE_RECORDER_CONTROLLER_LOCAL void writerLoop();
+  STATE_RECORDER_CONTROLLER_LOCAL void stopRecording();
+
+  using Params = state_recorder_controller::Params;
+  using ParamListener = state_recorder_controller::ParamListener;
+
+  std::shared_ptr<ParamListener> param_listener_;
+  Params params_;
+
+  std::vector<std::string> columns_;
+  std::vector<double> values_;
+
+  // Files are created and deleted by the non-realtime side, the control loop exchanges them
+  std::atomic<RecordFile *> active_{nullptr};
+  std::atomic<RecordFile *> standby_{nullptr};
+  std::atomic<RecordFile *> retired_{nullptr};
+
+  std::thread writer_thread_;
+  std::atomic<bool> recording_{false};
+  std::string session_;
+  int file_index_ = 0;
+  std::deque<std::string> closed_files_;
+};
+}  // namespace kuka_controllers
+#endif  // STATE_RECORDER_CONTROLLER__STATE_RECORDER_CONTROLLER_HPP_
@@ -0,0 +1,104 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Converts record files of the state recorder controller to CSV, the rows are written in
+//  chronological order, multiple files are concatenated.
+// Usage: ros2 run state_recorder_controller record_converter [-o output.csv] input.rec...
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "state_recorder_controller/record_file.hpp"
+
+int main(int argc, char ** argv)
+{
+  std::string output_path;
+  std::vector<std::string> inputs;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+    {
+      output_path = argv[++i];
+    }
+    else
+    {
+      inputs.emplace_back(argv[i]);
+    }
+  }
+  if (inputs.empty())
+  {
+    fprintf(stderr, "Usage: %s [-o output.csv] input.rec...\n", argv[0]);
+    return 1;
+  }
+
+  FILE * output = output_path.empty() ? stdout : std::fopen(output_path.c_str(), "w");
+  if (output == nullptr)
+  {
+    fprintf(stderr, "Failed to open %s\n", output_path.c_str());
+    return 1;
+  }
+
+  std::vector<std::string> columns;
+  int result = 0;
+  for (const auto & input : inputs)
+  {
+    std::string error;
+    const auto file = kuka_controllers::RecordFile::open(input, error);
+    if (file == nullptr)
+    {
+      fprintf(stderr, "%s\n", error.c_str());
+      result = 1;
+      break;
+    }
+    if (columns.empty())
+    {
+      columns = file->columns();
+      fprintf(output, "time_ns");
+      for (const auto & column : columns)
+      {
+        fprintf(output, ",%s", column.c_str());
+      }
+      fprintf(output, "\n");
+    }
+    else if (file->columns() != columns)
+    {
+      fprintf(stderr, "Columns of %s differ from the previous files\n", input.c_str());
+      result = 1;
+      break;
+    }
+
+    // After the file was full, the oldest row is the one after the last written row
+    const uint64_t rows = file->rows();
+    const uint64_t first = rows > file->capacity() ? rows - file->capacity() : 0;
+    for (uint64_t row = first; row < rows; ++row)
+    {
+      const std::size_t index = row % file->capacity();
+      fprintf(output, "%" PRId64, file->stamp(index));
+      for (std::size_t column = 0; column < columns.size(); ++column)
+      {
+        fprintf(output, ",%.17g", file->value(index, column));
+      }
+      fprintf(output, "\n");
+    }
+  }
+
+  if (output != stdout)
+  {
+    std::fclose(output);
+  }
+  return result;
+}
@@ -0,0 +1,209 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#include "state_recorder_controller/record_file.hpp"
+
+namespace kuka_controllers
+{
+namespace
+{
+// The data starts on a page boundary
+constexpr std::size_t DATA_ALIGNMENT = 4096;
+
+std::size_t dataOffset(std::size_t names_size)
+{
+  const std::size_t end = sizeof(RecordFile::Header) + names_size;
+  return (end + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+}
+
+std::size_t fileSize(std::size_t data_offset, std::size_t columns, std::size_t capacity)
+{
+  return data_offset + (columns + 1) * capacity * sizeof(double);
+}
+}  // namespace
+
+std::unique_ptr<RecordFile> RecordFile::create(
+  const std::string & path, const std::vector<std::string> & columns, std::size_t capacity,
+  bool lock_memory, std::string & error)
+{
+  std::unique_ptr<RecordFile> file(new RecordFile());
+  file->path_ = path;
+  file->columns_ = columns;
+  file->capacity_ = capacity;
+
+  std::string names;
+  for (const auto & column : columns)
+  {
+    names += column + "\n";
+  }
+  const std::size_t data_offset = dataOffset(names.size());
+  file->size_ = fileSize(data_offset, columns.size(), capacity);
+
+  file->fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (file->fd_ < 0)
+  {
+    error = "Failed to create " + path + ": " + std::strerror(errno);
+    return nullptr;
+  }
+  // Reserve the blocks on the disk, so writing the mapping cannot fail later
+  const int result = posix_fallocate(file->fd_, 0, static_cast<off_t>(file->size_));
+  if (result != 0)
+  {
+    error = "Failed to allocate " + path + ": " + std::strerror(result);
+    return nullptr;
+  }
+  file->mapping_ = mmap(nullptr, file->size_, PROT_READ | PROT_WRITE, MAP_SHARED, file->fd_, 0);
+  if (file->mapping_ == MAP_FAILED)
+  {
+    file->mapping_ = nullptr;
+    error = "Failed to map " + path + ": " + std::strerror(errno);
+    return nullptr;
+  }
+  if (lock_memory)
+  {
+    if (mlock(file->mapping_, file->size_) != 0)
+    {
+      error = "Failed to lock " + path + " in memory: " + std::strerror(errno);
+      return nullptr;
+    }
+    file->locked_ = true;
+  }
+  // Touch every page, so that no page faults occur while recording
+  std::memset(file->mapping_, 0, file->size_);
+
+  auto * bytes = static_cast<char *>(file->mapping_);
+  file->header_ = new (bytes) Header();
+  std::memcpy(file->header_->magic, MAGIC, sizeof(MAGIC));
+  file->header_->version = VERSION;
+  file->header_->column_count = static_cast<uint32_t>(columns.size());
+  file->header_->capacity = capacity;
+  file->header_->names_size = names.size();
+  file->header_->data_offset = data_offset;
+  file->header_->rows.store(0, std::memory_order_release);
+  std::memcpy(bytes + sizeof(Header), names.data(), names.size());
+
+  file->stamps_ = reinterpret_cast<int64_t *>(bytes + data_offset);
+  file->values_ = reinterpret_cast<double *>(bytes + data_offset + capacity * sizeof(int64_t));
+  return file;
+}
+
+std::unique_ptr<RecordFile> RecordFile::open(const std::string & path, std::string & error)
+{
+  std::unique_ptr<RecordFile> file(new RecordFile());
+  file->path_ = path;
+  file->fd_ = ::open(path.c_str(), O_RDONLY);
+  if (file->fd_ < 0)
+  {
+    error = "Failed to open " + path + ": " + std::strerror(errno);
+    return nullptr;
+  }
+  struct stat status;
+  if (fstat(file->fd_, &status) != 0 || static_cast<std::size_t>(status.st_size) < sizeof(Header))
+  {
+    error = path + " is not a record file";
+    return nullptr;
+  }
+  file->size_ = static_cast<std::size_t>(status.st_size);
+  file->mapping_ = mmap(nullptr, file->size_, PROT_READ, MAP_SHARED, file->fd_, 0);
+  if (file->mapping_ == MAP_FAILED)
+  {
+    file->mapping_ = nullptr;
+    error = "Failed to map " + path + ": " + std::strerror(errno);
+    return nullptr;
+  }
+
+  auto * bytes = static_cast<char *>(file->mapping_);
+  file->header_ = reinterpret_cast<Header *>(bytes);
+  const Header & header = *file->header_;
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION)
+  {
+    error = path + " is not a record file of version " + std::to_string(VERSION);
+    return nullptr;
+  }
+  if (
+    header.capacity == 0 || sizeof(Header) + header.names_size > header.data_offset ||
+    fileSize(header.data_offset, header.column_count, header.capacity) > file->size_)
+  {
+    error = path + " is truncated";
+    return nullptr;
+  }
+
+  file->capacity_ = header.capacity;
+  const char * names = bytes + sizeof(Header);
+  std::size_t begin = 0;
+  for (std::size_t i = 0; i < header.names_size; ++i)
+  {
+    if (names[i] == '\n')
+    {
+      file->columns_.emplace_back(names + begin, i - begin);
+      begin = i + 1;
+    }
+  }
+  if (file->columns_.size() != header.column_count)
+  {
+    error = path + " has inconsistent column names";
+    return nullptr;
+  }
+
+  file->stamps_ = reinterpret_cast<int64_t *>(bytes + header.data_offset);
+  file->values_ =
+    reinterpret_cast<double *>(bytes + header.data_offset + header.capacity * sizeof(int64_t));
+  return file;
+}
+
+RecordFile::~RecordFile()
+{
+  if (mapping_ != nullptr)
+  {
+    if (locked_)
+    {
+      munlock(mapping_, size_);
+    }
+    munmap(mapping_, size_);
+  }
+  if (fd_ >= 0)
+  {
+    close(fd_);
+  }
+}
+
+void RecordFile::write(int64_t stamp, const double * values)
+{
+  const uint64_t row = header_->rows.load(std::memory_order_relaxed);
+  const std::size_t index = row % capacity_;
+  stamps_[index] = stamp;
+  for (std::size_t column = 0; column < columns_.size(); ++column)
+  {
+    values_[column * capacity_ + index] = values[column];
+  }
+  header_->rows.store(row + 1, std::memory_order_release);
+}
+
+void RecordFile::flush(bool wait)
+{
+  if (mapping_ != nullptr)
+  {
+    msync(mapping_, size_, wait ? MS_SYNC : MS_ASYNC);
+  }
+}
+}  // namespace kuka_controllers
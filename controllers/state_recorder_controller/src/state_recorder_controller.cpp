@@ -0,0 +1,253 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+
+#include "state_recorder_controller/state_recorder_controller.hpp"
+
+namespace kuka_controllers
+{
+namespace
+{
+// Period of checking whether the next file is needed or a full file can be closed
+constexpr std::chrono::milliseconds WRITER_PERIOD(10);
+}  // namespace
+
+StateRecorderController::~StateRecorderController() { stopRecording(); }
+
+controller_interface::CallbackReturn StateRecorderController::on_init()
+{
+  try
+  {
+    param_listener_ = std::make_shared<ParamListener>(get_node());
+    params_ = param_listener_->get_params();
+  }
+  catch (const std::exception & e)
+  {
+    fprintf(stderr, "Exception thrown during init stage with message: %s \n", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::InterfaceConfiguration
+StateRecorderController::command_interface_configuration() const
+{
+  return controller_interface::InterfaceConfiguration{
+    controller_interface::interface_configuration_type::NONE};
+}
+
+controller_interface::InterfaceConfiguration
+StateRecorderController::state_interface_configuration() const
+{
+  if (params_.interfaces.empty())
+  {
+    return controller_interface::InterfaceConfiguration{
+      controller_interface::interface_configuration_type::ALL};
+  }
+  return controller_interface::InterfaceConfiguration{
+    controller_interface::interface_configuration_type::INDIVIDUAL, params_.interfaces};
+}
+
+controller_interface::CallbackReturn StateRecorderController::on_configure(
+  const rclcpp_lifecycle::State &)
+{
+  params_ = param_listener_->get_params();
+  std::error_code error;
+  std::filesystem::create_directories(params_.directory, error);
+  if (error)
+  {
+    RCLCPP_ERROR(
+      get_node()->get_logger(), "Failed to create directory %s: %s", params_.directory.c_str(),
+      error.message().c_str());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn StateRecorderController::on_activate(
+  const rclcpp_lifecycle::State &)
+{
+  // The claimed interfaces are known only after activation, as all of them can be claimed
+  columns_.clear();
+  for (const auto & state_interface : state_interfaces_)
+  {
+    columns_.emplace_back(state_interface.get_name());
+  }
+  values_.assign(columns_.size(), 0.0);
+
+  char stamp[32];
+  const std::time_t now = std::time(nullptr);
+  std::tm local_time;
+  localtime_r(&now, &local_time);
+  std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &local_time);
+  session_ = params_.file_prefix + "_" + stamp;
+  file_index_ = 0;
+  closed_files_.clear();
+
+  auto file = createFile();
+  if (file == nullptr)
+  {
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  active_.store(file.release());
+
+  recording_ = true;
+  writer_thread_ = std::thread(&StateRecorderController::writerLoop, this);
+  RCLCPP_INFO(
+    get_node()->get_logger(), "Recording %zu state interfaces to %s", columns_.size(),
+    params_.directory.c_str());
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn StateRecorderController::on_deactivate(
+  const rclcpp_lifecycle::State &)
+{
+  stopRecording();
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::return_type StateRecorderController::update(
+  const rclcpp::Time & time, const rclcpp::Duration &)
+{
+  for (std::size_t i = 0; i < values_.size(); ++i)
+  {
+    values_[i] = state_interfaces_[i].get_value();
+  }
+
+  RecordFile * active = active_.load(std::memory_order_acquire);
+  // Switch to the prepared file only after the previous full file has been closed
+  if (params_.rotate && active->full() && retired_.load(std::memory_order_acquire) == nullptr)
+  {
+    if (RecordFile * next = standby_.exchange(nullptr, std::memory_order_acq_rel))
+    {
+      retired_.store(active, std::memory_order_release);
+      active_.store(next, std::memory_order_release);
+      active = next;
+    }
+  }
+  active->write(time.nanoseconds(), values_.data());
+  return controller_interface::return_type::OK;
+}
+
+std::unique_ptr<RecordFile> StateRecorderController::createFile()
+{
+  char index[8];
+  snprintf(index, sizeof(index), "%03d", file_index_++);
+  const std::string path =
+    (std::filesystem::path(params_.directory) / (session_ + "_" + index + ".rec")).string();
+
+  std::string error;
+  auto file = RecordFile::create(
+    path, columns_, static_cast<std::size_t>(params_.capacity), params_.lock_memory, error);
+  if (file == nullptr)
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "%s", error.c_str());
+    std::error_code remove_error;
+    std::filesystem::remove(path, remove_error);
+  }
+  return file;
+}
+
+void StateRecorderController::closeFile(std::unique_ptr<RecordFile> file)
+{
+  file->flush(true);
+  closed_files_.push_back(file->path());
+}
+
+void StateRecorderController::removeOldFiles(std::size_t open_files)
+{
+  const auto max_files = static_cast<std::size_t>(params_.max_files);
+  while (max_files > 0 && !closed_files_.empty() && closed_files_.size() + open_files > max_files)
+  {
+    std::error_code error;
+    std::filesystem::remove(closed_files_.front(), error);
+    closed_files_.pop_front();
+  }
+}
+
+void StateRecorderController::writerLoop()
+{
+  auto last_flush = std::chrono::steady_clock::now();
+  const auto flush_period = std::chrono::duration<double>(params_.flush_period);
+  bool creation_failed = false;
+  while (recording_)
+  {
+    std::unique_ptr<RecordFile> retired(retired_.exchange(nullptr, std::memory_order_acq_rel));
+    const bool file_closed = retired != nullptr;
+    if (file_closed)
+    {
+      closeFile(std::move(retired));
+    }
+
+    if (params_.rotate && !creation_failed && standby_.load(std::memory_order_acquire) == nullptr)
+    {
+      auto next = createFile();
+      // Without a new file the oldest cycles of the active file are overwritten
+      creation_failed = next == nullptr;
+      standby_.store(next.release(), std::memory_order_release);
+    }
+
+    if (file_closed)
+    {
+      // The prepared file is also on the disk besides the active one
+      removeOldFiles(standby_.load(std::memory_order_acquire) != nullptr ? 2 : 1);
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now - last_flush >= flush_period)
+    {
+      active_.load(std::memory_order_acquire)->flush(false);
+      last_flush = now;
+    }
+    std::this_thread::sleep_for(WRITER_PERIOD);
+  }
+}
+
+void StateRecorderController::stopRecording()
+{
+  recording_ = false;
+  if (writer_thread_.joinable())
+  {
+    writer_thread_.join();
+  }
+
+  std::unique_ptr<RecordFile> retired(retired_.exchange(nullptr));
+  if (retired != nullptr)
+  {
+    closeFile(std::move(retired));
+  }
+  std::unique_ptr<RecordFile> active(active_.exchange(nullptr));
+  if (active != nullptr)
+  {
+    closeFile(std::move(active));
+  }
+  removeOldFiles(0);
+
+  // The prepared file was never written
+  std::unique_ptr<RecordFile> standby(standby_.exchange(nullptr));
+  if (standby != nullptr)
+  {
+    const std::string path = standby->path();
+    standby.reset();
+    std::error_code error;
+    std::filesystem::remove(path, error);
+  }
+}
+}  // namespace kuka_controllers
+
+PLUGINLIB_EXPORT_CLASS(
+  kuka_controllers::StateRecorderController, controller_interface::ControllerInterface)
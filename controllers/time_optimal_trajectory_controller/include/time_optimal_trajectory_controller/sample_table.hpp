@@ -0,0 +1,89 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TIME_OPTIMAL_TRAJECTORY_CONTROLLER__SAMPLE_TABLE_HPP_
+#define TIME_OPTIMAL_TRAJECTORY_CONTROLLER__SAMPLE_TABLE_HPP_
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace kuka_controllers
+{
+/**
+ * @brief Joint positions, velocities and accelerations of a trajectory sampled in every control
+ *  cycle
+ *
+ * A sample is stored contiguously in the order of positions, velocities and accelerations, so the
+ *  interpolation between two samples is a single expression over all channels, evaluated with the
+ *  SIMD packets of Eigen.
+ */
+class SampleTable
+{
+public:
+  SampleTable(std::size_t joints, double period) : joints_(joints), period_(period) {}
+
+  void resize(std::size_t samples) { data_.assign(samples * channels(), 0.0); }
+
+  std::size_t joints() const { return joints_; }
+  std::size_t channels() const { return 3 * joints_; }
+  std::size_t size() const { return data_.size() / channels(); }
+  double period() const { return period_; }
+  double duration() const { return size() > 0 ? (size() - 1) * period_ : 0.0; }
+
+  double * sample(std::size_t index) { return data_.data() + index * channels(); }
+  const double * sample(std::size_t index) const { return data_.data() + index * channels(); }
+
+  const double * positions(std::size_t index) const { return sample(index); }
+  const double * velocities(std::size_t index) const { return sample(index) + joints_; }
+  const double * accelerations(std::size_t index) const { return sample(index) + 2 * joints_; }
+
+  /**
+   * @brief Interpolates linearly between the samples around the given time
+   *
+   * Before the first sample the first one is returned, after the last sample the last one is held.
+   *  The table must not be empty.
+   *
+   * @param t: Time relative to the first sample
+   * @param values: Output array with channels() elements
+   */
+  void interpolate(double t, double * values) const
+  {
+    using ConstChannels = Eigen::Map<const Eigen::ArrayXd>;
+    const auto count = static_cast<Eigen::Index>(channels());
+    Eigen::Map<Eigen::ArrayXd> output(values, count);
+    const std::size_t last = size() - 1;
+    const double position = t > 0 ? t / period_ : 0.0;
+    const auto index = static_cast<std::size_t>(position);
+    if (index >= last)
+    {
+      output = ConstChannels(sample(last), count);
+      return;
+    }
+    const double fraction = position - std::floor(position);
+    const ConstChannels a(sample(index), count);
+    const ConstChannels b(sample(index + 1), count);
+    output = a + fraction * (b - a);
+  }
+
+private:
+  std::size_t joints_;
+  double period_;
+  std::vector<double> data_;
+};
+}  // namespace kuka_controllers
+
+#endif  // TIME_OPTIMAL_TRAJECTORY_CONTROLLER__SAMPLE_TABLE_HPP_
@@ -0,0 +1,159 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TIME_OPTIMAL_TRAJECTORY_CONTROLLER__TIME_OPTIMAL_TRAJECTORY_CONTROLLER_HPP_
+#define TIME_OPTIMAL_TRAJECTORY_CONTROLLER__TIME_OPTIMAL_TRAJECTORY_CONTROLLER_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "control_msgs/action/follow_joint_trajectory.hpp"
+#include "controller_interface/controller_interface.hpp"
+#include "pluginlib/class_list_macros.hpp"
+#include "rclcpp/duration.hpp"
+#include "rclcpp/time.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+#include "realtime_tools/realtime_buffer.h"
+
+#include "time_optimal_trajectory_controller/sample_table.hpp"
+#include "time_optimal_trajectory_controller/time_parameterization.hpp"
+#include "time_optimal_trajectory_controller/visibility_control.h"
+#include "time_optimal_trajectory_controller_parameters.hpp"
+
+namespace kuka_controllers
+{
+/**
+ * @brief Trajectory controller executing precomputed, time-optimal samples
+ *
+ * The waypoints of a goal are retimed on a worker thread with the fastest jerk-limited motion
+ *  along the path, which is stored as a table with one sample per control cycle. The control loop
+ *  only interpolates between two samples. A goal received during motion takes over at a future
+ *  sample of the active trajectory, continuing with its velocity, so consecutive moves are blended
+ *  without stopping.
+ */
+class TimeOptimalTrajectoryController : public controller_interface::ControllerInterface
+{
+public:
+  TIME_OPTIMAL_TRAJECTORY_CONTROLLER_PUBLIC ~TimeOptimalTrajectoryController() override;
+
+  TIME_OPTIMAL_TRAJECTORY_CONTROLLER_PUBLIC controller_interface::InterfaceConfiguration
+  command_interface_configuration() const override;
+
+  TIME_OPTIMAL_TRAJECTORY_CONTROLLER_PUBLIC controller_interface::InterfaceConfiguration
+  state_interface_configuration() const override;
+
+  TIME_OPTIMAL_TRAJECTORY_CONTROLLER_PUBLIC controller_interface::return_type update(
+    const rclcpp::Time & time, const rclcpp::Duration & period) override;
+
+  TIME_OPTIMAL_TRAJECTORY_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_configure(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  TIME_OPTIMAL_TRAJECTORY_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_activate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  TIME_OPTIMAL_TRAJECTORY_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_deactivate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  TIME_OPTIMAL_TRAJECTORY_CONTROLLER_PUBLIC controller_interface::CallbackReturn on_init()
+    override;
+
+private:
+  using FollowJointTrajectory = control_msgs::action::FollowJointTrajectory;
+  using GoalHandle = rclcpp_action::ServerGoalHandle<FollowJointTrajectory>;
+
+  // Precomputed trajectory, owned by the non-realtime side until the control loop moved past it
+  struct Plan
+  {
+    explicit Plan(const SampleTable & samples) : table(samples) {}
+
+    uint64_t id = 0;
+    SampleTable table;
+    // The plan takes over at this sample of the previous plan
+    uint64_t previous_id = 0;
+    std::size_t start_index = 0;
+    std::vector<std::vector<double>> waypoints;
+    std::vector<std::size_t> waypoint_samples;
+    std::shared_ptr<GoalHandle> goal_handle;
+    // Goal of the previous plan, which is finished when the given sample of this plan is reached
+    std::shared_ptr<GoalHandle> appended_goal_handle;
+    std::size_t appended_goal_sample = 0;
+  };
+
+  struct Request
+  {
+    std::shared_ptr<GoalHandle> goal_handle;
+    // Waypoints in the order of the controlled joints, empty for stopping
+    std::vector<std::vector<double>> waypoints;
+  };
+
+  TIME_OPTIMAL_TRAJECTORY_CONTROLLER_LOCAL rclcpp_action::GoalResponse handleGoal(
+    const rclcpp_action::GoalUUID & uuid, std::shared_ptr<const FollowJointTrajectory::Goal> goal);
+  TIME_OPTIMAL_TRAJECTORY_CONTROLLER_LOCAL rclcpp_action::CancelResponse handleCancel(
+    const std::shared_ptr<GoalHandle> goal_handle);
+  TIME_OPTIMAL_TRAJECTORY_CONTROLLER_LOCAL void handleAccepted(
+    std::shared_ptr<GoalHandle> goal_handle);
+
+  TIME_OPTIMAL_TRAJECTORY_CONTROLLER_LOCAL void plannerLoop();
+  TIME_OPTIMAL_TRAJECTORY_CONTROLLER_LOCAL std::shared_ptr<Plan> createPlan(
+    const Request & request, const Plan & previous);
+  TIME_OPTIMAL_TRAJECTORY_CONTROLLER_LOCAL void monitorGoals();
+  TIME_OPTIMAL_TRAJECTORY_CONTROLLER_LOCAL void stopPlanner();
+  TIME_OPTIMAL_TRAJECTORY_CONTROLLER_LOCAL void finishGoal(
+    const std::shared_ptr<GoalHandle> & goal_handle, int32_t error_code,
+    const std::string & error_string);
+
+  using Params = time_optimal_trajectory_controller::Params;
+  using ParamListener = time_optimal_trajectory_controller::ParamListener;
+
+  std::shared_ptr<ParamListener> param_listener_;
+  Params params_;
+
+  std::unique_ptr<TimeParameterization> parameterization_;
+  double sample_period_ = 0;
+
+  rclcpp_action::Server<FollowJointTrajectory>::SharedPtr action_server_;
+  rclcpp::TimerBase::SharedPtr monitor_timer_;
+
+  // Requests and plans are shared by the action callbacks, the monitor and the planner thread
+  std::mutex mutex_;
+  std::condition_variable request_condition_;
+  std::deque<Request> requests_;
+  std::deque<std::shared_ptr<Plan>> plans_;
+  uint64_t next_plan_id_ = 1;
+  std::thread planner_thread_;
+  std::atomic<bool> planning_{false};
+
+  // Handover of plans to the control loop
+  realtime_tools::RealtimeBuffer<const Plan *> plan_buffer_;
+  const Plan * active_plan_ = nullptr;
+  double plan_time_ = 0;
+  // Last plan checked for being in time, plans are identified by increasing ids
+  uint64_t checked_plan_id_ = 0;
+
+  // Progress of the control loop, read by the non-realtime side
+  std::atomic<uint64_t> active_plan_id_{0};
+  std::atomic<uint64_t> rejected_plan_id_{0};
+  std::atomic<std::size_t> active_index_{0};
+  std::unique_ptr<std::atomic<double>[]> actual_positions_;
+
+  std::vector<double> sample_values_;
+};
+}  // namespace kuka_controllers
+#endif  // TIME_OPTIMAL_TRAJECTORY_CONTROLLER__TIME_OPTIMAL_TRAJECTORY_CONTROLLER_HPP_
@@ -0,0 +1,105 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TIME_OPTIMAL_TRAJECTORY_CONTROLLER__TIME_PARAMETERIZATION_HPP_
+#define TIME_OPTIMAL_TRAJECTORY_CONTROLLER__TIME_PARAMETERIZATION_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "time_optimal_trajectory_controller/sample_table.hpp"
+
+namespace kuka_controllers
+{
+/**
+ * @brief Time-optimal parameterization of a joint space path under velocity, acceleration and
+ *  jerk limits
+ *
+ * The path is a cubic spline through the waypoints, parameterized by the chord length. The fastest
+ *  velocity profile along the path respecting the velocity and acceleration limits is found by a
+ *  backward and a forward pass over a fine grid of the path (reachability analysis). The profile is
+ *  sampled in every cycle and its increments are smoothed with a moving average, which limits the
+ *  jerk without leaving the path. Limits violated by the smoothing are reduced and the calculation
+ *  is repeated.
+ */
+class TimeParameterization
+{
+public:
+  struct Limits
+  {
+    std::vector<double> velocity;
+    std::vector<double> acceleration;
+    // Zero or negative values disable the jerk limit of the joint
+    std::vector<double> jerk;
+  };
+
+  /**
+   * @param limits: Limits of every joint, velocity and acceleration limits must be positive
+   * @param period: Period of the samples
+   * @param path_resolution: Grid size along the path, in joint space distance [rad]
+   * @exception std::invalid_argument: the limits or the resolution are invalid
+   */
+  TimeParameterization(const Limits & limits, double period, double path_resolution);
+
+  /**
+   * @brief Calculates the samples of the fastest motion along the spline through the waypoints
+   *
+   * @param waypoints: Joint positions indexed as [waypoint][joint], the first one is the start
+   * @param start_velocity: Joint velocities at the start, the spline leaves the first waypoint in
+   *  this direction. Empty or zero for a start from standstill.
+   * @param stop: Come to a stop as soon as possible along the path instead of reaching its end
+   * @param table: Output samples, the first one is at the first waypoint
+   * @param waypoint_samples: Output index of the first sample at or after each waypoint
+   * @exception std::invalid_argument: the waypoints are inconsistent, the path cannot be followed
+   *  from the start velocity within the limits or the samples still exceed the limits after the
+   *  refinement, the message names the most violated limit
+   */
+  void compute(
+    const std::vector<std::vector<double>> & waypoints, const std::vector<double> & start_velocity,
+    bool stop, SampleTable & table, std::vector<std::size_t> & waypoint_samples) const;
+
+private:
+  // Geometric path: spline segments between the waypoints with polynomial coefficients
+  struct Path
+  {
+    std::vector<double> knots;
+    // Coefficients indexed as [(segment * joints + joint) * 4 + order]
+    std::vector<double> coefficients;
+    std::size_t joints = 0;
+
+    double length() const { return knots.back(); }
+    void evaluate(
+      double s, std::size_t & segment_hint, double * q, double * dq, double * ddq) const;
+  };
+
+  Path createPath(
+    const std::vector<std::vector<double>> & waypoints, const std::vector<double> & tangent) const;
+
+  void sampleProfile(
+    const Path & path, const std::vector<double> & velocity_limits,
+    const std::vector<double> & acceleration_limits, double filter_time, double start_speed,
+    bool stop, SampleTable & table, std::vector<double> & path_positions) const;
+
+  // Calculates the maximum ratio of the velocities, accelerations and jerks to their limits
+  void measure(
+    const SampleTable & table, double & velocity_ratio, double & acceleration_ratio,
+    double & jerk_ratio) const;
+
+  Limits limits_;
+  double period_;
+  double path_resolution_;
+};
+}  // namespace kuka_controllers
+
+#endif  // TIME_OPTIMAL_TRAJECTORY_CONTROLLER__TIME_PARAMETERIZATION_HPP_
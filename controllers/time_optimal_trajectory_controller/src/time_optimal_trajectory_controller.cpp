@@ -0,0 +1,609 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <stdexcept>
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+
+#include "time_optimal_trajectory_controller/time_optimal_trajectory_controller.hpp"
+
+namespace kuka_controllers
+{
+namespace
+{
+// A goal starting at the end of the previous goal is appended to it [rad]
+constexpr double APPEND_TOLERANCE = 1e-3;
+// Period of checking whether the control loop has taken over the previous plan
+constexpr std::chrono::milliseconds HANDOVER_CHECK_PERIOD(1);
+}  // namespace
+
+TimeOptimalTrajectoryController::~TimeOptimalTrajectoryController() { stopPlanner(); }
+
+controller_interface::CallbackReturn TimeOptimalTrajectoryController::on_init()
+{
+  try
+  {
+    param_listener_ = std::make_shared<ParamListener>(get_node());
+    params_ = param_listener_->get_params();
+  }
+  catch (const std::exception & e)
+  {
+    fprintf(stderr, "Exception thrown during init stage with message: %s \n", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::InterfaceConfiguration
+TimeOptimalTrajectoryController::command_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_POSITION);
+  }
+  return config;
+}
+
+controller_interface::InterfaceConfiguration
+TimeOptimalTrajectoryController::state_interface_configuration() const
+{
+  controller_interface::InterfaceConfiguration config;
+  config.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto & joint : params_.joints)
+  {
+    config.names.emplace_back(joint + "/" + hardware_interface::HW_IF_POSITION);
+  }
+  return config;
+}
+
+controller_interface::CallbackReturn TimeOptimalTrajectoryController::on_configure(
+  const rclcpp_lifecycle::State &)
+{
+  params_ = param_listener_->get_params();
+  const std::size_t joints = params_.joints.size();
+  if (joints == 0)
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "'joints' parameter is empty");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  if (
+    params_.max_velocity.size() != joints || params_.max_acceleration.size() != joints ||
+    params_.max_jerk.size() != joints)
+  {
+    RCLCPP_ERROR(
+      get_node()->get_logger(),
+      "'max_velocity', 'max_acceleration' and 'max_jerk' must contain a limit for every joint");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+
+  // The samples are calculated with the period of the control loop
+  sample_period_ = 1.0 / get_update_rate();
+  try
+  {
+    parameterization_ = std::make_unique<TimeParameterization>(
+      TimeParameterization::Limits{
+        params_.max_velocity, params_.max_acceleration, params_.max_jerk},
+      sample_period_, params_.path_resolution);
+  }
+  catch (const std::invalid_argument & e)
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "Invalid limits: %s", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+
+  sample_values_.assign(3 * joints, 0.0);
+  actual_positions_.reset(new std::atomic<double>[joints]);
+  for (std::size_t i = 0; i < joints; ++i)
+  {
+    actual_positions_[i].store(0.0);
+  }
+
+  action_server_ = rclcpp_action::create_server<FollowJointTrajectory>(
+    get_node()->get_node_base_interface(), get_node()->get_node_clock_interface(),
+    get_node()->get_node_logging_interface(), get_node()->get_node_waitables_interface(),
+    std::string(get_node()->get_name()) + "/follow_joint_trajectory",
+    [this](
+      const rclcpp_action::GoalUUID & uuid,
+      std::shared_ptr<const FollowJointTrajectory::Goal> goal) { return handleGoal(uuid, goal); },
+    [this](const std::shared_ptr<GoalHandle> goal_handle) { return handleCancel(goal_handle); },
+    [this](std::shared_ptr<GoalHandle> goal_handle) { handleAccepted(goal_handle); });
+
+  RCLCPP_INFO(get_node()->get_logger(), "Time-optimal trajectory controller configured");
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn TimeOptimalTrajectoryController::on_activate(
+  const rclcpp_lifecycle::State &)
+{
+  // Hold the measured positions until the first goal arrives
+  const std::size_t joints = params_.joints.size();
+  SampleTable table(joints, sample_period_);
+  table.resize(1);
+  for (std::size_t i = 0; i < joints; ++i)
+  {
+    table.sample(0)[i] = state_interfaces_[i].get_value();
+  }
+  auto hold = std::make_shared<Plan>(table);
+  hold->waypoints.emplace_back(table.positions(0), table.positions(0) + joints);
+  hold->waypoint_samples.push_back(0);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    requests_.clear();
+    plans_.clear();
+    hold->id = next_plan_id_++;
+    plans_.push_back(hold);
+  }
+
+  active_plan_ = hold.get();
+  plan_time_ = 0;
+  checked_plan_id_ = hold->id;
+  active_plan_id_.store(hold->id);
+  rejected_plan_id_.store(0);
+  active_index_.store(0);
+  plan_buffer_.writeFromNonRT(hold.get());
+
+  planning_ = true;
+  planner_thread_ = std::thread(&TimeOptimalTrajectoryController::plannerLoop, this);
+  monitor_timer_ = get_node()->create_wall_timer(
+    std::chrono::duration<double>(1.0 / params_.action_monitor_rate), [this]() { monitorGoals(); });
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn TimeOptimalTrajectoryController::on_deactivate(
+  const rclcpp_lifecycle::State &)
+{
+  monitor_timer_.reset();
+  stopPlanner();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const std::string reason = "Controller was deactivated";
+  for (const auto & request : requests_)
+  {
+    finishGoal(request.goal_handle, FollowJointTrajectory::Result::INVALID_GOAL, reason);
+  }
+  for (const auto & plan : plans_)
+  {
+    finishGoal(plan->goal_handle, FollowJointTrajectory::Result::INVALID_GOAL, reason);
+    finishGoal(plan->appended_goal_handle, FollowJointTrajectory::Result::INVALID_GOAL, reason);
+  }
+  requests_.clear();
+  plans_.clear();
+  active_plan_ = nullptr;
+  plan_buffer_.writeFromNonRT(nullptr);
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::return_type TimeOptimalTrajectoryController::update(
+  const rclcpp::Time &, const rclcpp::Duration & period)
+{
+  const Plan * pending = *plan_buffer_.readFromRT();
+  if (pending != nullptr && pending->id > active_plan_->id)
+  {
+    const double start_time = static_cast<double>(pending->start_index) * sample_period_;
+    if (pending->id != checked_plan_id_)
+    {
+      checked_plan_id_ = pending->id;
+      // The plan continues from the state at its start sample, which must not have been passed
+      const bool moving = pending->start_index + 1 < active_plan_->table.size();
+      if (pending->previous_id != active_plan_->id || (moving && plan_time_ > start_time))
+      {
+        rejected_plan_id_.store(pending->id, std::memory_order_release);
+      }
+    }
+    if (
+      rejected_plan_id_.load(std::memory_order_relaxed) != pending->id && plan_time_ >= start_time)
+    {
+      // After the end of the previous plan the new one starts immediately
+      plan_time_ = std::clamp(plan_time_ - start_time, 0.0, sample_period_);
+      active_plan_ = pending;
+      active_plan_id_.store(pending->id, std::memory_order_release);
+    }
+  }
+
+  active_plan_->table.interpolate(plan_time_, sample_values_.data());
+  const std::size_t joints = params_.joints.size();
+  for (std::size_t i = 0; i < joints; ++i)
+  {
+    command_interfaces_[i].set_value(sample_values_[i]);
+    actual_positions_[i].store(state_interfaces_[i].get_value(), std::memory_order_relaxed);
+  }
+  active_index_.store(
+    std::min(
+      active_plan_->table.size() - 1, static_cast<std::size_t>(plan_time_ / sample_period_)),
+    std::memory_order_release);
+  plan_time_ += period.seconds();
+  return controller_interface::return_type::OK;
+}
+
+rclcpp_action::GoalResponse TimeOptimalTrajectoryController::handleGoal(
+  const rclcpp_action::GoalUUID &, std::shared_ptr<const FollowJointTrajectory::Goal> goal)
+{
+  if (!planning_)
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "Controller is not active, rejecting goal");
+    return rclcpp_action::GoalResponse::REJECT;
+  }
+  const auto & trajectory = goal->trajectory;
+  if (trajectory.points.empty())
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "Received trajectory without points, rejecting goal");
+    return rclcpp_action::GoalResponse::REJECT;
+  }
+  for (const auto & joint : params_.joints)
+  {
+    if (
+      std::find(trajectory.joint_names.begin(), trajectory.joint_names.end(), joint) ==
+      trajectory.joint_names.end())
+    {
+      RCLCPP_ERROR(
+        get_node()->get_logger(), "Joint '%s' is missing from the trajectory, rejecting goal",
+        joint.c_str());
+      return rclcpp_action::GoalResponse::REJECT;
+    }
+  }
+  for (const auto & point : trajectory.points)
+  {
+    if (point.positions.size() != trajectory.joint_names.size())
+    {
+      RCLCPP_ERROR(
+        get_node()->get_logger(),
+        "Every trajectory point must contain positions for all joints, rejecting goal");
+      return rclcpp_action::GoalResponse::REJECT;
+    }
+  }
+  return rclcpp_action::GoalResponse::ACCEPT_AND_EXECUTE;
+}
+
+rclcpp_action::CancelResponse TimeOptimalTrajectoryController::handleCancel(
+  const std::shared_ptr<GoalHandle>)
+{
+  // The motion is stopped by the monitor, after the goal changed to canceling state
+  return rclcpp_action::CancelResponse::ACCEPT;
+}
+
+void TimeOptimalTrajectoryController::handleAccepted(std::shared_ptr<GoalHandle> goal_handle)
+{
+  // Map the joints of the goal to the order of the controlled joints, the timing is not used
+  const auto & trajectory = goal_handle->get_goal()->trajectory;
+  const std::size_t joints = params_.joints.size();
+  std::vector<std::size_t> goal_index(joints);
+  for (std::size_t i = 0; i < joints; ++i)
+  {
+    goal_index[i] = static_cast<std::size_t>(std::distance(
+      trajectory.joint_names.begin(),
+      std::find(trajectory.joint_names.begin(), trajectory.joint_names.end(), params_.joints[i])));
+  }
+
+  Request request{goal_handle, {}};
+  for (const auto & point : trajectory.points)
+  {
+    std::vector<double> waypoint(joints);
+    for (std::size_t i = 0; i < joints; ++i)
+    {
+      waypoint[i] = point.positions[goal_index[i]];
+    }
+    request.waypoints.push_back(std::move(waypoint));
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    requests_.push_back(std::move(request));
+  }
+  request_condition_.notify_one();
+}
+
+void TimeOptimalTrajectoryController::plannerLoop()
+{
+  while (true)
+  {
+    Request request;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      request_condition_.wait(lock, [this]() { return !planning_ || !requests_.empty(); });
+      if (!planning_)
+      {
+        return;
+      }
+      request = std::move(requests_.front());
+      requests_.pop_front();
+    }
+    if (request.goal_handle && request.goal_handle->is_canceling())
+    {
+      request.goal_handle->canceled(std::make_shared<FollowJointTrajectory::Result>());
+      continue;
+    }
+
+    // A new plan always continues the active one, so the previous plan must have been taken over
+    //  or rejected by the control loop
+    std::shared_ptr<Plan> previous;
+    while (planning_ && previous == nullptr)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const uint64_t latest = plans_.back()->id;
+        const uint64_t active = active_plan_id_.load(std::memory_order_acquire);
+        if (latest == active || latest == rejected_plan_id_.load(std::memory_order_acquire))
+        {
+          previous = *std::find_if(
+            plans_.begin(), plans_.end(),
+            [active](const auto & plan) { return plan->id == active; });
+          break;
+        }
+      }
+      std::this_thread::sleep_for(HANDOVER_CHECK_PERIOD);
+    }
+    if (previous == nullptr)
+    {
+      finishGoal(
+        request.goal_handle, FollowJointTrajectory::Result::INVALID_GOAL,
+        "Controller was deactivated");
+      continue;
+    }
+
+    auto plan = createPlan(request, *previous);
+    if (plan == nullptr)
+    {
+      continue;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    plan->id = next_plan_id_++;
+    plans_.push_back(plan);
+    plan_buffer_.writeFromNonRT(plan.get());
+  }
+}
+
+std::shared_ptr<TimeOptimalTrajectoryController::Plan> TimeOptimalTrajectoryController::createPlan(
+  const Request & request, const Plan & previous)
+{
+  const bool stop = request.waypoints.empty();
+  const std::size_t last = previous.table.size() - 1;
+  const auto delay = static_cast<std::size_t>(std::ceil(params_.blend_delay / sample_period_));
+  const std::size_t blend_index = std::min(active_index_.load() + delay, last);
+  if (stop && blend_index == last)
+  {
+    // The previous plan already comes to a stop before the motion could be changed
+    return nullptr;
+  }
+
+  const std::size_t joints = params_.joints.size();
+  const auto start = std::chrono::steady_clock::now();
+  // If blending fails, the new trajectory starts from the end of the previous one
+  for (std::size_t start_index : {blend_index, last})
+  {
+    if (start_index != blend_index && (stop || blend_index == last))
+    {
+      break;
+    }
+
+    const double * position = previous.table.positions(start_index);
+    const double * velocity = previous.table.velocities(start_index);
+    std::vector<std::vector<double>> waypoints{std::vector<double>(position, position + joints)};
+    std::vector<std::size_t> remaining;
+    for (std::size_t w = 0; w < previous.waypoints.size(); ++w)
+    {
+      if (previous.waypoint_samples[w] > start_index)
+      {
+        remaining.push_back(w);
+      }
+    }
+
+    // The rest of the previous path is kept if the motion is stopped or the goal continues it
+    bool append = stop;
+    if (!stop && previous.goal_handle && previous.goal_handle->is_active() && !remaining.empty())
+    {
+      double distance = 0;
+      for (std::size_t i = 0; i < joints; ++i)
+      {
+        distance = std::max(
+          distance, std::abs(previous.waypoints.back()[i] - request.waypoints.front()[i]));
+      }
+      append = distance < APPEND_TOLERANCE;
+    }
+    if (append)
+    {
+      for (const std::size_t w : remaining)
+      {
+        waypoints.push_back(previous.waypoints[w]);
+      }
+    }
+    const std::size_t appended_waypoint = waypoints.size() - 1;
+    waypoints.insert(waypoints.end(), request.waypoints.begin(), request.waypoints.end());
+
+    SampleTable table(joints, sample_period_);
+    std::vector<std::size_t> waypoint_samples;
+    try
+    {
+      parameterization_->compute(
+        waypoints, std::vector<double>(velocity, velocity + joints), stop, table,
+        waypoint_samples);
+    }
+    catch (const std::invalid_argument & e)
+    {
+      RCLCPP_WARN(
+        get_node()->get_logger(), "Failed to calculate trajectory from sample %zu: %s",
+        start_index, e.what());
+      continue;
+    }
+    if (start_index < last && active_index_.load() + 1 >= start_index)
+    {
+      RCLCPP_WARN(
+        get_node()->get_logger(),
+        "Calculating the trajectory took longer than 'blend_delay', starting after the actual "
+        "motion");
+      continue;
+    }
+
+    auto plan = std::make_shared<Plan>(table);
+    plan->previous_id = previous.id;
+    plan->start_index = start_index;
+    plan->waypoints = std::move(waypoints);
+    plan->waypoint_samples = std::move(waypoint_samples);
+    plan->goal_handle = request.goal_handle;
+    if (append && !stop && !remaining.empty())
+    {
+      plan->appended_goal_handle = previous.goal_handle;
+      plan->appended_goal_sample = plan->waypoint_samples[appended_waypoint];
+    }
+    RCLCPP_DEBUG(
+      get_node()->get_logger(), "Calculated trajectory of %.3f s in %.1f ms",
+      plan->table.duration(),
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    return plan;
+  }
+
+  finishGoal(
+    request.goal_handle, FollowJointTrajectory::Result::INVALID_GOAL,
+    "Trajectory cannot be executed within the limits");
+  return nullptr;
+}
+
+void TimeOptimalTrajectoryController::monitorGoals()
+{
+  const uint64_t active_id = active_plan_id_.load(std::memory_order_acquire);
+  const uint64_t rejected_id = rejected_plan_id_.load(std::memory_order_acquire);
+  const std::size_t index = active_index_.load(std::memory_order_acquire);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  bool stop_requested = false;
+  for (const auto & plan : plans_)
+  {
+    // The rejected plan may still be read by the control loop until a new plan is passed to it
+    if (plan->id == rejected_id && plan->goal_handle)
+    {
+      finishGoal(
+        plan->goal_handle, FollowJointTrajectory::Result::INVALID_GOAL,
+        "Trajectory was not ready in time, 'blend_delay' should be increased");
+      plan->goal_handle.reset();
+    }
+
+    for (auto * goal_handle : {&plan->goal_handle, &plan->appended_goal_handle})
+    {
+      if (*goal_handle && (*goal_handle)->is_canceling())
+      {
+        (*goal_handle)->canceled(std::make_shared<FollowJointTrajectory::Result>());
+        goal_handle->reset();
+        stop_requested |= plan->id >= active_id;
+      }
+    }
+
+    if (plan->id < active_id && plan->goal_handle)
+    {
+      // The goal is continued by a later plan or it was replaced
+      const bool appended = std::any_of(
+        plans_.begin(), plans_.end(),
+        [&plan](const auto & other) { return other->appended_goal_handle == plan->goal_handle; });
+      if (!appended)
+      {
+        finishGoal(
+          plan->goal_handle, FollowJointTrajectory::Result::INVALID_GOAL,
+          "Goal was replaced by a new goal");
+      }
+      plan->goal_handle.reset();
+    }
+    if (plan->id != active_id)
+    {
+      continue;
+    }
+
+    if (plan->appended_goal_handle && index >= plan->appended_goal_sample)
+    {
+      finishGoal(plan->appended_goal_handle, FollowJointTrajectory::Result::SUCCESSFUL, "");
+      plan->appended_goal_handle.reset();
+    }
+    if (!plan->goal_handle)
+    {
+      continue;
+    }
+    if (index + 1 >= plan->table.size())
+    {
+      finishGoal(plan->goal_handle, FollowJointTrajectory::Result::SUCCESSFUL, "");
+      plan->goal_handle.reset();
+      continue;
+    }
+
+    auto feedback = std::make_shared<FollowJointTrajectory::Feedback>();
+    const std::size_t joints = params_.joints.size();
+    feedback->header.stamp = get_node()->now();
+    feedback->joint_names = params_.joints;
+    const double * positions = plan->table.positions(index);
+    feedback->desired.positions.assign(positions, positions + joints);
+    const double * velocities = plan->table.velocities(index);
+    feedback->desired.velocities.assign(velocities, velocities + joints);
+    const double * accelerations = plan->table.accelerations(index);
+    feedback->desired.accelerations.assign(accelerations, accelerations + joints);
+    for (std::size_t i = 0; i < joints; ++i)
+    {
+      const double actual = actual_positions_[i].load(std::memory_order_relaxed);
+      feedback->actual.positions.push_back(actual);
+      feedback->error.positions.push_back(positions[i] - actual);
+    }
+    plan->goal_handle->publish_feedback(feedback);
+  }
+
+  // Plans passed by the control loop are not used anymore
+  while (plans_.size() > 1 && plans_.front()->id < active_id)
+  {
+    plans_.pop_front();
+  }
+
+  if (stop_requested)
+  {
+    requests_.push_back(Request{});
+    request_condition_.notify_one();
+  }
+}
+
+void TimeOptimalTrajectoryController::stopPlanner()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    planning_ = false;
+  }
+  request_condition_.notify_all();
+  if (planner_thread_.joinable())
+  {
+    planner_thread_.join();
+  }
+}
+
+void TimeOptimalTrajectoryController::finishGoal(
+  const std::shared_ptr<GoalHandle> & goal_handle, int32_t error_code,
+  const std::string & error_string)
+{
+  if (!goal_handle || !goal_handle->is_active())
+  {
+    return;
+  }
+  auto result = std::make_shared<FollowJointTrajectory::Result>();
+  result->error_code = error_code;
+  result->error_string = error_string;
+  if (error_code == FollowJointTrajectory::Result::SUCCESSFUL)
+  {
+    goal_handle->succeed(result);
+  }
+  else
+  {
+    goal_handle->abort(result);
+  }
+}
+}  // namespace kuka_controllers
+
+PLUGINLIB_EXPORT_CLASS(
+  kuka_controllers::TimeOptimalTrajectoryController, controller_interface::ControllerInterface)
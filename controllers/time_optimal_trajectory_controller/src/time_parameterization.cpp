@@ -0,0 +1,566 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "time_optimal_trajectory_controller/time_parameterization.hpp"
+
+namespace kuka_controllers
+{
+namespace
+{
+// Waypoints closer to each other are merged
+constexpr double MIN_WAYPOINT_DISTANCE = 1e-9;
+// Path derivatives below this value do not constrain the path acceleration
+constexpr double MIN_DERIVATIVE = 1e-9;
+// Relative violation of the limits accepted without repeating the calculation
+constexpr double TOLERANCE = 0.01;
+constexpr int MAX_ITERATIONS = 4;
+constexpr double INF = std::numeric_limits<double>::infinity();
+}  // namespace
+
+TimeParameterization::TimeParameterization(
+  const Limits & limits, double period, double path_resolution)
+: limits_(limits), period_(period), path_resolution_(path_resolution)
+{
+  const std::size_t joints = limits.velocity.size();
+  if (joints == 0 || limits.acceleration.size() != joints || limits.jerk.size() != joints)
+  {
+    throw std::invalid_argument("Limits must be given for every joint");
+  }
+  for (std::size_t j = 0; j < joints; ++j)
+  {
+    if (limits.velocity[j] <= 0 || limits.acceleration[j] <= 0)
+    {
+      throw std::invalid_argument("Velocity and acceleration limits must be positive");
+    }
+  }
+  if (period <= 0 || path_resolution <= 0)
+  {
+    throw std::invalid_argument("Period and path resolution must be positive");
+  }
+}
+
+void TimeParameterization::compute(
+  const std::vector<std::vector<double>> & waypoints, const std::vector<double> & start_velocity,
+  bool stop, SampleTable & table, std::vector<std::size_t> & waypoint_samples) const
+{
+  const std::size_t joints = limits_.velocity.size();
+  if (waypoints.empty())
+  {
+    throw std::invalid_argument("Path has no waypoints");
+  }
+  for (const auto & waypoint : waypoints)
+  {
+    if (waypoint.size() != joints)
+    {
+      throw std::invalid_argument("Every waypoint must contain a position for every joint");
+    }
+  }
+  if (!start_velocity.empty() && start_velocity.size() != joints)
+  {
+    throw std::invalid_argument("Start velocity must be given for every joint");
+  }
+
+  // Merge coinciding waypoints, as the chord length parameterization needs distinct knots
+  std::vector<std::vector<double>> knots{waypoints.front()};
+  std::vector<std::size_t> waypoint_knots(waypoints.size(), 0);
+  for (std::size_t w = 1; w < waypoints.size(); ++w)
+  {
+    double distance = 0;
+    for (std::size_t j = 0; j < joints; ++j)
+    {
+      distance += std::pow(waypoints[w][j] - knots.back()[j], 2);
+    }
+    if (std::sqrt(distance) > MIN_WAYPOINT_DISTANCE)
+    {
+      knots.push_back(waypoints[w]);
+    }
+    waypoint_knots[w] = knots.size() - 1;
+  }
+
+  double start_speed = 0;
+  for (const double velocity : start_velocity)
+  {
+    start_speed += velocity * velocity;
+  }
+  start_speed = std::sqrt(start_speed);
+  std::vector<double> tangent;
+  if (start_speed > MIN_DERIVATIVE)
+  {
+    for (const double velocity : start_velocity)
+    {
+      tangent.push_back(velocity / start_speed);
+    }
+  }
+  else
+  {
+    start_speed = 0;
+  }
+
+  if (knots.size() == 1)
+  {
+    if (start_speed > 0)
+    {
+      throw std::invalid_argument("Cannot stop at the start of the path");
+    }
+    table = SampleTable(joints, period_);
+    table.resize(1);
+    std::copy(knots.front().begin(), knots.front().end(), table.sample(0));
+    waypoint_samples.assign(waypoints.size(), 0);
+    return;
+  }
+
+  const Path path = createPath(knots, tangent);
+  std::vector<double> velocity_limits = limits_.velocity;
+  std::vector<double> acceleration_limits = limits_.acceleration;
+  // The moving average spreads a change of the acceleration over the window, which bounds the
+  //  jerk of a full reversal of the acceleration
+  double filter_time = 0;
+  for (std::size_t j = 0; j < joints; ++j)
+  {
+    if (limits_.jerk[j] > 0)
+    {
+      filter_time = std::max(filter_time, 2 * limits_.acceleration[j] / limits_.jerk[j]);
+    }
+  }
+
+  SampleTable candidate(joints, period_);
+  std::vector<double> path_positions;
+  std::vector<double> candidate_positions;
+  double velocity_ratio = 0;
+  double acceleration_ratio = 0;
+  double jerk_ratio = 0;
+  for (int iteration = 0; iteration < MAX_ITERATIONS; ++iteration)
+  {
+    try
+    {
+      sampleProfile(
+        path, velocity_limits, acceleration_limits, filter_time, start_speed, stop, candidate,
+        candidate_positions);
+    }
+    catch (const std::invalid_argument &)
+    {
+      // Reduced limits may not allow the start velocity anymore, keep the previous result
+      if (iteration == 0)
+      {
+        throw;
+      }
+      break;
+    }
+    std::swap(table, candidate);
+    std::swap(path_positions, candidate_positions);
+
+    measure(table, velocity_ratio, acceleration_ratio, jerk_ratio);
+    if (
+      velocity_ratio <= 1 + TOLERANCE && acceleration_ratio <= 1 + TOLERANCE &&
+      jerk_ratio <= 1 + TOLERANCE)
+    {
+      break;
+    }
+    for (std::size_t j = 0; j < joints; ++j)
+    {
+      velocity_limits[j] /= std::max(1.0, velocity_ratio);
+      acceleration_limits[j] /= std::max(1.0, acceleration_ratio);
+    }
+    filter_time *= std::max(1.0, jerk_ratio);
+  }
+
+  // The refinement may not converge, a table still violating the limits must not be executed
+  const char * limit = "velocity";
+  double ratio = velocity_ratio;
+  if (acceleration_ratio > ratio)
+  {
+    limit = "acceleration";
+    ratio = acceleration_ratio;
+  }
+  if (jerk_ratio > ratio)
+  {
+    limit = "jerk";
+    ratio = jerk_ratio;
+  }
+  if (ratio > 1 + TOLERANCE)
+  {
+    throw std::invalid_argument(
+      "Trajectory exceeds the " + std::string(limit) + " limit by " +
+      std::to_string(static_cast<int>(std::ceil(100 * (ratio - 1)))) + " %");
+  }
+
+  waypoint_samples.resize(waypoints.size());
+  for (std::size_t w = 0; w < waypoints.size(); ++w)
+  {
+    const double s = path.knots[waypoint_knots[w]] - MIN_WAYPOINT_DISTANCE;
+    const auto it = std::lower_bound(path_positions.begin(), path_positions.end(), s);
+    waypoint_samples[w] = std::min(
+      static_cast<std::size_t>(std::distance(path_positions.begin(), it)), table.size() - 1);
+  }
+}
+
+TimeParameterization::Path TimeParameterization::createPath(
+  const std::vector<std::vector<double>> & waypoints, const std::vector<double> & tangent) const
+{
+  Path path;
+  path.joints = waypoints.front().size();
+  const std::size_t knots = waypoints.size();
+  const std::size_t segments = knots - 1;
+
+  path.knots.assign(knots, 0.0);
+  std::vector<double> h(segments);
+  for (std::size_t i = 0; i < segments; ++i)
+  {
+    double distance = 0;
+    for (std::size_t j = 0; j < path.joints; ++j)
+    {
+      distance += std::pow(waypoints[i + 1][j] - waypoints[i][j], 2);
+    }
+    h[i] = std::sqrt(distance);
+    path.knots[i + 1] = path.knots[i] + h[i];
+  }
+
+  // Second derivatives (M) of the spline from a tridiagonal system, solved with the Thomas
+  //  algorithm. First row: given first derivative or M_0 = 0, last row: M_n = 0
+  const bool clamped = !tangent.empty();
+  std::vector<double> lower(knots, 0.0);
+  std::vector<double> pivot(knots, 1.0);
+  std::vector<double> upper_eliminated(knots, 0.0);
+  if (clamped)
+  {
+    pivot[0] = 2 * h[0];
+    upper_eliminated[0] = h[0] / pivot[0];
+  }
+  for (std::size_t i = 1; i < knots - 1; ++i)
+  {
+    lower[i] = h[i - 1];
+    pivot[i] = 2 * (h[i - 1] + h[i]) - lower[i] * upper_eliminated[i - 1];
+    upper_eliminated[i] = h[i] / pivot[i];
+  }
+
+  path.coefficients.resize(segments * path.joints * 4);
+  std::vector<double> rhs(knots);
+  std::vector<double> moments(knots);
+  for (std::size_t j = 0; j < path.joints; ++j)
+  {
+    rhs[0] = clamped ? 6 * ((waypoints[1][j] - waypoints[0][j]) / h[0] - tangent[j]) : 0.0;
+    for (std::size_t i = 1; i < knots - 1; ++i)
+    {
+      rhs[i] = 6 * ((waypoints[i + 1][j] - waypoints[i][j]) / h[i] -
+                    (waypoints[i][j] - waypoints[i - 1][j]) / h[i - 1]);
+    }
+    rhs[knots - 1] = 0;
+
+    moments[0] = rhs[0] / pivot[0];
+    for (std::size_t i = 1; i < knots; ++i)
+    {
+      moments[i] = (rhs[i] - lower[i] * moments[i - 1]) / pivot[i];
+    }
+    moments[knots - 1] = 0;
+    for (std::size_t i = knots - 1; i-- > 0;)
+    {
+      moments[i] -= upper_eliminated[i] * moments[i + 1];
+    }
+
+    for (std::size_t i = 0; i < segments; ++i)
+    {
+      double * c = &path.coefficients[(i * path.joints + j) * 4];
+      c[0] = waypoints[i][j];
+      c[1] = (waypoints[i + 1][j] - waypoints[i][j]) / h[i] -
+             h[i] * (2 * moments[i] + moments[i + 1]) / 6;
+      c[2] = moments[i] / 2;
+      c[3] = (moments[i + 1] - moments[i]) / (6 * h[i]);
+    }
+  }
+  return path;
+}
+
+void TimeParameterization::Path::evaluate(
+  double s, std::size_t & segment_hint, double * q, double * dq, double * ddq) const
+{
+  const std::size_t last = knots.size() - 2;
+  while (segment_hint < last && s > knots[segment_hint + 1])
+  {
+    ++segment_hint;
+  }
+  while (segment_hint > 0 && s < knots[segment_hint])
+  {
+    --segment_hint;
+  }
+  const double t = std::clamp(s, knots[segment_hint], knots[segment_hint + 1]) -
+                   knots[segment_hint];
+  for (std::size_t j = 0; j < joints; ++j)
+  {
+    const double * c = &coefficients[(segment_hint * joints + j) * 4];
+    q[j] = ((c[3] * t + c[2]) * t + c[1]) * t + c[0];
+    dq[j] = (3 * c[3] * t + 2 * c[2]) * t + c[1];
+    ddq[j] = 6 * c[3] * t + 2 * c[2];
+  }
+}
+
+void TimeParameterization::sampleProfile(
+  const Path & path, const std::vector<double> & velocity_limits,
+  const std::vector<double> & acceleration_limits, double filter_time, double start_speed,
+  bool stop, SampleTable & table, std::vector<double> & path_positions) const
+{
+  const std::size_t joints = path.joints;
+  const auto window = std::max<std::size_t>(1, std::lround(filter_time / period_));
+  // The causal moving average lags behind the unfiltered profile by half of the window, which
+  //  is compensated by starting the unfiltered profile ahead, at the speed of the start
+  const double history = start_speed * period_;
+  const double start = history * static_cast<double>(window - 1) / 2;
+  const double length = path.length() - start;
+  if (length <= 0)
+  {
+    throw std::invalid_argument("Path is too short to continue from the start velocity");
+  }
+
+  // Grid of the path with the derivatives of the path at the grid points
+  const auto intervals = std::max<std::size_t>(2, std::ceil(length / path_resolution_));
+  const double ds = length / static_cast<double>(intervals);
+  std::vector<double> q(joints);
+  std::vector<double> dq((intervals + 1) * joints);
+  std::vector<double> ddq((intervals + 1) * joints);
+  std::size_t segment = 0;
+  for (std::size_t i = 0; i <= intervals; ++i)
+  {
+    path.evaluate(start + i * ds, segment, q.data(), &dq[i * joints], &ddq[i * joints]);
+  }
+
+  // The joint acceleration is dq * u + ddq * x, where x is the square of the path speed and u is
+  //  the path acceleration. The limits bound u between the maximum of the lower bounds and the
+  //  minimum of the upper bounds, both linear in x.
+  auto accelerationBounds = [&](std::size_t i, double x, double & lower, double & upper)
+  {
+    lower = -INF;
+    upper = INF;
+    for (std::size_t j = 0; j < joints; ++j)
+    {
+      const double p = dq[i * joints + j];
+      if (std::abs(p) < MIN_DERIVATIVE)
+      {
+        continue;
+      }
+      const double c = ddq[i * joints + j];
+      double low = (-acceleration_limits[j] - c * x) / p;
+      double high = (acceleration_limits[j] - c * x) / p;
+      if (p < 0)
+      {
+        std::swap(low, high);
+      }
+      lower = std::max(lower, low);
+      upper = std::min(upper, high);
+    }
+  };
+
+  // Maximum of x, where the velocity limits hold and the acceleration bounds are consistent
+  std::vector<double> max_x(intervals + 1);
+  for (std::size_t i = 0; i <= intervals; ++i)
+  {
+    double limit = INF;
+    for (std::size_t j = 0; j < joints; ++j)
+    {
+      const double p = dq[i * joints + j];
+      const double c = ddq[i * joints + j];
+      if (std::abs(p) >= MIN_DERIVATIVE)
+      {
+        limit = std::min(limit, std::pow(velocity_limits[j] / p, 2));
+      }
+      else if (std::abs(c) >= MIN_DERIVATIVE)
+      {
+        limit = std::min(limit, acceleration_limits[j] / std::abs(c));
+      }
+    }
+    for (std::size_t j = 0; j < joints; ++j)
+    {
+      const double pj = dq[i * joints + j];
+      if (std::abs(pj) < MIN_DERIVATIVE)
+      {
+        continue;
+      }
+      const double slope_j = -ddq[i * joints + j] / pj;
+      const double lower_j = -acceleration_limits[j] / std::abs(pj);
+      for (std::size_t k = 0; k < joints; ++k)
+      {
+        const double pk = dq[i * joints + k];
+        if (k == j || std::abs(pk) < MIN_DERIVATIVE)
+        {
+          continue;
+        }
+        const double slope_k = -ddq[i * joints + k] / pk;
+        const double upper_k = acceleration_limits[k] / std::abs(pk);
+        if (slope_j > slope_k)
+        {
+          limit = std::min(limit, (upper_k - lower_j) / (slope_j - slope_k));
+        }
+      }
+    }
+    max_x[i] = limit;
+  }
+
+  // Backward pass: largest x at every grid point, from which the end can be reached in standstill
+  std::vector<double> reachable(intervals + 1);
+  reachable[intervals] = 0;
+  for (std::size_t i = intervals; i-- > 0;)
+  {
+    double limit = max_x[i];
+    for (std::size_t j = 0; j < joints; ++j)
+    {
+      const double p = dq[i * joints + j];
+      if (std::abs(p) < MIN_DERIVATIVE)
+      {
+        continue;
+      }
+      // x + 2 * ds * u_min(x) <= reachable[i + 1] with the bound of joint j
+      const double slope = -ddq[i * joints + j] / p;
+      const double offset = -acceleration_limits[j] / std::abs(p);
+      const double factor = 1 + 2 * ds * slope;
+      if (factor > 0)
+      {
+        limit = std::min(limit, (reachable[i + 1] - 2 * ds * offset) / factor);
+      }
+    }
+    reachable[i] = std::max(0.0, limit);
+  }
+
+  // Forward pass: maximum (or when stopping minimum) path acceleration within the reachable set
+  std::vector<double> x(intervals + 1, 0.0);
+  x[0] = start_speed * start_speed;
+  if (x[0] > reachable[0] * (1 + TOLERANCE))
+  {
+    throw std::invalid_argument("Path cannot be followed from the start velocity within limits");
+  }
+  x[0] = std::min(x[0], reachable[0]);
+  std::size_t end = stop && x[0] <= 0 ? 0 : intervals;
+  for (std::size_t i = 0; i < end; ++i)
+  {
+    double lower;
+    double upper;
+    accelerationBounds(i, x[i], lower, upper);
+    const double u = stop ? lower : upper;
+    x[i + 1] = std::clamp(x[i] + 2 * ds * u, 0.0, reachable[i + 1]);
+    if (stop && x[i + 1] <= 0)
+    {
+      end = i + 1;
+      break;
+    }
+  }
+
+  // Sample the unfiltered path position in every cycle, with constant path acceleration between
+  //  the grid points
+  std::vector<double> grid_times(end + 1, 0.0);
+  for (std::size_t i = 0; i < end; ++i)
+  {
+    const double speed_sum = std::sqrt(x[i]) + std::sqrt(x[i + 1]);
+    double duration = speed_sum > 0 ? 2 * ds / speed_sum : INF;
+    if (!std::isfinite(duration))
+    {
+      // Standstill at both ends of the interval, move through it with the slowest acceleration
+      double lower;
+      double upper;
+      accelerationBounds(i, 0.0, lower, upper);
+      duration = 2 * std::sqrt(ds / std::max(upper, MIN_DERIVATIVE));
+    }
+    grid_times[i + 1] = grid_times[i] + duration;
+  }
+  const auto raw_samples = std::max<std::size_t>(1, std::ceil(grid_times[end] / period_));
+  std::vector<double> increments(raw_samples);
+  double previous = 0;
+  std::size_t interval = 0;
+  for (std::size_t k = 1; k <= raw_samples; ++k)
+  {
+    const double t = static_cast<double>(k) * period_;
+    double position = end * ds;
+    if (t < grid_times[end])
+    {
+      while (interval + 1 < end && t > grid_times[interval + 1])
+      {
+        ++interval;
+      }
+      const double tau = t - grid_times[interval];
+      const double speed = std::sqrt(x[interval]);
+      const double acceleration = (x[interval + 1] - x[interval]) / (2 * ds);
+      position = std::clamp(
+        interval * ds + speed * tau + 0.5 * acceleration * tau * tau, interval * ds,
+        (interval + 1) * ds);
+    }
+    increments[k - 1] = position - previous;
+    previous = position;
+  }
+
+  // Moving average of the increments, with the start speed before the profile and standstill
+  //  after it, therefore the sum of the increments and the end of the path are preserved
+  const std::size_t samples = raw_samples + window;
+  std::vector<double> filtered(samples, 0.0);
+  double sum = history * static_cast<double>(window - 1) + increments[0];
+  for (std::size_t k = 0; k + 1 < samples; ++k)
+  {
+    filtered[k] = sum / static_cast<double>(window);
+    const double leaving = k + 1 >= window ? increments[k + 1 - window] : history;
+    const double entering = k + 1 < raw_samples ? increments[k + 1] : 0.0;
+    sum += entering - leaving;
+  }
+
+  table = SampleTable(joints, period_);
+  table.resize(samples);
+  path_positions.resize(samples);
+  std::vector<double> path_dq(joints);
+  std::vector<double> path_ddq(joints);
+  const double path_end = start + end * ds;
+  double s = 0;
+  segment = 0;
+  for (std::size_t k = 0; k < samples; ++k)
+  {
+    const double before = k > 0 ? filtered[k - 1] : history;
+    const double speed = (before + filtered[k]) / (2 * period_);
+    const double acceleration = (filtered[k] - before) / (period_ * period_);
+    path_positions[k] = std::min(s, path_end);
+    double * sample = table.sample(k);
+    path.evaluate(path_positions[k], segment, sample, path_dq.data(), path_ddq.data());
+    for (std::size_t j = 0; j < joints; ++j)
+    {
+      sample[joints + j] = path_dq[j] * speed;
+      sample[2 * joints + j] = path_ddq[j] * speed * speed + path_dq[j] * acceleration;
+    }
+    s += filtered[k];
+  }
+}
+
+void TimeParameterization::measure(
+  const SampleTable & table, double & velocity_ratio, double & acceleration_ratio,
+  double & jerk_ratio) const
+{
+  velocity_ratio = 0;
+  acceleration_ratio = 0;
+  jerk_ratio = 0;
+  const std::size_t joints = table.joints();
+  for (std::size_t k = 0; k < table.size(); ++k)
+  {
+    for (std::size_t j = 0; j < joints; ++j)
+    {
+      velocity_ratio =
+        std::max(velocity_ratio, std::abs(table.velocities(k)[j]) / limits_.velocity[j]);
+      acceleration_ratio = std::max(
+        acceleration_ratio, std::abs(table.accelerations(k)[j]) / limits_.acceleration[j]);
+      if (k > 0 && limits_.jerk[j] > 0)
+      {
+        const double jerk =
+          (table.accelerations(k)[j] - table.accelerations(k - 1)[j]) / table.period();
+        jerk_ratio = std::max(jerk_ratio, std::abs(jerk) / limits_.jerk[j]);
+      }
+    }
+  }
+}
+}  // namespace kuka_controllers
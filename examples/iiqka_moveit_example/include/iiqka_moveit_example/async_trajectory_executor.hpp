@@ -0,0 +1,99 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IIQKA_MOVEIT_EXAMPLE__ASYNC_TRAJECTORY_EXECUTOR_HPP_
+#define IIQKA_MOVEIT_EXAMPLE__ASYNC_TRAJECTORY_EXECUTOR_HPP_
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+
+#include "moveit_msgs/action/execute_trajectory.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+
+/**
+ * @brief Executes trajectories with the move_group server without blocking the caller
+ *
+ * Unlike MoveGroupInterface::asyncExecute(), the end of the execution is reported: a callback can
+ *  be chained to the completion (e.g. attaching an object) and the caller can wait for the result.
+ */
+class AsyncTrajectoryExecutor
+{
+public:
+  explicit AsyncTrajectoryExecutor(const rclcpp::Node::SharedPtr & node)
+  {
+    action_client_ = rclcpp_action::create_client<ExecuteTrajectory>(node, "execute_trajectory");
+  }
+
+  /**
+   * @brief Sends the trajectory for execution and returns immediately
+   *
+   * @param on_finished: Called with the success of the execution on the executor thread, before
+   *  the returned future becomes ready
+   * @return future set to the success of the execution
+   */
+  std::shared_future<bool> execute(
+    const moveit_msgs::msg::RobotTrajectory & trajectory,
+    std::function<void(bool)> on_finished = nullptr)
+  {
+    auto promise = std::make_shared<std::promise<bool>>();
+    std::shared_future<bool> future = promise->get_future().share();
+    auto finish = [promise, on_finished](bool success)
+    {
+      if (on_finished)
+      {
+        on_finished(success);
+      }
+      promise->set_value(success);
+    };
+
+    if (!action_client_->wait_for_action_server(std::chrono::seconds(1)))
+    {
+      RCLCPP_ERROR(LOGGER, "The execute_trajectory action server is not available");
+      finish(false);
+      return future;
+    }
+
+    ExecuteTrajectory::Goal goal;
+    goal.trajectory = trajectory;
+    auto options = rclcpp_action::Client<ExecuteTrajectory>::SendGoalOptions();
+    options.goal_response_callback = [finish](const GoalHandle::SharedPtr & goal_handle)
+    {
+      if (goal_handle == nullptr)
+      {
+        RCLCPP_ERROR(LOGGER, "Trajectory execution was rejected");
+        finish(false);
+      }
+    };
+    options.result_callback = [finish](const GoalHandle::WrappedResult & result)
+    {
+      finish(
+        result.code == rclcpp_action::ResultCode::SUCCEEDED &&
+        result.result->error_code.val == moveit_msgs::msg::MoveItErrorCodes::SUCCESS);
+    };
+    action_client_->async_send_goal(goal, options);
+    return future;
+  }
+
+private:
+  using ExecuteTrajectory = moveit_msgs::action::ExecuteTrajectory;
+  using GoalHandle = rclcpp_action::ClientGoalHandle<ExecuteTrajectory>;
+
+  rclcpp_action::Client<ExecuteTrajectory>::SharedPtr action_client_;
+  static inline const rclcpp::Logger LOGGER = rclcpp::get_logger("async_trajectory_executor");
+};
+
+#endif  // IIQKA_MOVEIT_EXAMPLE__ASYNC_TRAJECTORY_EXECUTOR_HPP_
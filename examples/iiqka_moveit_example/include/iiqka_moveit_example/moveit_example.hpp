@@ -17,17 +17,27 @@
 
 #include <math.h>
 
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "geometry_msgs/msg/vector3.hpp"
 #include "moveit/move_group_interface/move_group_interface.h"
+#include "moveit/planning_scene/planning_scene.h"
 #include "moveit/planning_scene_interface/planning_scene_interface.h"
+#include "moveit/robot_trajectory/robot_trajectory.h"
 #include "moveit_msgs/msg/collision_object.hpp"
+#include "moveit_msgs/srv/get_planning_scene.hpp"
 #include "moveit_visual_tools/moveit_visual_tools.h"
 #include "rclcpp/rclcpp.hpp"
 
+#include "iiqka_moveit_example/parallel_cartesian_planner.hpp"
+#include "iiqka_moveit_example/plan_cache.hpp"
+#include "iiqka_moveit_example/planning_scene_batch.hpp"
+
 class MoveitExample : public rclcpp::Node
 {
 public:
@@ -46,46 +56,53 @@ public:
     moveit_visual_tools_->loadRemoteControl();
     moveit_visual_tools_->trigger();
 
-    planning_scene_diff_publisher_ =
-      this->create_publisher<moveit_msgs::msg::PlanningScene>("planning_scene", 10);
+    planning_scene_interface_ =
+      std::make_unique<moveit::planning_interface::PlanningSceneInterface>();
+    get_planning_scene_client_ =
+      create_client<moveit_msgs::srv::GetPlanningScene>("get_planning_scene");
+    cartesian_planner_ = std::make_unique<ParallelCartesianPlanner>(
+      move_group_interface_->getRobotModel(), PLANNING_GROUP,
+      move_group_interface_->getEndEffectorLink());
 
-    move_group_interface_->setMaxVelocityScalingFactor(0.1);
-    move_group_interface_->setMaxAccelerationScalingFactor(0.1);
+    move_group_interface_->setMaxVelocityScalingFactor(VELOCITY_SCALING);
+    move_group_interface_->setMaxAccelerationScalingFactor(ACCELERATION_SCALING);
   }
 
   moveit_msgs::msg::RobotTrajectory::SharedPtr drawCircle()
   {
-    std::vector<geometry_msgs::msg::Pose> waypoints;
-    moveit_msgs::msg::RobotTrajectory trajectory;
-    geometry_msgs::msg::Pose msg;
+    std::vector<Eigen::Isometry3d> waypoints;
 
     // circle facing forward
-    msg.orientation.x = 0.0;
-    msg.orientation.y = sqrt(2) / 2;
-    msg.orientation.z = 0.0;
-    msg.orientation.w = sqrt(2) / 2;
-    msg.position.x = 0.4;
+    const Eigen::Quaterniond orientation(sqrt(2) / 2, 0.0, sqrt(2) / 2, 0.0);
     // Define waypoints in a circle
     for (int i = 0; i < 63; i++)
     {
-      msg.position.y = -0.2 + sin(0.1 * i) * 0.15;
-      msg.position.z = 0.4 + cos(0.1 * i) * 0.15;
-      waypoints.push_back(msg);
+      waypoints.push_back(Eigen::Isometry3d(
+        Eigen::Translation3d(0.4, -0.2 + sin(0.1 * i) * 0.15, 0.4 + cos(0.1 * i) * 0.15) *
+        orientation));
     }
 
+    // The segments of the path are solved in parallel, the sequential solution is computed only
+    //  to report the speedup
     RCLCPP_INFO(LOGGER, "Start planning");
-    double fraction =
-      move_group_interface_->computeCartesianPath(waypoints, 0.005, 0.0, trajectory);
+    const auto result = cartesian_planner_->computeCartesianPath(
+      *move_group_interface_->getCurrentState(), waypoints, VELOCITY_SCALING,
+      ACCELERATION_SCALING, true);
     RCLCPP_INFO(LOGGER, "Planning done!");
 
-    if (fraction < 1)
+    if (result.fraction < 1)
     {
       RCLCPP_ERROR(LOGGER, "Could not compute trajectory through all waypoints!");
       return nullptr;
     }
+    else if (!isTrajectoryValid(result.trajectory, moveit_msgs::msg::PlanningScene()))
+    {
+      RCLCPP_ERROR(LOGGER, "The Cartesian path is in collision!");
+      return nullptr;
+    }
     else
     {
-      return std::make_shared<moveit_msgs::msg::RobotTrajectory>(trajectory);
+      return std::make_shared<moveit_msgs::msg::RobotTrajectory>(result.trajectory);
     }
   }
 
@@ -99,18 +116,23 @@ public:
     move_group_interface_->setPlannerId(planner_id);
     move_group_interface_->setPoseTarget(pose);
 
-    moveit::planning_interface::MoveGroupInterface::Plan plan;
-    RCLCPP_INFO(LOGGER, "Sending planning request");
-    if (!move_group_interface_->plan(plan))
-    {
-      RCLCPP_INFO(LOGGER, "Planning failed");
-      return nullptr;
-    }
-    else
-    {
-      RCLCPP_INFO(LOGGER, "Planning successful");
-      return std::make_shared<moveit_msgs::msg::RobotTrajectory>(plan.trajectory);
-    }
+    return planWithCache(
+      pose, {}, scene_version_, moveit_msgs::msg::PlanningScene(),
+      [this]() -> moveit_msgs::msg::RobotTrajectory::SharedPtr
+      {
+        moveit::planning_interface::MoveGroupInterface::Plan plan;
+        RCLCPP_INFO(LOGGER, "Sending planning request");
+        if (!move_group_interface_->plan(plan))
+        {
+          RCLCPP_INFO(LOGGER, "Planning failed");
+          return nullptr;
+        }
+        else
+        {
+          RCLCPP_INFO(LOGGER, "Planning successful");
+          return std::make_shared<moveit_msgs::msg::RobotTrajectory>(plan.trajectory);
+        }
+      });
   }
 
   moveit_msgs::msg::RobotTrajectory::SharedPtr planToPosition(const std::vector<double> & joint_pos)
@@ -141,28 +163,145 @@ public:
     move_group_interface_->setPlannerId(planner_id);
     move_group_interface_->setPoseTarget(pose);
 
-    moveit::planning_interface::MoveGroupInterface::Plan plan;
-    RCLCPP_INFO(LOGGER, "Sending planning request");
-    moveit::core::MoveItErrorCode err_code;
-    auto start = std::chrono::high_resolution_clock::now();
-    do
+    return planWithCache(
+      pose, {}, scene_version_, moveit_msgs::msg::PlanningScene(),
+      [this]()
+      {
+        moveit::planning_interface::MoveGroupInterface::Plan plan;
+        RCLCPP_INFO(LOGGER, "Sending planning request");
+        moveit::core::MoveItErrorCode err_code;
+        auto start = std::chrono::high_resolution_clock::now();
+        do
+        {
+          RCLCPP_INFO(LOGGER, "Planning ...");
+          err_code = move_group_interface_->plan(plan);
+        } while (err_code != moveit::core::MoveItErrorCode::SUCCESS);
+        auto stop = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+        RCLCPP_INFO(LOGGER, "Planning successful after %li ms", duration.count());
+        return std::make_shared<moveit_msgs::msg::RobotTrajectory>(plan.trajectory);
+      });
+  }
+
+  /**
+   * @brief Enables reusing trajectories planned to the same pose from the same start state in the
+   *  same scene, the trajectories are stored in the given file across restarts
+   */
+  void enablePlanCache(const std::string & path, std::size_t capacity = 64 * 1024 * 1024)
+  {
+    plan_cache_ = std::make_unique<PlanCache>(path, capacity);
+  }
+
+  /**
+   * @brief Returns the cached trajectory to the pose if it is valid, otherwise plans and stores it
+   *
+   * @param pose: Target pose, which must be already set in the MoveGroupInterface
+   * @param start_positions: Joint positions at the start, empty for the current state
+   * @param scene_version: Version of the planning scene at the start
+   * @param scene_diff: Changes of the actual planning scene until the start
+   * @param plan: Plans the trajectory on a cache miss
+   */
+  moveit_msgs::msg::RobotTrajectory::SharedPtr planWithCache(
+    const Eigen::Isometry3d & pose, const std::vector<double> & start_positions,
+    uint64_t scene_version, const moveit_msgs::msg::PlanningScene & scene_diff,
+    const std::function<moveit_msgs::msg::RobotTrajectory::SharedPtr()> & plan)
+  {
+    if (plan_cache_ == nullptr)
+    {
+      return plan();
+    }
+
+    const auto key = plan_cache_->makeKey(
+      start_positions.empty() ? move_group_interface_->getCurrentJointValues() : start_positions,
+      pose, scene_version);
+    auto trajectory = plan_cache_->lookup(
+      key, [this, &scene_diff](const moveit_msgs::msg::RobotTrajectory & cached)
+      { return isTrajectoryValid(cached, scene_diff); });
+    if (trajectory != nullptr)
+    {
+      RCLCPP_INFO(LOGGER, "Using cached trajectory");
+      return trajectory;
+    }
+    trajectory = plan();
+    if (trajectory != nullptr)
+    {
+      plan_cache_->insert(key, *trajectory);
+    }
+    return trajectory;
+  }
+
+  // Checks the trajectory for collisions in the actual planning scene modified by the diff
+  bool isTrajectoryValid(
+    const moveit_msgs::msg::RobotTrajectory & trajectory,
+    const moveit_msgs::msg::PlanningScene & scene_diff)
+  {
+    using moveit_msgs::msg::PlanningSceneComponents;
+    auto request = std::make_shared<moveit_msgs::srv::GetPlanningScene::Request>();
+    request->components.components =
+      PlanningSceneComponents::SCENE_SETTINGS | PlanningSceneComponents::ROBOT_STATE |
+      PlanningSceneComponents::ROBOT_STATE_ATTACHED_OBJECTS |
+      PlanningSceneComponents::WORLD_OBJECT_NAMES | PlanningSceneComponents::WORLD_OBJECT_GEOMETRY |
+      PlanningSceneComponents::OCTOMAP | PlanningSceneComponents::TRANSFORMS |
+      PlanningSceneComponents::ALLOWED_COLLISION_MATRIX |
+      PlanningSceneComponents::LINK_PADDING_AND_SCALING;
+    auto future = get_planning_scene_client_->async_send_request(request);
+    if (future.wait_for(std::chrono::seconds(1)) != std::future_status::ready)
     {
-      RCLCPP_INFO(LOGGER, "Planning ...");
-      err_code = move_group_interface_->plan(plan);
-    } while (err_code != moveit::core::MoveItErrorCode::SUCCESS);
-    auto stop = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
-    RCLCPP_INFO(LOGGER, "Planning successful after %li ms", duration.count());
-    return std::make_shared<moveit_msgs::msg::RobotTrajectory>(plan.trajectory);
+      RCLCPP_ERROR(LOGGER, "Failed to get the planning scene");
+      return false;
+    }
+
+    planning_scene::PlanningScene scene(move_group_interface_->getRobotModel());
+    scene.setPlanningSceneMsg(future.get()->scene);
+    auto diff = scene_diff;
+    diff.is_diff = true;
+    diff.robot_state.is_diff = true;
+    scene.usePlanningSceneMsg(diff);
+
+    robot_trajectory::RobotTrajectory robot_trajectory(scene.getRobotModel(), PLANNING_GROUP);
+    robot_trajectory.setRobotTrajectoryMsg(scene.getCurrentState(), trajectory);
+    return scene.isPathValid(robot_trajectory, PLANNING_GROUP);
+  }
+
+  void logPlanCacheStatistics() const
+  {
+    if (plan_cache_ != nullptr)
+    {
+      plan_cache_->logStatistics();
+    }
+  }
+
+  /**
+   * @brief Applies the diff with the ApplyPlanningScene service of the move_group server
+   *
+   * @return true, if the server acknowledged the change, which is then considered by all later
+   *  planning requests
+   */
+  bool applyPlanningScene(const moveit_msgs::msg::PlanningScene & diff)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    if (!planning_scene_interface_->applyPlanningScene(diff))
+    {
+      RCLCPP_ERROR(LOGGER, "Failed to apply the planning scene diff");
+      return false;
+    }
+    scene_version_++;
+    RCLCPP_DEBUG(
+      LOGGER, "Planning scene diff applied in %.1f ms",
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    return true;
+  }
+
+  bool applyPlanningScene(const PlanningSceneBatch & batch)
+  {
+    return batch.empty() || applyPlanningScene(batch.diff());
   }
 
   void AddObject(const moveit_msgs::msg::CollisionObject & object)
   {
-    moveit_msgs::msg::PlanningScene planning_scene;
-    planning_scene.name = "scene";
-    planning_scene.world.collision_objects.push_back(object);
-    planning_scene.is_diff = true;
-    planning_scene_diff_publisher_->publish(planning_scene);
+    PlanningSceneBatch batch;
+    batch.addObject(object);
+    applyPlanningScene(batch);
   }
 
   void addRobotPlatform()
@@ -218,8 +357,15 @@ public:
     AddObject(collision_object);
   }
 
-  void addPalletObjects()
+  /**
+   * @brief Adds the 3x3x3 pallets to the scene with one acknowledged update
+   *
+   * @param compare_per_object: Add the pallets first with one update per pallet and remove them,
+   *  to log the time of both methods
+   */
+  void addPalletObjects(bool compare_per_object = false)
   {
+    std::vector<moveit_msgs::msg::CollisionObject> pallet_objects;
     for (int k = 0; k < 3; k++)
     {
       for (int j = 0; j < 3; j++)
@@ -248,47 +394,77 @@ public:
           pallet_object.primitive_poses.push_back(stand_pose);
           pallet_object.operation = pallet_object.ADD;
 
-          AddObject(pallet_object);
-          std::this_thread::sleep_for(std::chrono::milliseconds(100));
+          pallet_objects.push_back(pallet_object);
         }
       }
     }
+
+    double per_object_time = 0;
+    if (compare_per_object)
+    {
+      auto start = std::chrono::steady_clock::now();
+      for (const auto & pallet_object : pallet_objects)
+      {
+        AddObject(pallet_object);
+      }
+      per_object_time =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+      PlanningSceneBatch removal;
+      for (const auto & pallet_object : pallet_objects)
+      {
+        removal.removeObject(pallet_object.id);
+      }
+      applyPlanningScene(removal);
+    }
+
+    // All pallets are added with one acknowledged update instead of an update per pallet
+    const auto start = std::chrono::steady_clock::now();
+    PlanningSceneBatch batch;
+    for (const auto & pallet_object : pallet_objects)
+    {
+      batch.addObject(pallet_object);
+    }
+    if (applyPlanningScene(batch))
+    {
+      const double batch_time =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      RCLCPP_INFO(LOGGER, "Added %lu pallet objects in %.1f ms", batch.size(), batch_time);
+      if (compare_per_object)
+      {
+        RCLCPP_INFO(
+          LOGGER, "Adding the pallet objects one by one took %.1f ms, speedup %.2f",
+          per_object_time, batch_time > 0 ? per_object_time / batch_time : 0.0);
+      }
+    }
   }
 
   void AttachObject(const std::string & object_id)
   {
-    moveit_msgs::msg::PlanningScene planning_scene;
-    planning_scene.name = "scene";
-    moveit_msgs::msg::AttachedCollisionObject attached_object;
-
-    attached_object.link_name = "flange";
-    attached_object.object.id = object_id;
-
     // Carry out the REMOVE + ATTACH operation
     RCLCPP_INFO(LOGGER, "Attaching the object to the hand and removing it from the world.");
-    planning_scene.robot_state.attached_collision_objects.push_back(attached_object);
-    planning_scene.robot_state.is_diff = true;
-    planning_scene.is_diff = true;
-    planning_scene_diff_publisher_->publish(planning_scene);
+    applyPlanningScene(attachObjectDiff(object_id));
   }
 
   void DetachAndRemoveObject(const std::string & object_id)
   {
-    moveit_msgs::msg::PlanningScene planning_scene;
-    planning_scene.name = "scene";
-    moveit_msgs::msg::AttachedCollisionObject attached_object;
-
-    attached_object.link_name = "flange";
-    attached_object.object.id = object_id;
-    attached_object.object.operation = attached_object.object.REMOVE;
-
     // Carry out the DETACH operation
     RCLCPP_INFO(LOGGER, "Detaching the object from the hand");
-    planning_scene.robot_state.attached_collision_objects.push_back(attached_object);
-    planning_scene.robot_state.is_diff = true;
-    planning_scene.world.collision_objects.push_back(attached_object.object);
-    planning_scene.is_diff = true;
-    planning_scene_diff_publisher_->publish(planning_scene);
+    applyPlanningScene(detachAndRemoveObjectDiff(object_id));
+  }
+
+  moveit_msgs::msg::PlanningScene attachObjectDiff(const std::string & object_id) const
+  {
+    PlanningSceneBatch batch;
+    batch.attachObject(object_id, "flange");
+    return batch.diff();
+  }
+
+  moveit_msgs::msg::PlanningScene detachAndRemoveObjectDiff(const std::string & object_id) const
+  {
+    PlanningSceneBatch batch;
+    batch.detachAndRemoveObject(object_id, "flange");
+    return batch.diff();
   }
 
   void setOrientationConstraint(const geometry_msgs::msg::Quaternion & orientation)
@@ -341,10 +517,17 @@ public:
 
 protected:
   std::shared_ptr<moveit::planning_interface::MoveGroupInterface> move_group_interface_;
-  rclcpp::Publisher<moveit_msgs::msg::PlanningScene>::SharedPtr planning_scene_diff_publisher_;
+  std::unique_ptr<moveit::planning_interface::PlanningSceneInterface> planning_scene_interface_;
   std::shared_ptr<moveit_visual_tools::MoveItVisualTools> moveit_visual_tools_;
+  std::unique_ptr<ParallelCartesianPlanner> cartesian_planner_;
+  std::unique_ptr<PlanCache> plan_cache_;
+  rclcpp::Client<moveit_msgs::srv::GetPlanningScene>::SharedPtr get_planning_scene_client_;
+  std::atomic<uint64_t> scene_version_{0};
   const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit_basic_plan");
   const std::string PLANNING_GROUP = "manipulator";
+  // Scaling factors of the planned trajectories, also used for the Cartesian paths
+  const double VELOCITY_SCALING = 0.1;
+  const double ACCELERATION_SCALING = 0.1;
 };
 
 #endif  // IIQKA_MOVEIT_EXAMPLE__MOVEIT_EXAMPLE_HPP_
@@ -0,0 +1,261 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IIQKA_MOVEIT_EXAMPLE__PARALLEL_CARTESIAN_PLANNER_HPP_
+#define IIQKA_MOVEIT_EXAMPLE__PARALLEL_CARTESIAN_PLANNER_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Eigen/Geometry"
+#include "moveit/robot_state/robot_state.h"
+#include "moveit/robot_trajectory/robot_trajectory.h"
+#include "moveit/trajectory_processing/time_optimal_trajectory_generation.h"
+#include "moveit_msgs/msg/robot_trajectory.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+/**
+ * @brief Computes Cartesian paths by solving the inverse kinematics of path segments in parallel
+ *
+ * The path through the waypoints is interpolated linearly with the given step and split into
+ *  segments. The first pose of every segment is solved with the start state as seed, the other
+ *  poses with the solution of the previous pose. The segments are stitched together if the joint
+ *  distance between neighbouring states stays below the jump threshold. A segment with a jump
+ *  (e.g. its first pose was solved on another IK branch) is solved again sequentially, seeded with
+ *  the end of the previous segment.
+ *
+ * The kinematics plugin of the group is called from several threads, which is supported by the
+ *  KDL plugin. Collisions are not checked.
+ */
+class ParallelCartesianPlanner
+{
+public:
+  struct Result
+  {
+    // Trajectory through the solved part of the path, time-parametrized
+    moveit_msgs::msg::RobotTrajectory trajectory;
+    // Solved part of the path, 1.0 if the whole path was solved
+    double fraction = 0;
+    // Number of segments solved again sequentially
+    std::size_t fallbacks = 0;
+    double planning_time = 0;
+    // Planning time of the sequential baseline, if it was computed [ms]
+    double sequential_planning_time = 0;
+  };
+
+  /**
+   * @param robot_model: Model of the robot
+   * @param group_name: Name of the joint model group
+   * @param tip_link: Link following the path
+   * @param max_step: Maximum translation of the tip between IK solutions [m]
+   * @param jump_threshold: Maximum joint distance between neighbouring IK solutions [rad]
+   * @param segments: Number of path segments solved in parallel, 0 for one per CPU core
+   */
+  ParallelCartesianPlanner(
+    const moveit::core::RobotModelConstPtr & robot_model, const std::string & group_name,
+    const std::string & tip_link, double max_step = 0.005, double jump_threshold = 0.2,
+    std::size_t segments = 0)
+  : robot_model_(robot_model),
+    group_(robot_model->getJointModelGroup(group_name)),
+    tip_link_(tip_link),
+    max_step_(max_step),
+    jump_threshold_(jump_threshold),
+    segments_(segments > 0 ? segments : std::max(1u, std::thread::hardware_concurrency()))
+  {
+  }
+
+  /**
+   * @brief Computes the path from the start state through the waypoints
+   *
+   * @param start_state: State of the robot at the start of the path
+   * @param waypoints: Poses of the tip link in the model frame
+   * @param velocity_scaling: Velocity scaling factor of the time parametrization
+   * @param acceleration_scaling: Acceleration scaling factor of the time parametrization
+   * @param compare_sequential: Solve the path also sequentially and log the speedup
+   */
+  Result computeCartesianPath(
+    const moveit::core::RobotState & start_state, const std::vector<Eigen::Isometry3d> & waypoints,
+    double velocity_scaling, double acceleration_scaling, bool compare_sequential = false)
+  {
+    Result result;
+    moveit::core::RobotState start(start_state);
+    start.update();
+    const auto poses = interpolate(start.getGlobalLinkTransform(tip_link_), waypoints);
+
+    auto planning_start = std::chrono::steady_clock::now();
+    const auto states = solveParallel(start, poses, result.fallbacks);
+    result.planning_time = millisecondsSince(planning_start);
+
+    if (compare_sequential)
+    {
+      planning_start = std::chrono::steady_clock::now();
+      const auto sequential_states = solveSequential(start, poses, 0, poses.size(), true);
+      result.sequential_planning_time = millisecondsSince(planning_start);
+      RCLCPP_INFO(
+        LOGGER,
+        "Cartesian path with %lu poses: %.1f ms in %lu segments (%lu solved again), %.1f ms "
+        "sequentially, speedup %.2f",
+        poses.size(), result.planning_time, segments_, result.fallbacks,
+        result.sequential_planning_time,
+        result.planning_time > 0 ? result.sequential_planning_time / result.planning_time : 0.0);
+      if (sequential_states.size() != states.size())
+      {
+        RCLCPP_WARN(
+          LOGGER, "Sequential solution reached %lu poses instead of %lu", sequential_states.size(),
+          states.size());
+      }
+    }
+
+    result.fraction = poses.empty() ? 1.0 : static_cast<double>(states.size()) / poses.size();
+
+    robot_trajectory::RobotTrajectory trajectory(robot_model_, group_);
+    trajectory.addSuffixWayPoint(start, 0.0);
+    for (const auto & state : states)
+    {
+      trajectory.addSuffixWayPoint(state, 0.0);
+    }
+    trajectory_processing::TimeOptimalTrajectoryGeneration time_parametrization;
+    if (!time_parametrization.computeTimeStamps(
+          trajectory, velocity_scaling, acceleration_scaling))
+    {
+      RCLCPP_ERROR(LOGGER, "Time parametrization of the Cartesian path failed");
+      result.fraction = 0;
+      return result;
+    }
+    trajectory.getRobotTrajectoryMsg(result.trajectory);
+    return result;
+  }
+
+private:
+  using States = std::vector<moveit::core::RobotState>;
+
+  // Poses along the path with at most max_step_ translation between them, without the start pose
+  std::vector<Eigen::Isometry3d> interpolate(
+    const Eigen::Isometry3d & start, const std::vector<Eigen::Isometry3d> & waypoints) const
+  {
+    std::vector<Eigen::Isometry3d> poses;
+    Eigen::Isometry3d previous = start;
+    for (const auto & waypoint : waypoints)
+    {
+      const double distance = (waypoint.translation() - previous.translation()).norm();
+      const std::size_t steps =
+        std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(distance / max_step_)));
+      const Eigen::Quaterniond start_rotation(previous.rotation());
+      const Eigen::Quaterniond end_rotation(waypoint.rotation());
+      for (std::size_t i = 1; i <= steps; ++i)
+      {
+        const double t = static_cast<double>(i) / steps;
+        Eigen::Isometry3d pose(start_rotation.slerp(t, end_rotation));
+        pose.translation() = (1 - t) * previous.translation() + t * waypoint.translation();
+        poses.push_back(pose);
+      }
+      previous = waypoint;
+    }
+    return poses;
+  }
+
+  States solveParallel(
+    const moveit::core::RobotState & start_state, const std::vector<Eigen::Isometry3d> & poses,
+    std::size_t & fallbacks) const
+  {
+    const std::size_t segment_count = std::min(segments_, std::max<std::size_t>(1, poses.size()));
+    const std::size_t segment_length = (poses.size() + segment_count - 1) / segment_count;
+
+    std::vector<std::future<States>> futures;
+    for (std::size_t begin = 0; begin < poses.size(); begin += segment_length)
+    {
+      const std::size_t end = std::min(begin + segment_length, poses.size());
+      futures.push_back(std::async(
+        std::launch::async, [this, &start_state, &poses, begin, end]
+        { return solveSequential(start_state, poses, begin, end, begin == 0); }));
+    }
+
+    // Stitch the segments in order, a segment not continuing the previous one is solved again
+    States states;
+    for (std::size_t s = 0; s < futures.size(); ++s)
+    {
+      const std::size_t begin = s * segment_length;
+      const std::size_t end = std::min(begin + segment_length, poses.size());
+      States segment = futures[s].get();
+      const auto & previous = states.empty() ? start_state : states.back();
+      if (segment.size() != end - begin || !isContinuous(previous, segment.front()))
+      {
+        fallbacks++;
+        segment = solveSequential(previous, poses, begin, end, true);
+      }
+      states.insert(states.end(), segment.begin(), segment.end());
+      if (states.size() != end)
+      {
+        break;
+      }
+    }
+    return states;
+  }
+
+  // Solves the poses [begin, end) each seeded with the previous solution, stops at the first
+  //  failure or jump. The jump from the seed to the first solution is only checked if the seed is
+  //  the state before the first pose.
+  States solveSequential(
+    const moveit::core::RobotState & seed, const std::vector<Eigen::Isometry3d> & poses,
+    std::size_t begin, std::size_t end, bool continues_seed) const
+  {
+    States states;
+    moveit::core::RobotState state(seed);
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      if (!state.setFromIK(group_, poses[i], tip_link_, IK_TIMEOUT))
+      {
+        break;
+      }
+      state.update();
+      if (
+        (!states.empty() || continues_seed) &&
+        !isContinuous(states.empty() ? seed : states.back(), state))
+      {
+        break;
+      }
+      states.push_back(state);
+    }
+    return states;
+  }
+
+  bool isContinuous(
+    const moveit::core::RobotState & from, const moveit::core::RobotState & to) const
+  {
+    return from.distance(to, group_) <= jump_threshold_;
+  }
+
+  static double millisecondsSince(std::chrono::steady_clock::time_point start)
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+      .count();
+  }
+
+  const moveit::core::RobotModelConstPtr robot_model_;
+  const moveit::core::JointModelGroup * group_;
+  const std::string tip_link_;
+  const double max_step_;
+  const double jump_threshold_;
+  const std::size_t segments_;
+  static constexpr double IK_TIMEOUT = 0.05;
+  const rclcpp::Logger LOGGER = rclcpp::get_logger("parallel_cartesian_planner");
+};
+
+#endif  // IIQKA_MOVEIT_EXAMPLE__PARALLEL_CARTESIAN_PLANNER_HPP_
@@ -0,0 +1,330 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IIQKA_MOVEIT_EXAMPLE__PARALLEL_PLANNER_HPP_
+#define IIQKA_MOVEIT_EXAMPLE__PARALLEL_PLANNER_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "moveit/move_group_interface/move_group_interface.h"
+#include "moveit_msgs/action/move_group.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+
+/**
+ * @brief Races several planners for the same target of a MoveGroupInterface
+ *
+ * One plan-only goal is sent to the move_group server for every configured planner, which plans
+ *  them concurrently. Either the first valid trajectory or the shortest one finished within the
+ *  deadline is returned, the remaining goals are canceled. The same planner can be configured more
+ *  than once, randomized planners (e.g. RRTConnect) then race with different seeds.
+ *
+ * Canceling a goal does not interrupt the planner in move_group, it keeps planning until it finds
+ *  a solution or its allowed planning time is over, and its result is ignored. Until then it uses
+ *  a thread of move_group and a CPU core, which can delay the next request. Therefore the planning
+ *  time of the slow planners should be limited to slightly more than the usual time of the
+ *  fastest planner.
+ */
+class ParallelPlanner
+{
+public:
+  struct PlannerConfig
+  {
+    std::string planning_pipeline;
+    std::string planner_id;
+    // Allowed planning time of the planner in move_group, zero for the deadline of the race
+    std::chrono::milliseconds planning_time{0};
+  };
+
+  enum class Selection
+  {
+    // Return the first valid trajectory
+    FIRST_SOLUTION,
+    // Return the trajectory with the shortest duration finished within the deadline
+    SHORTEST_DURATION
+  };
+
+  ParallelPlanner(
+    const rclcpp::Node::SharedPtr & node,
+    const std::shared_ptr<moveit::planning_interface::MoveGroupInterface> & move_group_interface,
+    const std::vector<PlannerConfig> & planners, std::chrono::milliseconds deadline,
+    Selection selection)
+  : move_group_interface_(move_group_interface),
+    planners_(planners),
+    deadline_(deadline),
+    selection_(selection),
+    statistics_(planners.size())
+  {
+    action_client_ = rclcpp_action::create_client<MoveGroup>(node, "move_action");
+  }
+
+  /**
+   * @brief Plans to the target set in the MoveGroupInterface with all planners
+   *
+   * @param scene_diff: Changes of the planning scene that are considered only for this request,
+   *  e.g. attaching an object that is attached when the start state is reached
+   * @return the selected trajectory or nullptr, if no planner succeeded within the deadline
+   */
+  moveit_msgs::msg::RobotTrajectory::SharedPtr plan(
+    const moveit_msgs::msg::PlanningScene & scene_diff = moveit_msgs::msg::PlanningScene())
+  {
+    if (!action_client_->wait_for_action_server(deadline_))
+    {
+      RCLCPP_ERROR(LOGGER, "The move_group action server is not available");
+      return nullptr;
+    }
+
+    auto race = std::make_shared<Race>(planners_.size());
+    sendGoals(race, scene_diff);
+
+    std::unique_lock<std::mutex> lock(race->mutex);
+    race->condition.wait_until(
+      lock, race->start + deadline_,
+      [this, &race]
+      {
+        return race->finished == planners_.size() ||
+               (selection_ == Selection::FIRST_SOLUTION && race->winner < planners_.size());
+      });
+
+    // Goals still running are not needed anymore, their planners in move_group are only stopped
+    //  by their allowed planning time
+    for (std::size_t i = 0; i < planners_.size(); ++i)
+    {
+      if (!race->attempts[i].finished && race->goal_handles[i] != nullptr)
+      {
+        action_client_->async_cancel_goal(race->goal_handles[i]);
+      }
+    }
+
+    std::size_t selected = race->winner;
+    if (selection_ == Selection::SHORTEST_DURATION)
+    {
+      double shortest = std::numeric_limits<double>::infinity();
+      for (std::size_t i = 0; i < planners_.size(); ++i)
+      {
+        if (race->attempts[i].success && race->attempts[i].duration < shortest)
+        {
+          shortest = race->attempts[i].duration;
+          selected = i;
+        }
+      }
+    }
+
+    const double race_time = std::chrono::duration<double, std::milli>(
+                               std::chrono::steady_clock::now() - race->start)
+                               .count();
+    updateStatistics(*race, selected, race_time);
+
+    if (selected >= planners_.size())
+    {
+      RCLCPP_INFO(LOGGER, "No planner succeeded after %.1f ms", race_time);
+      return nullptr;
+    }
+    RCLCPP_INFO(
+      LOGGER, "Planning successful with %s/%s after %.1f ms",
+      planners_[selected].planning_pipeline.c_str(), planners_[selected].planner_id.c_str(),
+      race_time);
+    return std::make_shared<moveit_msgs::msg::RobotTrajectory>(
+      std::move(race->attempts[selected].trajectory));
+  }
+
+  void logStatistics() const
+  {
+    RCLCPP_INFO(
+      LOGGER, "%lu planning races, %lu successful, mean time %.1f ms, max time %.1f ms", races_,
+      successful_races_, races_ > 0 ? total_race_time_ / races_ : 0.0, max_race_time_);
+    for (std::size_t i = 0; i < planners_.size(); ++i)
+    {
+      const auto & statistics = statistics_[i];
+      RCLCPP_INFO(
+        LOGGER, "  %s/%s: %lu of %lu successful, %lu selected, mean planning time %.1f ms",
+        planners_[i].planning_pipeline.c_str(), planners_[i].planner_id.c_str(),
+        statistics.successes, statistics.attempts, statistics.selected,
+        statistics.successes > 0 ? statistics.total_planning_time / statistics.successes : 0.0);
+    }
+  }
+
+private:
+  using MoveGroup = moveit_msgs::action::MoveGroup;
+  using GoalHandle = rclcpp_action::ClientGoalHandle<MoveGroup>;
+
+  struct Attempt
+  {
+    bool finished = false;
+    bool success = false;
+    // Time from sending the goal until receiving the result [ms]
+    double planning_time = 0;
+    // Duration of the planned trajectory [s]
+    double duration = 0;
+    moveit_msgs::msg::RobotTrajectory trajectory;
+  };
+
+  // State of one planning request, the callbacks of the action client arriving after the request
+  //  is finished are ignored
+  struct Race
+  {
+    explicit Race(std::size_t planners)
+    : goal_handles(planners), attempts(planners), winner(planners)
+    {
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<GoalHandle::SharedPtr> goal_handles;
+    std::vector<Attempt> attempts;
+    std::size_t finished = 0;
+    // Index of the first successful planner, the number of planners if there is none
+    std::size_t winner;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  struct PlannerStatistics
+  {
+    uint64_t attempts = 0;
+    uint64_t successes = 0;
+    uint64_t selected = 0;
+    double total_planning_time = 0;
+  };
+
+  void sendGoals(
+    const std::shared_ptr<Race> & race, const moveit_msgs::msg::PlanningScene & scene_diff)
+  {
+    // The requests are constructed by the MoveGroupInterface, which contains the target
+    const auto planning_pipeline = move_group_interface_->getPlanningPipelineId();
+    const auto planner_id = move_group_interface_->getPlannerId();
+    const double planning_time = move_group_interface_->getPlanningTime();
+    move_group_interface_->setPlanningTime(std::chrono::duration<double>(deadline_).count());
+
+    std::vector<MoveGroup::Goal> goals(planners_.size());
+    for (std::size_t i = 0; i < planners_.size(); ++i)
+    {
+      move_group_interface_->setPlanningPipelineId(planners_[i].planning_pipeline);
+      move_group_interface_->setPlannerId(planners_[i].planner_id);
+      move_group_interface_->constructMotionPlanRequest(goals[i].request);
+      if (planners_[i].planning_time.count() > 0)
+      {
+        goals[i].request.allowed_planning_time =
+          std::chrono::duration<double>(std::min(planners_[i].planning_time, deadline_)).count();
+      }
+      goals[i].planning_options.plan_only = true;
+      goals[i].planning_options.planning_scene_diff = scene_diff;
+      goals[i].planning_options.planning_scene_diff.is_diff = true;
+      goals[i].planning_options.planning_scene_diff.robot_state.is_diff = true;
+    }
+
+    move_group_interface_->setPlanningPipelineId(planning_pipeline);
+    move_group_interface_->setPlannerId(planner_id);
+    move_group_interface_->setPlanningTime(planning_time);
+
+    race->start = std::chrono::steady_clock::now();
+    // The goal handles store the callbacks, which must not own the race
+    std::weak_ptr<Race> weak_race = race;
+    for (std::size_t i = 0; i < planners_.size(); ++i)
+    {
+      auto options = rclcpp_action::Client<MoveGroup>::SendGoalOptions();
+      options.goal_response_callback = [weak_race, i](const GoalHandle::SharedPtr & goal_handle)
+      {
+        auto race = weak_race.lock();
+        if (race == nullptr)
+        {
+          return;
+        }
+        std::lock_guard<std::mutex> lock(race->mutex);
+        race->goal_handles[i] = goal_handle;
+        if (goal_handle == nullptr)
+        {
+          // Rejected goals are finished without success
+          race->attempts[i].finished = true;
+          race->finished++;
+          race->condition.notify_all();
+        }
+      };
+      options.result_callback = [weak_race, i](const GoalHandle::WrappedResult & result)
+      {
+        auto race = weak_race.lock();
+        if (race == nullptr)
+        {
+          return;
+        }
+        std::lock_guard<std::mutex> lock(race->mutex);
+        auto & attempt = race->attempts[i];
+        attempt.finished = true;
+        attempt.planning_time = std::chrono::duration<double, std::milli>(
+                                  std::chrono::steady_clock::now() - race->start)
+                                  .count();
+        attempt.success =
+          result.code == rclcpp_action::ResultCode::SUCCEEDED &&
+          result.result->error_code.val == moveit_msgs::msg::MoveItErrorCodes::SUCCESS;
+        if (attempt.success)
+        {
+          attempt.trajectory = result.result->planned_trajectory;
+          const auto & points = attempt.trajectory.joint_trajectory.points;
+          attempt.duration =
+            points.empty() ? 0.0 : rclcpp::Duration(points.back().time_from_start).seconds();
+          if (race->winner == race->attempts.size())
+          {
+            race->winner = i;
+          }
+        }
+        race->finished++;
+        race->condition.notify_all();
+      };
+      action_client_->async_send_goal(goals[i], options);
+    }
+  }
+
+  void updateStatistics(const Race & race, std::size_t selected, double race_time)
+  {
+    races_++;
+    total_race_time_ += race_time;
+    max_race_time_ = std::max(max_race_time_, race_time);
+    if (selected < planners_.size())
+    {
+      successful_races_++;
+      statistics_[selected].selected++;
+    }
+    for (std::size_t i = 0; i < planners_.size(); ++i)
+    {
+      statistics_[i].attempts++;
+      if (race.attempts[i].success)
+      {
+        statistics_[i].successes++;
+        statistics_[i].total_planning_time += race.attempts[i].planning_time;
+      }
+    }
+  }
+
+  std::shared_ptr<moveit::planning_interface::MoveGroupInterface> move_group_interface_;
+  rclcpp_action::Client<MoveGroup>::SharedPtr action_client_;
+  const std::vector<PlannerConfig> planners_;
+  const std::chrono::milliseconds deadline_;
+  const Selection selection_;
+
+  std::vector<PlannerStatistics> statistics_;
+  uint64_t races_ = 0;
+  uint64_t successful_races_ = 0;
+  double total_race_time_ = 0;
+  double max_race_time_ = 0;
+  const rclcpp::Logger LOGGER = rclcpp::get_logger("parallel_planner");
+};
+
+#endif  // IIQKA_MOVEIT_EXAMPLE__PARALLEL_PLANNER_HPP_
@@ -0,0 +1,411 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IIQKA_MOVEIT_EXAMPLE__PLAN_CACHE_HPP_
+#define IIQKA_MOVEIT_EXAMPLE__PLAN_CACHE_HPP_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Eigen/Geometry"
+#include "moveit_msgs/msg/robot_trajectory.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/serialization.hpp"
+
+/**
+ * @brief Cache of planned trajectories for repeated motions, persisted in a memory-mapped file
+ *
+ * Trajectories are identified by the quantized start joint positions, the quantized goal pose and
+ *  the version of the planning scene given by the user. A cached trajectory is only returned if
+ *  the validator accepts it in the actual planning scene, rejected entries are invalidated.
+ *
+ * The file consists of a header and an append-only sequence of records, each containing the key
+ *  and the serialized trajectory. The records are indexed when the file is opened, the newest
+ *  valid record of a key is used. New records are not added if the file is full.
+ */
+class PlanCache
+{
+public:
+  using Key = std::vector<int64_t>;
+  using Validator = std::function<bool(const moveit_msgs::msg::RobotTrajectory &)>;
+
+  /**
+   * @brief Opens the cache file or creates it, if it does not exist or is not a valid cache
+   *
+   * @param path: Path of the cache file
+   * @param capacity: Size of the record area in bytes
+   * @param joint_resolution: Quantization of the start joint positions [rad]
+   * @param position_resolution: Quantization of the goal position [m]
+   * @param orientation_resolution: Quantization of the goal quaternion components
+   */
+  PlanCache(
+    const std::string & path, std::size_t capacity, double joint_resolution = 1e-3,
+    double position_resolution = 1e-4, double orientation_resolution = 1e-4)
+  : joint_resolution_(joint_resolution),
+    position_resolution_(position_resolution),
+    orientation_resolution_(orientation_resolution)
+  {
+    if (!open(path) && !create(path, capacity))
+    {
+      RCLCPP_ERROR(LOGGER, "Plan cache is disabled: %s", error_.c_str());
+      return;
+    }
+    RCLCPP_INFO(
+      LOGGER, "Plan cache %s contains %lu trajectories", path.c_str(),
+      static_cast<uint64_t>(index_.size()));
+  }
+
+  ~PlanCache()
+  {
+    if (mapping_ != nullptr)
+    {
+      msync(mapping_, size_, MS_SYNC);
+      munmap(mapping_, size_);
+    }
+    if (fd_ >= 0)
+    {
+      close(fd_);
+    }
+  }
+
+  PlanCache(const PlanCache &) = delete;
+  PlanCache & operator=(const PlanCache &) = delete;
+
+  Key makeKey(
+    const std::vector<double> & start_positions, const Eigen::Isometry3d & goal,
+    uint64_t scene_version) const
+  {
+    Key key;
+    key.reserve(start_positions.size() + 8);
+    key.push_back(static_cast<int64_t>(scene_version));
+    for (double position : start_positions)
+    {
+      key.push_back(std::llround(position / joint_resolution_));
+    }
+    const Eigen::Vector3d translation = goal.translation();
+    for (int i = 0; i < 3; ++i)
+    {
+      key.push_back(std::llround(translation[i] / position_resolution_));
+    }
+    // q and -q are the same orientation
+    Eigen::Quaterniond orientation(goal.rotation());
+    if (orientation.w() < 0)
+    {
+      orientation.coeffs() *= -1;
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+      key.push_back(std::llround(orientation.coeffs()[i] / orientation_resolution_));
+    }
+    return key;
+  }
+
+  /**
+   * @brief Returns the cached trajectory of the key, if it is accepted by the validator
+   *
+   * @return the trajectory or nullptr on a miss
+   */
+  moveit_msgs::msg::RobotTrajectory::SharedPtr lookup(const Key & key, const Validator & validator)
+  {
+    lookups_++;
+    auto entry = index_.find(hash(key));
+    if (entry == index_.end() || !matches(entry->second, key))
+    {
+      return nullptr;
+    }
+
+    auto trajectory = std::make_shared<moveit_msgs::msg::RobotTrajectory>();
+    if (!deserialize(entry->second, *trajectory))
+    {
+      return nullptr;
+    }
+    if (!validator(*trajectory))
+    {
+      rejected_++;
+      record(entry->second)->valid = 0;
+      index_.erase(entry);
+      return nullptr;
+    }
+    hits_++;
+    return trajectory;
+  }
+
+  void insert(const Key & key, const moveit_msgs::msg::RobotTrajectory & trajectory)
+  {
+    if (header_ == nullptr)
+    {
+      return;
+    }
+
+    rclcpp::SerializedMessage serialized;
+    serializer_.serialize_message(&trajectory, &serialized);
+    const auto & buffer = serialized.get_rcl_serialized_message();
+    const std::size_t record_size =
+      align(sizeof(Record) + key.size() * sizeof(int64_t) + buffer.buffer_length);
+    const uint64_t offset = header_->used;
+    if (offset + record_size > header_->capacity)
+    {
+      if (!full_)
+      {
+        RCLCPP_WARN(LOGGER, "Plan cache is full, new trajectories are not stored");
+        full_ = true;
+      }
+      return;
+    }
+
+    auto * bytes = records_ + offset;
+    auto * new_record = reinterpret_cast<Record *>(bytes);
+    new_record->size = record_size;
+    new_record->hash = hash(key);
+    new_record->key_size = static_cast<uint32_t>(key.size());
+    new_record->valid = 1;
+    new_record->data_size = buffer.buffer_length;
+    std::memcpy(bytes + sizeof(Record), key.data(), key.size() * sizeof(int64_t));
+    std::memcpy(
+      bytes + sizeof(Record) + key.size() * sizeof(int64_t), buffer.buffer, buffer.buffer_length);
+
+    // The record is complete before it is counted, so an interrupted write is ignored on opening
+    auto previous = index_.find(new_record->hash);
+    if (previous != index_.end())
+    {
+      record(previous->second)->valid = 0;
+    }
+    header_->used = offset + record_size;
+    index_[new_record->hash] = offset;
+    insertions_++;
+  }
+
+  void logStatistics() const
+  {
+    RCLCPP_INFO(
+      LOGGER,
+      "Plan cache: %lu lookups, %lu hits (%.1f %%), %lu rejected by validation, %lu new "
+      "trajectories, %lu of %lu bytes used",
+      lookups_, hits_, lookups_ > 0 ? 100.0 * hits_ / lookups_ : 0.0, rejected_, insertions_,
+      header_ != nullptr ? header_->used : 0, header_ != nullptr ? header_->capacity : 0);
+  }
+
+private:
+  static constexpr char MAGIC[8] = {'K', 'U', 'K', 'A', 'P', 'L', 'N', '\0'};
+  static constexpr uint32_t VERSION = 1;
+
+  struct Header
+  {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t capacity;
+    // Bytes of the record area used by complete records
+    uint64_t used;
+  };
+
+  // Followed by the key and the serialized trajectory, the size is padded to 8 bytes
+  struct Record
+  {
+    uint64_t size;
+    uint64_t hash;
+    uint32_t key_size;
+    uint32_t valid;
+    uint64_t data_size;
+  };
+
+  static std::size_t align(std::size_t size) { return (size + 7) / 8 * 8; }
+
+  // FNV-1a hash of the key
+  static uint64_t hash(const Key & key)
+  {
+    uint64_t result = 14695981039346656037ULL;
+    const auto * bytes = reinterpret_cast<const unsigned char *>(key.data());
+    for (std::size_t i = 0; i < key.size() * sizeof(int64_t); ++i)
+    {
+      result = (result ^ bytes[i]) * 1099511628211ULL;
+    }
+    return result;
+  }
+
+  Record * record(uint64_t offset) const { return reinterpret_cast<Record *>(records_ + offset); }
+
+  bool matches(uint64_t offset, const Key & key) const
+  {
+    const Record * entry = record(offset);
+    return entry->key_size == key.size() &&
+           std::memcmp(
+             records_ + offset + sizeof(Record), key.data(), key.size() * sizeof(int64_t)) == 0;
+  }
+
+  // The key and the data of the record fit in its size, without overflow of the sum
+  static bool isConsistent(const Record & entry)
+  {
+    if (entry.size < sizeof(Record))
+    {
+      return false;
+    }
+    const uint64_t payload = entry.size - sizeof(Record);
+    const uint64_t key_bytes = static_cast<uint64_t>(entry.key_size) * sizeof(int64_t);
+    return key_bytes <= payload && entry.data_size <= payload - key_bytes;
+  }
+
+  bool deserialize(uint64_t offset, moveit_msgs::msg::RobotTrajectory & trajectory)
+  {
+    const Record * entry = record(offset);
+    rclcpp::SerializedMessage serialized(entry->data_size);
+    auto & buffer = serialized.get_rcl_serialized_message();
+    std::memcpy(
+      buffer.buffer, records_ + offset + sizeof(Record) + entry->key_size * sizeof(int64_t),
+      entry->data_size);
+    buffer.buffer_length = entry->data_size;
+    try
+    {
+      serializer_.deserialize_message(&serialized, &trajectory);
+    }
+    catch (const std::exception & e)
+    {
+      RCLCPP_ERROR(LOGGER, "Failed to read cached trajectory: %s", e.what());
+      return false;
+    }
+    return true;
+  }
+
+  bool map(const std::string & path)
+  {
+    mapping_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping_ == MAP_FAILED)
+    {
+      mapping_ = nullptr;
+      error_ = "Failed to map " + path + ": " + std::strerror(errno);
+      close(fd_);
+      fd_ = -1;
+      return false;
+    }
+    header_ = static_cast<Header *>(mapping_);
+    records_ = static_cast<char *>(mapping_) + sizeof(Header);
+    return true;
+  }
+
+  bool open(const std::string & path)
+  {
+    fd_ = ::open(path.c_str(), O_RDWR);
+    if (fd_ < 0)
+    {
+      return false;
+    }
+    struct stat status;
+    if (fstat(fd_, &status) != 0 || static_cast<std::size_t>(status.st_size) < sizeof(Header))
+    {
+      close(fd_);
+      fd_ = -1;
+      return false;
+    }
+    size_ = static_cast<std::size_t>(status.st_size);
+    if (!map(path))
+    {
+      return false;
+    }
+
+    if (
+      std::memcmp(header_->magic, MAGIC, sizeof(MAGIC)) != 0 || header_->version != VERSION ||
+      sizeof(Header) + header_->capacity > size_ || header_->used > header_->capacity)
+    {
+      RCLCPP_WARN(LOGGER, "%s is not a valid plan cache, creating a new one", path.c_str());
+      munmap(mapping_, size_);
+      mapping_ = nullptr;
+      header_ = nullptr;
+      close(fd_);
+      fd_ = -1;
+      return false;
+    }
+
+    for (uint64_t offset = 0; offset < header_->used;)
+    {
+      const Record * entry = record(offset);
+      if (!isConsistent(*entry) || offset + entry->size > header_->used)
+      {
+        // Records after a corrupted one cannot be found, they are overwritten
+        header_->used = offset;
+        break;
+      }
+      if (entry->valid != 0)
+      {
+        index_[entry->hash] = offset;
+      }
+      offset += entry->size;
+    }
+    return true;
+  }
+
+  bool create(const std::string & path, std::size_t capacity)
+  {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0)
+    {
+      error_ = "Failed to create " + path + ": " + std::strerror(errno);
+      return false;
+    }
+    size_ = sizeof(Header) + align(capacity);
+    const int result = posix_fallocate(fd_, 0, static_cast<off_t>(size_));
+    if (result != 0)
+    {
+      error_ = "Failed to allocate " + path + ": " + std::strerror(result);
+      close(fd_);
+      fd_ = -1;
+      return false;
+    }
+    if (!map(path))
+    {
+      return false;
+    }
+    std::memcpy(header_->magic, MAGIC, sizeof(MAGIC));
+    header_->version = VERSION;
+    header_->reserved = 0;
+    header_->capacity = align(capacity);
+    header_->used = 0;
+    return true;
+  }
+
+  const double joint_resolution_;
+  const double position_resolution_;
+  const double orientation_resolution_;
+
+  int fd_ = -1;
+  void * mapping_ = nullptr;
+  std::size_t size_ = 0;
+  Header * header_ = nullptr;
+  char * records_ = nullptr;
+  std::string error_;
+  bool full_ = false;
+
+  // Offset of the newest valid record for every key hash
+  std::unordered_map<uint64_t, uint64_t> index_;
+  rclcpp::Serialization<moveit_msgs::msg::RobotTrajectory> serializer_;
+
+  uint64_t lookups_ = 0;
+  uint64_t hits_ = 0;
+  uint64_t rejected_ = 0;
+  uint64_t insertions_ = 0;
+  const rclcpp::Logger LOGGER = rclcpp::get_logger("plan_cache");
+};
+
+#endif  // IIQKA_MOVEIT_EXAMPLE__PLAN_CACHE_HPP_
@@ -0,0 +1,94 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IIQKA_MOVEIT_EXAMPLE__PLANNING_SCENE_BATCH_HPP_
+#define IIQKA_MOVEIT_EXAMPLE__PLANNING_SCENE_BATCH_HPP_
+
+#include <string>
+
+#include "moveit_msgs/msg/attached_collision_object.hpp"
+#include "moveit_msgs/msg/collision_object.hpp"
+#include "moveit_msgs/msg/planning_scene.hpp"
+
+/**
+ * @brief Collects changes of the planning scene into a single diff
+ *
+ * The diff is applied by the move_group server in one step. Attaching and detaching is processed
+ *  before the changes of the world, so an object added in the same batch cannot be attached.
+ */
+class PlanningSceneBatch
+{
+public:
+  PlanningSceneBatch() { clear(); }
+
+  void addObject(const moveit_msgs::msg::CollisionObject & object)
+  {
+    diff_.world.collision_objects.push_back(object);
+    diff_.world.collision_objects.back().operation = moveit_msgs::msg::CollisionObject::ADD;
+    changes_++;
+  }
+
+  void removeObject(const std::string & object_id)
+  {
+    moveit_msgs::msg::CollisionObject object;
+    object.id = object_id;
+    object.operation = moveit_msgs::msg::CollisionObject::REMOVE;
+    diff_.world.collision_objects.push_back(object);
+    changes_++;
+  }
+
+  // Moves an object of the world to the given link
+  void attachObject(const std::string & object_id, const std::string & link_name)
+  {
+    moveit_msgs::msg::AttachedCollisionObject attached_object;
+    attached_object.link_name = link_name;
+    attached_object.object.id = object_id;
+    attached_object.object.operation = moveit_msgs::msg::CollisionObject::ADD;
+    diff_.robot_state.attached_collision_objects.push_back(attached_object);
+    changes_++;
+  }
+
+  // Detaches the object from the link and removes it from the scene
+  void detachAndRemoveObject(const std::string & object_id, const std::string & link_name)
+  {
+    moveit_msgs::msg::AttachedCollisionObject attached_object;
+    attached_object.link_name = link_name;
+    attached_object.object.id = object_id;
+    attached_object.object.operation = moveit_msgs::msg::CollisionObject::REMOVE;
+    diff_.robot_state.attached_collision_objects.push_back(attached_object);
+    removeObject(object_id);
+  }
+
+  const moveit_msgs::msg::PlanningScene & diff() const { return diff_; }
+
+  // Number of collected changes
+  std::size_t size() const { return changes_; }
+
+  bool empty() const { return changes_ == 0; }
+
+  void clear()
+  {
+    diff_ = moveit_msgs::msg::PlanningScene();
+    diff_.name = "scene";
+    diff_.is_diff = true;
+    diff_.robot_state.is_diff = true;
+    changes_ = 0;
+  }
+
+private:
+  moveit_msgs::msg::PlanningScene diff_;
+  std::size_t changes_ = 0;
+};
+
+#endif  // IIQKA_MOVEIT_EXAMPLE__PLANNING_SCENE_BATCH_HPP_
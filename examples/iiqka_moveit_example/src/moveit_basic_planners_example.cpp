@@ -59,6 +59,21 @@ int main(int argc, char * argv[])
     example_node->addBreakPoint();
     example_node->moveGroupInterface()->execute(*planned_trajectory);
   }
+  example_node->addBreakPoint();
+
+  // Cartesian path along a circle
+  planned_trajectory = example_node->drawCircle();
+  if (planned_trajectory != nullptr)
+  {
+    example_node->drawTrajectory(*planned_trajectory);
+    example_node->addBreakPoint();
+    example_node->moveGroupInterface()->execute(*planned_trajectory);
+  }
+  else
+  {
+    example_node->drawTitle("Failed planning the Cartesian circle");
+  }
+  example_node->addBreakPoint();
 
   // Add collision object
   example_node->addCollisionBox(
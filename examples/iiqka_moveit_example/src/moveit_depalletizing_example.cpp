@@ -14,15 +14,54 @@
 
 #include <math.h>
 
+#include <chrono>
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "iiqka_moveit_example/async_trajectory_executor.hpp"
 #include "iiqka_moveit_example/moveit_example.hpp"
+#include "iiqka_moveit_example/parallel_planner.hpp"
 
 class Depalletizer : public MoveitExample
 {
 public:
+  void initializePipeline()
+  {
+    // Two RRTConnect seeds race with the Pilz planners, which are faster if the path is free
+    parallel_planner_ = std::make_unique<ParallelPlanner>(
+      shared_from_this(), move_group_interface_,
+      // The sampling planners are stopped soon after the Pilz planners would have finished
+      std::vector<ParallelPlanner::PlannerConfig>{
+        {"ompl", "RRTConnectkConfigDefault", std::chrono::milliseconds(500)},
+        {"ompl", "RRTConnectkConfigDefault", std::chrono::milliseconds(500)},
+        {"pilz_industrial_motion_planner", "PTP"},
+        {"pilz_industrial_motion_planner", "LIN"}},
+      std::chrono::milliseconds(1000), ParallelPlanner::Selection::FIRST_SOLUTION);
+    trajectory_executor_ = std::make_unique<AsyncTrajectoryExecutor>(shared_from_this());
+  }
+
+  moveit_msgs::msg::RobotTrajectory::SharedPtr planToPointParallel(
+    const Eigen::Isometry3d & pose, const std::vector<double> & start_positions,
+    uint64_t scene_version, const moveit_msgs::msg::PlanningScene & scene_diff)
+  {
+    move_group_interface_->setPoseTarget(pose);
+    return planWithCache(
+      pose, start_positions, scene_version, scene_diff,
+      [this, &scene_diff]()
+      {
+        moveit_msgs::msg::RobotTrajectory::SharedPtr trajectory;
+        do
+        {
+          trajectory = parallel_planner_->plan(scene_diff);
+        } while (trajectory == nullptr && rclcpp::ok());
+        return trajectory;
+      });
+  }
+
   void Depalletize()
   {
+    std::vector<Segment> segments;
     for (int k = 0; k < 3; k++)
     {
       for (int j = 0; j < 3; j++)
@@ -30,46 +69,147 @@ public:
         for (int i = 0; i < 3; i++)
         {
           std::string object_name = "pallet_" + std::to_string(9 * k + 3 * j + i);
-          RCLCPP_INFO(LOGGER, "Going for object %s", object_name.c_str());
 
-          // Go to pickup
+          // Go to pickup, then attach object
           Eigen::Isometry3d pose = Eigen::Isometry3d(
             Eigen::Translation3d(0.3 + i * 0.1, j * 0.1 - 0.1, 0.35 - 0.1 * k) *
             Eigen::Quaterniond(0, 1, 0, 0));
-          auto planned_trajectory =
-            planToPointUntilSuccess(pose, "ompl", "RRTConnectkConfigDefault");
-          if (planned_trajectory != nullptr)
-          {
-            move_group_interface_->execute(*planned_trajectory);
-          }
-          else
-          {
-            RCLCPP_ERROR(LOGGER, "Planning failed");
-          }
-
-          // Attach object
-          AttachObject(object_name);
+          segments.push_back({object_name, pose, attachObjectDiff(object_name)});
 
-          // Drop off to -0.3, 0.0, 0.35 pointing down
+          // Drop off to -0.3, 0.0, 0.35 pointing down, then detach
           Eigen::Isometry3d dropoff_pose = Eigen::Isometry3d(
             Eigen::Translation3d(-0.3, 0.0, 0.35) * Eigen::Quaterniond(0, 1, 0, 0));
-          auto drop_trajectory =
-            planToPointUntilSuccess(dropoff_pose, "ompl", "RRTConnectkConfigDefault");
-          if (drop_trajectory != nullptr)
-          {
-            move_group_interface_->execute(*drop_trajectory);
-          }
-          else
+          segments.push_back({object_name, dropoff_pose, detachAndRemoveObjectDiff(object_name)});
+        }
+      }
+    }
+
+    // Each motion is planned while the previous one is executed, starting from its end state and
+    //  with the scene change following it, so the robot does not wait for the planner
+    std::vector<SegmentTiming> timings(segments.size());
+    const auto start = std::chrono::steady_clock::now();
+    auto trajectory =
+      planToPointParallel(segments[0].pose, {}, scene_version_, moveit_msgs::msg::PlanningScene());
+    timings[0].planning = millisecondsSince(start);
+    auto previous_finish = start;
+
+    for (std::size_t s = 0; s < segments.size() && trajectory != nullptr; ++s)
+    {
+      const auto & segment = segments[s];
+      if (s % 2 == 0)
+      {
+        RCLCPP_INFO(LOGGER, "Going for object %s", segment.object_name.c_str());
+      }
+
+      const auto execution_start = std::chrono::steady_clock::now();
+      timings[s].idle =
+        std::chrono::duration<double, std::milli>(execution_start - previous_finish).count();
+      std::chrono::steady_clock::time_point execution_finish;
+      const uint64_t scene_version = scene_version_;
+      auto execution = trajectory_executor_->execute(
+        *trajectory,
+        [this, &segment, &execution_finish](bool success)
+        {
+          execution_finish = std::chrono::steady_clock::now();
+          // The scene is changed before the next motion starts and the motion after it is planned
+          if (success && !applyPlanningScene(segment.scene_change))
           {
-            RCLCPP_ERROR(LOGGER, "Planning failed");
+            RCLCPP_ERROR(
+              LOGGER, "Failed to apply the scene change of %s", segment.object_name.c_str());
           }
+        });
 
-          // Detach
-          DetachAndRemoveObject(object_name);
-        }
+      moveit_msgs::msg::RobotTrajectory::SharedPtr next_trajectory;
+      if (s + 1 < segments.size())
+      {
+        const auto planning_start = std::chrono::steady_clock::now();
+        setStartState(*trajectory);
+        // The cache key is the state of the cell after the current motion and its scene change
+        next_trajectory = planToPointParallel(
+          segments[s + 1].pose, trajectory->joint_trajectory.points.back().positions,
+          scene_version + 1, segment.scene_change);
+        timings[s + 1].planning = millisecondsSince(planning_start);
       }
+
+      if (!execution.get())
+      {
+        RCLCPP_ERROR(LOGGER, "Execution failed");
+        break;
+      }
+      timings[s].execution =
+        std::chrono::duration<double, std::milli>(execution_finish - execution_start).count();
+      previous_finish = execution_finish;
+      trajectory = next_trajectory;
+
+      if (s % 2 == 1)
+      {
+        logTimings(segment.object_name, timings[s - 1], timings[s]);
+      }
+    }
+    move_group_interface_->setStartStateToCurrentState();
+
+    SegmentTiming total;
+    for (const auto & timing : timings)
+    {
+      total.planning += timing.planning;
+      total.execution += timing.execution;
+      total.idle += timing.idle;
     }
+    RCLCPP_INFO(
+      LOGGER,
+      "Depalletizing finished in %.0f ms: planning %.0f ms, execution %.0f ms, robot waiting for "
+      "the planner %.0f ms",
+      millisecondsSince(start), total.planning, total.execution, total.idle);
+    parallel_planner_->logStatistics();
+    logPlanCacheStatistics();
   }
+
+private:
+  struct Segment
+  {
+    std::string object_name;
+    Eigen::Isometry3d pose;
+    // Applied to the planning scene after the motion
+    moveit_msgs::msg::PlanningScene scene_change;
+  };
+
+  // Durations in milliseconds
+  struct SegmentTiming
+  {
+    double planning = 0;
+    double execution = 0;
+    // Time between the end of the previous motion and the start of this one
+    double idle = 0;
+  };
+
+  static double millisecondsSince(std::chrono::steady_clock::time_point start)
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+      .count();
+  }
+
+  // Sets the start state of the next planning request to the end of the given trajectory
+  void setStartState(const moveit_msgs::msg::RobotTrajectory & trajectory)
+  {
+    moveit_msgs::msg::RobotState start_state;
+    start_state.is_diff = true;
+    start_state.joint_state.name = trajectory.joint_trajectory.joint_names;
+    start_state.joint_state.position = trajectory.joint_trajectory.points.back().positions;
+    move_group_interface_->setStartState(start_state);
+  }
+
+  void logTimings(
+    const std::string & object_name, const SegmentTiming & pickup, const SegmentTiming & dropoff)
+  {
+    RCLCPP_INFO(
+      LOGGER,
+      "Object %s: planning %.0f + %.0f ms, execution %.0f + %.0f ms, robot waiting %.0f + %.0f ms",
+      object_name.c_str(), pickup.planning, dropoff.planning, pickup.execution, dropoff.execution,
+      pickup.idle, dropoff.idle);
+  }
+
+  std::unique_ptr<ParallelPlanner> parallel_planner_;
+  std::unique_ptr<AsyncTrajectoryExecutor> trajectory_executor_;
 };
 
 int main(int argc, char * argv[])
@@ -83,6 +223,10 @@ int main(int argc, char * argv[])
   std::thread([&executor]() { executor.spin(); }).detach();
 
   node->initialize();
+  node->initializePipeline();
+  // Repeated runs of the same cell reuse the trajectories planned in earlier runs
+  node->enablePlanCache(
+    node->declare_parameter<std::string>("plan_cache_file", "depalletizing_plan_cache.bin"));
 
   node->moveGroupInterface()->setMaxVelocityScalingFactor(1.0);
   node->moveGroupInterface()->setMaxAccelerationScalingFactor(1.0);
@@ -90,8 +234,8 @@ int main(int argc, char * argv[])
   node->addRobotPlatform();
   node->addBreakPoint();
 
-  // Add pallets
-  node->addPalletObjects();
+  // Add pallets, optionally timing an update per pallet for comparison
+  node->addPalletObjects(node->declare_parameter<bool>("compare_scene_updates", false));
   node->addBreakPoint();
 
   node->Depalletize();
@@ -0,0 +1,388 @@
+# Copyright 2024 Aron Svastits
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import datetime
+import json
+import math
+import threading
+import time
+import xml.etree.ElementTree as ET
+
+import rclpy
+from rclpy.action import ActionClient
+from rclpy.duration import Duration
+from rclpy.executors import MultiThreadedExecutor
+from rclpy.node import Node
+from rclpy.time import Time
+
+from control_msgs.action import FollowJointTrajectory
+from control_msgs.msg import JointTrajectoryControllerState
+from rcl_interfaces.srv import GetParameters
+from std_msgs.msg import String
+from trajectory_msgs.msg import JointTrajectoryPoint
+
+REPORT_VERSION = 2
+
+
+def point_to_point(start, amplitude, duration):
+    """Single point moving every joint by the amplitude."""
+    point = JointTrajectoryPoint()
+    point.positions = [position + amplitude for position in start]
+    point.velocities = [0.0] * len(start)
+    point.time_from_start = Duration(seconds=duration).to_msg()
+    return [point]
+
+
+def sine(start, amplitude, duration, point_count=50):
+    """Full sine period on every joint, densely sampled with velocities."""
+    points = []
+    for i in range(1, point_count + 1):
+        t = duration * i / point_count
+        phase = 2 * math.pi * t / duration
+        point = JointTrajectoryPoint()
+        point.positions = [position + amplitude * math.sin(phase) for position in start]
+        point.velocities = [amplitude * 2 * math.pi / duration * math.cos(phase) for _ in start]
+        point.time_from_start = Duration(seconds=t).to_msg()
+        points.append(point)
+    return points
+
+
+TRAJECTORIES = {"point_to_point": point_to_point, "sine": sine}
+
+
+def parse_rsi_correction(telegram):
+    """Return the joint correction of an RSI command telegram, None if it is not one."""
+    try:
+        correction = ET.fromstring(telegram).find("AK")
+    except ET.ParseError:
+        return None
+    if correction is None:
+        return None
+    return [float(value) for _, value in sorted(correction.attrib.items())]
+
+
+def max_difference(first, second):
+    return max((abs(a - b) for a, b in zip(first, second)), default=0.0)
+
+
+def summarize(values):
+    values = sorted(value for value in values if value is not None)
+    if not values:
+        return None
+
+    def percentile(p):
+        return values[min(len(values) - 1, int(math.ceil(p / 100.0 * len(values))) - 1)]
+
+    return {
+        "count": len(values),
+        "min": values[0],
+        "mean": sum(values) / len(values),
+        "p50": percentile(50),
+        "p95": percentile(95),
+        "max": values[-1],
+    }
+
+
+class TrajectoryLatencyBenchmark(Node):
+    """Send standardized trajectories to a joint trajectory controller and measure its latencies.
+
+    Measured for every goal:
+    - goal sent to first command: time from sending the goal until the first update of the
+      controller commanding a position different from the one before the goal
+    - goal sent to accepted: time until the acceptance of the goal is received by the client
+    - command to telegram: time from the first command until the first RSI telegram with a changed
+      joint correction is reported by the RSI simulator, only if a telegram topic is configured
+    - tracking error: maximum and RMS of the controller error during the motion, and the error
+      after the settle time
+    The resolution of the first latency is the period of the controller state messages. The stamps
+    of the state messages are compared with the clock of this node, therefore the controller
+    manager must not use a hardware clock.
+    """
+
+    def __init__(self):
+        super().__init__("trajectory_latency_benchmark")
+        self.declare_parameter("driver", "")
+        self.declare_parameter("controller_name", "joint_trajectory_controller")
+        self.declare_parameter("controller_manager", "controller_manager")
+        self.declare_parameter("repetitions", 5)
+        self.declare_parameter("amplitude", 0.1)
+        self.declare_parameter("motion_duration", 2.0)
+        self.declare_parameter("settle_time", 0.5)
+        self.declare_parameter("command_threshold", 1e-6)
+        self.declare_parameter("telegram_topic", "")
+        self.declare_parameter("output_file", "trajectory_latency_benchmark.json")
+
+        self.controller_name_ = self.get_parameter("controller_name").value
+        self.amplitude_ = self.get_parameter("amplitude").value
+        self.motion_duration_ = self.get_parameter("motion_duration").value
+        self.command_threshold_ = self.get_parameter("command_threshold").value
+
+        self.lock_ = threading.Lock()
+        self.last_state_ = None
+        self.recording_ = False
+        self.samples_ = []
+        self.telegrams_ = []
+        self.last_correction_ = None
+        self.time_base_ = "unknown"
+
+        self.action_client_ = ActionClient(
+            self, FollowJointTrajectory, self.controller_name_ + "/follow_joint_trajectory"
+        )
+        self.state_sub_ = self.create_subscription(
+            JointTrajectoryControllerState,
+            self.controller_name_ + "/controller_state",
+            self.state_callback,
+            100,
+        )
+        telegram_topic = self.get_parameter("telegram_topic").value
+        if telegram_topic:
+            self.telegram_sub_ = self.create_subscription(
+                String, telegram_topic, self.telegram_callback, 100
+            )
+
+    def state_callback(self, msg):
+        with self.lock_:
+            self.last_state_ = msg
+            if self.recording_:
+                self.samples_.append(msg)
+
+    def telegram_callback(self, msg):
+        correction = parse_rsi_correction(msg.data)
+        if correction is None:
+            return
+        stamp = self.get_clock().now()
+        with self.lock_:
+            self.last_correction_ = correction
+            if self.recording_:
+                self.telegrams_.append((stamp, correction))
+
+    def wait_for_future(self, future, timeout):
+        end = time.monotonic() + timeout
+        while not future.done() and time.monotonic() < end and rclpy.ok():
+            time.sleep(0.001)
+        return future.done()
+
+    def wait_until_ready(self, timeout=30.0):
+        if not self.action_client_.wait_for_server(timeout_sec=timeout):
+            self.get_logger().error(f"Action server of {self.controller_name_} is not available")
+            return False
+        if not self.check_time_base():
+            return False
+        end = time.monotonic() + timeout
+        while time.monotonic() < end and rclpy.ok():
+            with self.lock_:
+                if self.last_state_ is not None:
+                    return True
+            time.sleep(0.01)
+        self.get_logger().error(f"No state received from {self.controller_name_}")
+        return False
+
+    def check_time_base(self, timeout=5.0):
+        """Refuse to run if the controller states are stamped with a hardware clock."""
+        controller_manager = self.get_parameter("controller_manager").value
+        client = self.create_client(GetParameters, controller_manager + "/get_parameters")
+        hardware_clock = None
+        if client.wait_for_service(timeout_sec=timeout):
+            future = client.call_async(GetParameters.Request(names=["hardware_clock"]))
+            if self.wait_for_future(future, timeout) and future.result().values:
+                hardware_clock = future.result().values[0].string_value
+        self.destroy_client(client)
+
+        if hardware_clock is None:
+            self.get_logger().warn(
+                f"Could not read the hardware_clock parameter of {controller_manager}, "
+                "the time base of the state stamps is unknown"
+            )
+            self.time_base_ = "unknown"
+        elif hardware_clock:
+            self.get_logger().error(
+                f"{controller_manager} uses the hardware clock of {hardware_clock}, the state "
+                "stamps cannot be compared with the clock of the benchmark"
+            )
+            return False
+        else:
+            self.time_base_ = "system_clock"
+        return True
+
+    def run_goal(self, trajectory_name, sign):
+        with self.lock_:
+            state = self.last_state_
+            baseline_correction = self.last_correction_
+            self.samples_ = []
+            self.telegrams_ = []
+            self.recording_ = True
+        start = list(state.feedback.positions)
+        baseline = list(state.reference.positions) or start
+
+        goal = FollowJointTrajectory.Goal()
+        goal.trajectory.joint_names = list(state.joint_names)
+        goal.trajectory.points = TRAJECTORIES[trajectory_name](
+            start, sign * self.amplitude_, self.motion_duration_
+        )
+
+        # The controller can start commanding before the client receives the acceptance, so the
+        #  latency is measured from sending the goal
+        accepted = []
+        sent = self.get_clock().now()
+        send_future = self.action_client_.send_goal_async(goal)
+        send_future.add_done_callback(lambda _: accepted.append(self.get_clock().now()))
+        run = {"accepted": False, "error_code": None}
+        done = self.wait_for_future(send_future, 5.0)
+        if not done or not send_future.result().accepted:
+            self.get_logger().error(f"Goal of {trajectory_name} was rejected")
+            with self.lock_:
+                self.recording_ = False
+            return run
+        run["accepted"] = True
+        result_future = send_future.result().get_result_async()
+        self.wait_for_future(result_future, self.motion_duration_ + 10.0)
+        motion_end = self.get_clock().now()
+        if result_future.done():
+            run["error_code"] = result_future.result().result.error_code
+        time.sleep(self.get_parameter("settle_time").value)
+
+        with self.lock_:
+            self.recording_ = False
+            samples = self.samples_
+            telegrams = self.telegrams_
+
+        run.update(
+            self.evaluate(sent, motion_end, baseline, baseline_correction, samples, telegrams)
+        )
+        run["goal_sent_to_accepted_ms"] = (
+            (accepted[0] - sent).nanoseconds / 1e6 if accepted else None
+        )
+        return run
+
+    def evaluate(self, sent, motion_end, baseline, baseline_correction, samples, telegrams):
+        # The samples are recorded from before sending the goal, so none of the commands is missed
+        first_command = None
+        for sample in samples:
+            if max_difference(sample.reference.positions, baseline) > self.command_threshold_:
+                first_command = Time.from_msg(sample.header.stamp)
+                break
+
+        first_telegram = None
+        if first_command is not None and baseline_correction is not None:
+            for stamp, correction in telegrams:
+                if (
+                    stamp >= first_command
+                    and max_difference(correction, baseline_correction) > self.command_threshold_
+                ):
+                    first_telegram = stamp
+                    break
+
+        errors = [
+            max((abs(e) for e in sample.error.positions), default=0.0)
+            for sample in samples
+            if sent <= Time.from_msg(sample.header.stamp) <= motion_end
+        ]
+
+        def milliseconds(start, end):
+            if start is None or end is None:
+                return None
+            return (end - start).nanoseconds / 1e6
+
+        return {
+            "goal_sent_to_first_command_ms": milliseconds(sent, first_command),
+            "command_to_telegram_ms": milliseconds(first_command, first_telegram),
+            "max_tracking_error": max(errors) if errors else None,
+            "rms_tracking_error": (
+                math.sqrt(sum(e * e for e in errors) / len(errors)) if errors else None
+            ),
+            "final_error": (
+                max((abs(e) for e in samples[-1].error.positions), default=0.0)
+                if samples
+                else None
+            ),
+            "state_samples": len(samples),
+        }
+
+    def run(self):
+        repetitions = self.get_parameter("repetitions").value
+        report = {
+            "benchmark": "trajectory_latency",
+            "version": REPORT_VERSION,
+            "date": datetime.datetime.now(datetime.timezone.utc).isoformat(),
+            "driver": self.get_parameter("driver").value,
+            "controller": self.controller_name_,
+            # Clock of the controller state stamps, the latencies are valid with the system clock
+            "time_base": self.time_base_,
+            "parameters": {
+                "repetitions": repetitions,
+                "amplitude": self.amplitude_,
+                "motion_duration": self.motion_duration_,
+                "settle_time": self.get_parameter("settle_time").value,
+                "command_threshold": self.command_threshold_,
+                "telegram_topic": self.get_parameter("telegram_topic").value,
+            },
+            "joint_names": list(self.last_state_.joint_names),
+            "trajectories": {},
+        }
+
+        for name in TRAJECTORIES:
+            runs = []
+            for repetition in range(repetitions):
+                if not rclpy.ok():
+                    break
+                # Alternating direction keeps the robot around its start position
+                runs.append(self.run_goal(name, 1.0 if repetition % 2 == 0 else -1.0))
+            summary = {
+                key: summarize(run.get(key) for run in runs)
+                for key in (
+                    "goal_sent_to_first_command_ms",
+                    "goal_sent_to_accepted_ms",
+                    "command_to_telegram_ms",
+                    "max_tracking_error",
+                    "rms_tracking_error",
+                    "final_error",
+                )
+            }
+            report["trajectories"][name] = {"runs": runs, "summary": summary}
+            self.log_summary(name, summary)
+
+        output_file = self.get_parameter("output_file").value
+        with open(output_file, "w") as f:
+            json.dump(report, f, indent=2)
+        self.get_logger().info(f"Report written to {output_file}")
+
+    def log_summary(self, name, summary):
+        def mean(key):
+            return f"{summary[key]['mean']:.3f}" if summary[key] is not None else "n/a"
+
+        self.get_logger().info(
+            f"{name}: goal sent to first command {mean('goal_sent_to_first_command_ms')} ms, "
+            f"command to telegram {mean('command_to_telegram_ms')} ms, "
+            f"max tracking error {mean('max_tracking_error')} rad"
+        )
+
+
+def main():
+    rclpy.init()
+    node = TrajectoryLatencyBenchmark()
+    executor = MultiThreadedExecutor()
+    executor.add_node(node)
+    spin_thread = threading.Thread(target=executor.spin, daemon=True)
+    spin_thread.start()
+
+    if node.wait_until_ready():
+        node.run()
+
+    executor.shutdown()
+    node.destroy_node()
+    rclpy.try_shutdown()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,127 @@
+# Copyright 2024 Aron Svastits
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from ament_index_python.packages import get_package_share_directory
+
+from launch import LaunchDescription
+from launch.actions import (
+    DeclareLaunchArgument,
+    EmitEvent,
+    ExecuteProcess,
+    IncludeLaunchDescription,
+    OpaqueFunction,
+    RegisterEventHandler,
+    TimerAction,
+)
+from launch.event_handlers import OnProcessExit
+from launch.events import Shutdown
+from launch.launch_description_sources.python_launch_description_source import (
+    PythonLaunchDescriptionSource,
+)
+from launch.substitutions import LaunchConfiguration
+from launch_ros.actions import Node
+
+# Driver package and whether the local stand-in is the fake hardware or the RSI simulator
+DRIVERS = {
+    "rsi": ("kuka_kss_rsi_driver", False),
+    "fri": ("kuka_sunrise_fri_driver", True),
+    "eac": ("kuka_iiqka_eac_driver", True),
+}
+
+RSI_TELEGRAM_TOPIC = "/rsi_simulator_node/rsi/command"
+
+
+def launch_setup(context, *args, **kwargs):
+    driver = LaunchConfiguration("driver").perform(context)
+    if driver not in DRIVERS:
+        raise RuntimeError(f"Unknown driver '{driver}', expected one of {list(DRIVERS)}")
+    package, use_fake_hardware = DRIVERS[driver]
+
+    actions = [
+        IncludeLaunchDescription(
+            PythonLaunchDescriptionSource(
+                [get_package_share_directory(package), "/launch/", "startup.launch.py"]
+            ),
+            launch_arguments={"use_fake_hardware": str(use_fake_hardware).lower()}.items(),
+        )
+    ]
+    if not use_fake_hardware:
+        actions.append(
+            IncludeLaunchDescription(
+                PythonLaunchDescriptionSource(
+                    [
+                        get_package_share_directory("kuka_rsi_simulator"),
+                        "/launch/",
+                        "kuka_rsi_simulator.launch.py",
+                    ]
+                )
+            )
+        )
+
+    # Same activation sequence as the driver activation tests
+    actions.append(
+        TimerAction(
+            period=10.0,
+            actions=[
+                ExecuteProcess(
+                    cmd=["ros2", "lifecycle", "set", "robot_manager", "configure"],
+                    output="screen",
+                )
+            ],
+        )
+    )
+    actions.append(
+        TimerAction(
+            period=15.0,
+            actions=[
+                ExecuteProcess(
+                    cmd=["ros2", "lifecycle", "set", "robot_manager", "activate"],
+                    output="screen",
+                )
+            ],
+        )
+    )
+
+    benchmark = Node(
+        package="kuka_driver_benchmark",
+        executable="trajectory_latency_benchmark",
+        output="screen",
+        parameters=[
+            {
+                "driver": driver,
+                "repetitions": int(LaunchConfiguration("repetitions").perform(context)),
+                "amplitude": float(LaunchConfiguration("amplitude").perform(context)),
+                "telegram_topic": "" if use_fake_hardware else RSI_TELEGRAM_TOPIC,
+                "output_file": LaunchConfiguration("output_file"),
+            }
+        ],
+    )
+    actions.append(TimerAction(period=20.0, actions=[benchmark]))
+    actions.append(
+        RegisterEventHandler(
+            OnProcessExit(target_action=benchmark, on_exit=[EmitEvent(event=Shutdown())])
+        )
+    )
+    return actions
+
+
+def generate_launch_description():
+    launch_arguments = []
+    launch_arguments.append(DeclareLaunchArgument("driver", default_value="rsi"))
+    launch_arguments.append(DeclareLaunchArgument("repetitions", default_value="5"))
+    launch_arguments.append(DeclareLaunchArgument("amplitude", default_value="0.1"))
+    launch_arguments.append(
+        DeclareLaunchArgument("output_file", default_value="trajectory_latency_benchmark.json")
+    )
+    return LaunchDescription(launch_arguments + [OpaqueFunction(function=launch_setup)])
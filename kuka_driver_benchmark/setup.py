@@ -0,0 +1,47 @@
+# Copyright 2024 Aron Svastits
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from setuptools import setup
+import os
+from glob import glob
+
+package_name = "kuka_driver_benchmark"
+
+setup(
+    name=package_name,
+    version="0.9.2",
+    packages=[package_name],
+    data_files=[
+        ("share/ament_index/resource_index/packages", ["resource/" + package_name]),
+        ("share/" + package_name, ["package.xml"]),
+        (
+            os.path.join("share", package_name, "launch"),
+            glob(os.path.join("launch", "*.launch.py")),
+        ),
+    ],
+    install_requires=["setuptools"],
+    zip_safe=True,
+    maintainer="Aron Svastits",
+    maintainer_email="svastits1@gmail.com",
+    description="Trajectory execution latency benchmark for the KUKA drivers.",
+    license="Apache-2.0",
+    entry_points={
+        "console_scripts": [
+            "trajectory_latency_benchmark = "
+            "kuka_driver_benchmark.trajectory_latency_benchmark:main"
+        ],
+    },
+    tests_require=["pytest"],
+    test_suite="test",
+)
@@ -0,0 +1,101 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef KUKA_DRIVERS_CORE__CLOCK_SYNC_HPP_
+#define KUKA_DRIVERS_CORE__CLOCK_SYNC_HPP_
+
+#include <cstddef>
+#include <vector>
+
+namespace kuka_drivers_core
+{
+/**
+ * @brief Estimates the mapping from the clock of the robot controller to a local clock
+ *
+ * The controller time of every received state is paired with the local time of reception, and a
+ *  line is fitted to the pairs of a sliding window with least squares. The slope is the drift of
+ *  the clocks, the receive delay only shifts the line, therefore the mapped time of a state is its
+ *  controller time in the local clock plus the mean delay, without the jitter of the reception.
+ *  Pairs whose reception was delayed much more than usual (e.g. by the scheduler) are rejected
+ *  as outliers. If the clock of the controller jumps, consecutive rejections restart the estimate.
+ *
+ * The window is allocated in the constructor, the other methods do not allocate memory. The
+ *  sums of the regression are updated incrementally and recomputed from the window whenever it
+ *  wraps, so rounding errors cannot accumulate and the times are stored relative to a recent
+ *  origin to keep the precision of large epoch-based timestamps.
+ */
+class ClockSync
+{
+public:
+  /**
+   * @param window_size: Number of samples in the regression
+   * @param outlier_threshold: Samples further from the line than this multiple of the standard
+   *  deviation of the residuals are rejected
+   * @param min_deviation: Lower bound of the standard deviation used for the rejection [s]
+   */
+  explicit ClockSync(
+    std::size_t window_size = 1000, double outlier_threshold = 4.0, double min_deviation = 50e-6);
+
+  void reset();
+
+  /**
+   * @brief Adds the controller time of a state and the local time of its reception [s]
+   *
+   * @return false if the sample was rejected as an outlier
+   */
+  bool addSample(double controller_time, double local_time);
+
+  // Maps a controller time to the local clock [s], the first sample must have been added before
+  double toLocalTime(double controller_time) const;
+
+  // Local seconds per controller second
+  double getDrift() const { return slope_; }
+
+  bool hasSamples() const { return count_ > 0; }
+
+private:
+  struct Sample
+  {
+    double controller_time;
+    double local_time;
+  };
+
+  void fit();
+  void rebase();
+
+  const std::size_t window_size_;
+  const double outlier_threshold_;
+  const double min_deviation_;
+
+  // Samples relative to the origin, stored in a ring buffer
+  std::vector<Sample> samples_;
+  std::size_t next_ = 0;
+  std::size_t count_ = 0;
+  std::size_t consecutive_outliers_ = 0;
+  double controller_origin_ = 0;
+  double local_origin_ = 0;
+
+  double sum_x_ = 0;
+  double sum_y_ = 0;
+  double sum_xx_ = 0;
+  double sum_xy_ = 0;
+
+  // Fitted line in the relative times: local = intercept + slope * controller
+  double slope_ = 1;
+  double intercept_ = 0;
+  double residual_variance_ = 0;
+};
+}  // namespace kuka_drivers_core
+
+#endif  // KUKA_DRIVERS_CORE__CLOCK_SYNC_HPP_
@@ -0,0 +1,103 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef KUKA_DRIVERS_CORE__CONNECTION_HEALTH_HPP_
+#define KUKA_DRIVERS_CORE__CONNECTION_HEALTH_HPP_
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+namespace kuka_drivers_core
+{
+/**
+ * @brief Health of the connection to the robot controller, updated in the read() of the drivers
+ *
+ * The values are exported as the standard health state interfaces (see hardware_interface_types),
+ *  therefore they are stored as doubles with stable addresses. The connection quality is the
+ *  filtered ratio of the received states, drivers with a native quality measure can overwrite it.
+ *  Missed states are only counted after the first state was received.
+ */
+class ConnectionHealth
+{
+public:
+  explicit ConnectionHealth(double quality_filter_gain = 0.01) : gain_(quality_filter_gain) {}
+
+  // Should be called at activation, before the first state is received
+  void reset()
+  {
+    missed_cycles_ = 0;
+    receive_period_ = 0;
+    connection_quality_ = 0;
+    has_received_ = false;
+  }
+
+  /**
+   * @brief Registers a received state
+   *
+   * @param missed: Number of states lost since the previous one, if the driver can detect it
+   *  (e.g. from a gap in the controller timestamps)
+   */
+  void stateReceived(uint64_t missed = 0)
+  {
+    const auto now = std::chrono::steady_clock::now();
+    if (!has_received_)
+    {
+      connection_quality_ = 1;
+      has_received_ = true;
+    }
+    else
+    {
+      receive_period_ = std::chrono::duration<double>(now - last_receive_).count();
+      if (missed > 0)
+      {
+        missed_cycles_ += static_cast<double>(missed);
+        connection_quality_ *= std::pow(1 - gain_, static_cast<double>(missed));
+      }
+    }
+    last_receive_ = now;
+    connection_quality_ += gain_ * (1 - connection_quality_);
+  }
+
+  // Registers a cycle without a received state
+  void stateMissed()
+  {
+    if (!has_received_)
+    {
+      return;
+    }
+    missed_cycles_ += 1;
+    connection_quality_ -= gain_ * connection_quality_;
+  }
+
+  void setConnectionQuality(double quality) { connection_quality_ = quality; }
+
+  double * missedCycles() { return &missed_cycles_; }
+  double * receivePeriod() { return &receive_period_; }
+  double * connectionQuality() { return &connection_quality_; }
+
+private:
+  const double gain_;
+  bool has_received_ = false;
+  std::chrono::steady_clock::time_point last_receive_;
+
+  double missed_cycles_ = 0;
+  // Time between the last two received states [s]
+  double receive_period_ = 0;
+  // Between 0 (no states received) and 1 (no states missed)
+  double connection_quality_ = 0;
+};
+}  // namespace kuka_drivers_core
+
+#endif  // KUKA_DRIVERS_CORE__CONNECTION_HEALTH_HPP_
@@ -0,0 +1,78 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef KUKA_DRIVERS_CORE__HARDWARE_CLOCK_HPP_
+#define KUKA_DRIVERS_CORE__HARDWARE_CLOCK_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace kuka_drivers_core
+{
+/**
+ * @brief Time and period of the last cycle of a robot controller, shared between the hardware
+ *  interface and the control loop of the process
+ *
+ * The hardware interface ticks the clock in read() when a state is received, the control node
+ *  passes the time and period of the tick to the controllers instead of reading the system clock.
+ *  The clocks are registered by the name of the hardware component, ticking and consuming do not
+ *  lock or allocate.
+ */
+class HardwareClock
+{
+public:
+  // Returns the clock of the given hardware component, which is created at the first call
+  static std::shared_ptr<HardwareClock> get(const std::string & hardware_name);
+
+  /**
+   * @brief Registers a cycle of the robot controller
+   *
+   * @param time_ns: ROS time of the state [ns]
+   * @param period_ns: Time since the previous cycle [ns], zero if unknown
+   */
+  void tick(int64_t time_ns, int64_t period_ns)
+  {
+    time_ns_.store(time_ns, std::memory_order_relaxed);
+    period_ns_.store(period_ns, std::memory_order_relaxed);
+    ticks_.fetch_add(1, std::memory_order_release);
+  }
+
+  /**
+   * @brief Returns the time and period of the last cycle, if there was a tick since the previous
+   *  call. Should be called from a single thread, after the read() of the hardware.
+   */
+  bool consume(int64_t & time_ns, int64_t & period_ns)
+  {
+    const uint64_t ticks = ticks_.load(std::memory_order_acquire);
+    if (ticks == consumed_ticks_)
+    {
+      return false;
+    }
+    consumed_ticks_ = ticks;
+    time_ns = time_ns_.load(std::memory_order_relaxed);
+    period_ns = period_ns_.load(std::memory_order_relaxed);
+    return true;
+  }
+
+private:
+  std::atomic<int64_t> time_ns_{0};
+  std::atomic<int64_t> period_ns_{0};
+  std::atomic<uint64_t> ticks_{0};
+  uint64_t consumed_ticks_ = 0;
+};
+}  // namespace kuka_drivers_core
+
+#endif  // KUKA_DRIVERS_CORE__HARDWARE_CLOCK_HPP_
@@ -0,0 +1,201 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef KUKA_DRIVERS_CORE__HARDWARE_INTERFACE_BASE_HPP_
+#define KUKA_DRIVERS_CORE__HARDWARE_INTERFACE_BASE_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "hardware_interface/system_interface.hpp"
+#include "rclcpp/logger.hpp"
+
+#include "kuka_drivers_core/clock_sync.hpp"
+#include "kuka_drivers_core/connection_health.hpp"
+#include "kuka_drivers_core/hardware_clock.hpp"
+#include "kuka_drivers_core/hardware_event.hpp"
+#include "kuka_drivers_core/velocity_integrator.hpp"
+
+namespace kuka_drivers_core
+{
+/**
+ * @brief Common base of the hardware interfaces of the KUKA drivers
+ *
+ * Provides the building blocks shared by the drivers:
+ *  - validation of the joint interfaces of the robot description against a table
+ *  - events of the client libraries delivered to the control loop without locking
+ *  - deadline of the blocking receive, measured from the last received state
+ *  - per-cycle timing: connection health and the time between receiving the state and sending
+ *    the command, exported as the health state interfaces (see hardware_interface_types)
+ *  - the time of the states in the robot controller clock, mapped to ROS time
+ *  - the hardware clock of the component, ticked with every received state (see HardwareClock)
+ *  - velocity command interfaces for robot controllers accepting only positions, integrated in
+ *    the cycles of the hardware clock (see VelocityIntegrator)
+ *
+ * The protected methods must be called from the control loop.
+ */
+class HardwareInterfaceBase : public hardware_interface::SystemInterface
+{
+public:
+  // Can be called from any thread, e.g. from the callbacks of the client libraries
+  void setServerEvent(HardwareEvent event)
+  {
+    server_event_.store(event, std::memory_order_release);
+  }
+
+  // Can be called from any thread, e.g. when the robot controller restarts the cycles
+  void resetCycleCount() { cycle_count_.store(0, std::memory_order_relaxed); }
+
+  // Rejects claiming the position and the velocity command interface of a joint at the same time
+  hardware_interface::return_type prepare_command_mode_switch(
+    const std::vector<std::string> & start_interfaces,
+    const std::vector<std::string> & stop_interfaces) override;
+
+  // Starts the integration of the velocity of the joints whose velocity interface is claimed
+  hardware_interface::return_type perform_command_mode_switch(
+    const std::vector<std::string> & start_interfaces,
+    const std::vector<std::string> & stop_interfaces) override;
+
+protected:
+  explicit HardwareInterfaceBase(const std::string & logger_name);
+
+  /**
+   * @brief Checks that all joints have exactly the given interfaces in the given order
+   *
+   * @return false (after logging the mismatch) if a joint has different interfaces
+   */
+  bool validateJointInterfaces(
+    const std::vector<std::string> & command_interfaces,
+    const std::vector<std::string> & state_interfaces) const;
+
+  // Exports the health state interfaces with the name of the hardware component as prefix, and the
+  //  server state if the driver reports events
+  void exportHealthStateInterfaces(
+    std::vector<hardware_interface::StateInterface> & state_interfaces, bool server_state = true);
+
+  // Exports the controller time and the ROS time of the last state, for drivers calling
+  //  setControllerTime()
+  void exportTimestampStateInterfaces(
+    std::vector<hardware_interface::StateInterface> & state_interfaces);
+
+  /**
+   * @brief Resets the health, the cycle counter and the clocks, should be called at activation
+   *
+   * @param receive_timeout: Maximum time between two received states, zero disables the deadline
+   */
+  void startCycles(std::chrono::nanoseconds receive_timeout = std::chrono::nanoseconds(0));
+
+  /**
+   * @brief Timeout of the next blocking receive
+   *
+   * The receive waits at most until the deadline of the next state, so a series of shorter waits
+   *  cannot exceed the allowed time between two states. Before the first state and without a
+   *  deadline the given maximum is returned.
+   */
+  std::chrono::nanoseconds receiveTimeout(std::chrono::nanoseconds max_wait) const;
+
+  /**
+   * @brief Registers a received state, should be called in read()
+   *
+   * Ticks the hardware clock with the time of reception, which is overridden by the controller time
+   *  if setControllerTime() is called.
+   *
+   * @param missed: Number of states lost since the previous one, if the driver can detect it
+   */
+  void stateReceived(uint64_t missed = 0);
+
+  // Registers a read() without a received state
+  void stateMissed();
+
+  /**
+   * @brief Registers the robot controller time of the last received state, should be called after
+   *  stateReceived()
+   *
+   * The time is mapped to the steady clock of the reception, and converted to ROS time (of the
+   *  system clock) at the current offset between the two clocks, so adjustments of the system
+   *  clock do not disturb the estimate.
+   *
+   * @param controller_time: Time of the measurement in the clock of the robot controller [s]
+   */
+  void setControllerTime(double controller_time);
+
+  /**
+   * @brief Exports a velocity command interface for every joint, for drivers commanding positions
+   *
+   * The velocities are limited by the optional 'max_velocity' parameter of the joint, the
+   *  setpoints by the 'min' and 'max' parameters of the position command interface [rad].
+   */
+  void exportVelocityCommandInterfaces(
+    std::vector<hardware_interface::CommandInterface> & command_interfaces);
+
+  /**
+   * @brief Integrates the claimed velocity commands into the position commands, should be called
+   *  in write() before sending the positions
+   *
+   * The period is the time since the previous state, the same as the period of the hardware clock.
+   *  The position commands must hold the last sent setpoints, these are not claimed by
+   *  controllers while the velocity of the joint is integrated.
+   */
+  void integrateVelocityCommands(std::vector<double> & position_commands) const
+  {
+    velocity_integrator_.integrate(cycle_period_, position_commands);
+  }
+
+  // Registers the command sent in response to the last state, should be called in write()
+  void commandSent();
+
+  // Copies the last event to the server state interface, should be called in read()
+  void updateServerState()
+  {
+    server_state_ = static_cast<double>(server_event_.load(std::memory_order_acquire));
+  }
+
+  // Number of states received since activation or the last reset
+  uint64_t cycleCount() const { return cycle_count_.load(std::memory_order_relaxed); }
+
+  const rclcpp::Logger logger_;
+  ConnectionHealth health_;
+
+private:
+  std::atomic<HardwareEvent> server_event_{HardwareEvent::HARDWARE_EVENT_UNSPECIFIED};
+  std::atomic<uint64_t> cycle_count_{0};
+
+  std::chrono::nanoseconds receive_timeout_{0};
+  std::chrono::steady_clock::time_point last_receive_;
+  bool has_received_ = false;
+  ClockSync clock_sync_;
+  std::shared_ptr<HardwareClock> hardware_clock_;
+  // Time since the previous state, in the controller clock if available [s]
+  double cycle_period_ = 0;
+
+  VelocityIntegrator velocity_integrator_;
+  // Joints whose position command interface is claimed, tracked if velocities are exported
+  std::vector<char> position_claimed_;
+
+  // State interfaces
+  double server_state_ = 0;
+  // Time between receiving the last state and sending the command in response [s]
+  double response_time_ = 0;
+  // Robot controller time of the last state [s]
+  double timestamp_ = 0;
+  // ROS time of the last state, estimated from the controller time [s]
+  double ros_timestamp_ = 0;
+};
+}  // namespace kuka_drivers_core
+
+#endif  // KUKA_DRIVERS_CORE__HARDWARE_INTERFACE_BASE_HPP_
@@ -15,6 +15,8 @@
 #ifndef KUKA_DRIVERS_CORE__HARDWARE_INTERFACE_TYPES_HPP_
 #define KUKA_DRIVERS_CORE__HARDWARE_INTERFACE_TYPES_HPP_
 
+#include <array>
+
 namespace hardware_interface
 {
 /* Custom interfaces */
@@ -24,6 +26,20 @@ static constexpr char HW_IF_STIFFNESS[] = "stiffness";
 static constexpr char HW_IF_DAMPING[] = "damping";
 // Constant defining external torque interface
 static constexpr char HW_IF_EXTERNAL_TORQUE[] = "external_torque";
+// Constant defining the interface of the robot controller time of the last state [s], the prefix
+//  is the name of the hardware component
+static constexpr char TIMESTAMP[] = "timestamp";
+// Constant defining the interface of the ROS time of the last state [s], estimated from the robot
+//  controller time (see kuka_drivers_core::ClockSync), the prefix is the name of the hardware
+//  component
+static constexpr char ROS_TIMESTAMP[] = "ros_timestamp";
+
+/* Cartesian impedance interfaces */
+// The stiffness and damping interfaces of the Cartesian axes and the null space have the prefix
+//  CARTESIAN_IMPEDANCE_PREFIX + "_" + axis
+static constexpr char CARTESIAN_IMPEDANCE_PREFIX[] = "cartesian_impedance";
+static constexpr std::array<const char *, 7> CARTESIAN_IMPEDANCE_AXES = {
+  "x", "y", "z", "a", "b", "c", "nullspace"};
 
 /* Interface prefixes */
 // Constant defining prefix for I/O interfaces
@@ -55,6 +71,16 @@ static constexpr char TRACKING_PERFORMANCE[] = "tracking_performance";
 // Constant defining server_state interface necessary for event broadcasting
 static constexpr char SERVER_STATE[] = "server_state";
 
+/* Health state interfaces, with the name of the hardware component as prefix
+ *  (see kuka_drivers_core::HardwareInterfaceBase) */
+// Number of cycles without a state from the robot controller since activation
+static constexpr char MISSED_CYCLES[] = "missed_cycles";
+// Time between the last two states received from the robot controller [s]
+static constexpr char RECEIVE_PERIOD[] = "receive_period";
+// Time between receiving the last state and sending the command in response [s]
+static constexpr char RESPONSE_TIME[] = "response_time";
+// The quality of the connection between 0 and 1 is exported as CONNECTION_QUALITY
+
 }  // namespace hardware_interface
 
 #endif  // KUKA_DRIVERS_CORE__HARDWARE_INTERFACE_TYPES_HPP_
@@ -0,0 +1,65 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef KUKA_DRIVERS_CORE__TIMING_DIAGNOSTICS_HPP_
+#define KUKA_DRIVERS_CORE__TIMING_DIAGNOSTICS_HPP_
+
+#include <string>
+
+#include "diagnostic_msgs/msg/diagnostic_array.hpp"
+#include "rclcpp_lifecycle/lifecycle_node.hpp"
+
+#include "kuka_drivers_core/update_timer.hpp"
+
+namespace kuka_drivers_core
+{
+/**
+ * @brief Publishes the update timing statistics of a controller on the /diagnostics topic
+ *
+ * The budget of the controller is set by the following parameters of its node:
+ *  - timing.budget: Maximum execution time of update() [ms], zero disables the budget
+ *  - timing.critical: Critical controllers are not skipped after exceeding their budget
+ *  - timing.diagnostics_rate: Rate of publishing the statistics [Hz]
+ */
+class TimingDiagnostics
+{
+public:
+  /**
+   * @brief Declares the timing parameters, should be called in the on_init() of the controller
+   *
+   * @param critical: Default value of the timing.critical parameter
+   */
+  static void declareParameters(
+    const rclcpp_lifecycle::LifecycleNode::SharedPtr & node, bool critical);
+
+  /**
+   * @brief Configures the timer from the parameters of the node and starts publishing its
+   *  statistics, the timer must outlive this object
+   */
+  TimingDiagnostics(const rclcpp_lifecycle::LifecycleNode::SharedPtr & node, UpdateTimer & timer);
+
+private:
+  void publish();
+
+  const UpdateTimer & timer_;
+  const std::string status_name_;
+  uint64_t published_overruns_ = 0;
+  rclcpp::Clock::SharedPtr clock_;
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr publisher_;
+  rclcpp::TimerBase::SharedPtr timer_callback_;
+  diagnostic_msgs::msg::DiagnosticArray diagnostics_msg_;
+};
+}  // namespace kuka_drivers_core
+
+#endif  // KUKA_DRIVERS_CORE__TIMING_DIAGNOSTICS_HPP_
@@ -0,0 +1,93 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef KUKA_DRIVERS_CORE__UPDATE_TIMER_HPP_
+#define KUKA_DRIVERS_CORE__UPDATE_TIMER_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace kuka_drivers_core
+{
+/**
+ * @brief Measures the execution time of the update() of a controller against a time budget
+ *
+ * start() and stop() are called by the control loop and do not allocate or lock, the statistics
+ *  can be read from any other thread. A non-critical controller exceeding its budget skips its next
+ *  update, so the spike of an auxiliary plugin does not delay consecutive cycles. Critical
+ *  controllers are never skipped, their overruns are only counted.
+ */
+class UpdateTimer
+{
+public:
+  // Bucket i of the histogram counts updates shorter than 2^i microseconds (and not shorter than
+  //  the limit of the previous bucket), the last bucket counts all longer updates
+  static constexpr std::size_t HISTOGRAM_BUCKETS = 16;
+
+  struct Statistics
+  {
+    uint64_t updates = 0;
+    uint64_t skipped = 0;
+    uint64_t overruns = 0;
+    std::chrono::nanoseconds total{0};
+    std::chrono::nanoseconds max{0};
+    std::array<uint64_t, HISTOGRAM_BUCKETS> histogram{};
+  };
+
+  /**
+   * @brief Sets the budget and resets the statistics, must not be called during update
+   *
+   * @param budget: Maximum execution time of an update, zero disables the budget
+   * @param critical: Critical controllers are not skipped after exceeding the budget
+   */
+  void configure(std::chrono::nanoseconds budget, bool critical);
+
+  /**
+   * @brief Starts the measurement of an update
+   *
+   * @return false if the update should be skipped, because the previous one exceeded the budget
+   */
+  bool start();
+
+  void stop();
+
+  Statistics getStatistics() const;
+
+  std::chrono::nanoseconds getBudget() const { return budget_; }
+
+  bool isCritical() const { return critical_; }
+
+  // Upper limit of the given histogram bucket in microseconds, the last bucket is not limited
+  static uint64_t getBucketLimit(std::size_t bucket) { return uint64_t{1} << bucket; }
+
+private:
+  std::chrono::nanoseconds budget_{0};
+  bool critical_ = true;
+  bool skip_next_ = false;
+  std::chrono::steady_clock::time_point start_time_;
+
+  // Written only by the control loop
+  std::atomic<uint64_t> updates_{0};
+  std::atomic<uint64_t> skipped_{0};
+  std::atomic<uint64_t> overruns_{0};
+  std::atomic<int64_t> total_ns_{0};
+  std::atomic<int64_t> max_ns_{0};
+  std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> histogram_{};
+};
+}  // namespace kuka_drivers_core
+
+#endif  // KUKA_DRIVERS_CORE__UPDATE_TIMER_HPP_
@@ -0,0 +1,77 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef KUKA_DRIVERS_CORE__VELOCITY_INTEGRATOR_HPP_
+#define KUKA_DRIVERS_CORE__VELOCITY_INTEGRATOR_HPP_
+
+#include <cstddef>
+#include <vector>
+
+namespace kuka_drivers_core
+{
+/**
+ * @brief Integrates joint velocity commands into position setpoints, for robot controllers
+ *  accepting only positions
+ *
+ * The velocities are integrated over the measured period of the robot controller, so the
+ *  setpoints follow the commanded motion also if the cycles jitter or states are lost. A velocity
+ *  is held for the whole cycle, therefore the setpoint reaching a position limit within the cycle
+ *  stops exactly at the limit, and the integration does not wind up beyond it. Setpoints outside
+ *  the limits (e.g. at activation) are only allowed to move back towards them.
+ *
+ * Only the joints enabled with setActive() are integrated, the setpoints of the others are not
+ *  modified. Memory is allocated only in resize().
+ */
+class VelocityIntegrator
+{
+public:
+  // Sets the number of joints, disables them and resets the commands and limits
+  void resize(std::size_t joint_count);
+
+  // Sets the range of the setpoint of a joint [rad], infinite values disable the limit
+  void setPositionLimits(std::size_t joint, double min_position, double max_position);
+
+  // Sets the maximum absolute velocity of a joint [rad/s], infinity disables the limit
+  void setVelocityLimit(std::size_t joint, double max_velocity);
+
+  // Starts or stops integrating the velocity of a joint, the velocity command is reset to zero
+  void setActive(std::size_t joint, bool active);
+
+  bool isActive(std::size_t joint) const { return active_[joint]; }
+
+  /**
+   * @brief Integrates the velocity commands of the active joints into the given setpoints
+   *
+   * Invalid (not finite) velocities are handled as zero.
+   *
+   * @param period: Time of the cycle in the robot controller clock [s], nothing is integrated if
+   *  it is not positive
+   * @param positions: Setpoints of the joints, the last commanded positions [rad]
+   */
+  void integrate(double period, std::vector<double> & positions) const;
+
+  // Velocity commands of the joints [rad/s], the storage of the command interfaces
+  std::vector<double> & commands() { return commands_; }
+
+private:
+  std::vector<double> commands_;
+  std::vector<double> min_positions_;
+  std::vector<double> max_positions_;
+  std::vector<double> max_velocities_;
+  std::vector<char> active_;
+  std::size_t active_count_ = 0;
+};
+}  // namespace kuka_drivers_core
+
+#endif  // KUKA_DRIVERS_CORE__VELOCITY_INTEGRATOR_HPP_
@@ -0,0 +1,151 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "kuka_drivers_core/clock_sync.hpp"
+
+namespace kuka_drivers_core
+{
+namespace
+{
+// The slope is fitted only after the samples span enough time, before that the clocks are assumed
+//  to run at the same rate
+constexpr std::size_t MIN_FIT_SAMPLES = 10;
+// Filter gain of the variance of the residuals
+constexpr double VARIANCE_GAIN = 0.01;
+}  // namespace
+
+ClockSync::ClockSync(std::size_t window_size, double outlier_threshold, double min_deviation)
+: window_size_(std::max<std::size_t>(window_size, MIN_FIT_SAMPLES)),
+  outlier_threshold_(outlier_threshold),
+  min_deviation_(min_deviation)
+{
+  samples_.resize(window_size_);
+}
+
+void ClockSync::reset()
+{
+  next_ = 0;
+  count_ = 0;
+  consecutive_outliers_ = 0;
+  sum_x_ = 0;
+  sum_y_ = 0;
+  sum_xx_ = 0;
+  sum_xy_ = 0;
+  slope_ = 1;
+  intercept_ = 0;
+  residual_variance_ = 0;
+}
+
+bool ClockSync::addSample(double controller_time, double local_time)
+{
+  if (count_ == 0)
+  {
+    controller_origin_ = controller_time;
+    local_origin_ = local_time;
+  }
+  const double x = controller_time - controller_origin_;
+  const double y = local_time - local_origin_;
+
+  if (count_ >= MIN_FIT_SAMPLES)
+  {
+    const double residual = y - (intercept_ + slope_ * x);
+    const double limit =
+      outlier_threshold_ * std::max(std::sqrt(residual_variance_), min_deviation_);
+    // Outliers are also considered with a clipped residual, so the limit can adapt to larger jitter
+    const double clipped = std::min(std::abs(residual), limit);
+    residual_variance_ += VARIANCE_GAIN * (clipped * clipped - residual_variance_);
+    if (std::abs(residual) > limit)
+    {
+      // A lasting offset means that one of the clocks jumped, the old samples are invalid
+      if (++consecutive_outliers_ > window_size_ / 10)
+      {
+        reset();
+        return addSample(controller_time, local_time);
+      }
+      return false;
+    }
+  }
+  consecutive_outliers_ = 0;
+
+  if (count_ == window_size_)
+  {
+    const Sample & oldest = samples_[next_];
+    sum_x_ -= oldest.controller_time;
+    sum_y_ -= oldest.local_time;
+    sum_xx_ -= oldest.controller_time * oldest.controller_time;
+    sum_xy_ -= oldest.controller_time * oldest.local_time;
+  }
+  else
+  {
+    count_++;
+  }
+  samples_[next_] = {x, y};
+  sum_x_ += x;
+  sum_y_ += y;
+  sum_xx_ += x * x;
+  sum_xy_ += x * y;
+
+  if (++next_ == window_size_)
+  {
+    next_ = 0;
+    rebase();
+  }
+  fit();
+  return true;
+}
+
+double ClockSync::toLocalTime(double controller_time) const
+{
+  const double x = controller_time - controller_origin_;
+  return local_origin_ + intercept_ + slope_ * x;
+}
+
+void ClockSync::fit()
+{
+  const double n = static_cast<double>(count_);
+  const double mean_x = sum_x_ / n;
+  const double mean_y = sum_y_ / n;
+  const double variance_x = sum_xx_ - sum_x_ * mean_x;
+  if (count_ >= MIN_FIT_SAMPLES && variance_x > 0)
+  {
+    slope_ = (sum_xy_ - sum_x_ * mean_y) / variance_x;
+  }
+  intercept_ = mean_y - slope_ * mean_x;
+}
+
+void ClockSync::rebase()
+{
+  // Move the origin to the newest sample and recompute the sums from the window
+  const Sample newest = samples_[(next_ + window_size_ - 1) % window_size_];
+  controller_origin_ += newest.controller_time;
+  local_origin_ += newest.local_time;
+  sum_x_ = 0;
+  sum_y_ = 0;
+  sum_xx_ = 0;
+  sum_xy_ = 0;
+  for (std::size_t i = 0; i < count_; ++i)
+  {
+    Sample & sample = samples_[i];
+    sample.controller_time -= newest.controller_time;
+    sample.local_time -= newest.local_time;
+    sum_x_ += sample.controller_time;
+    sum_y_ += sample.local_time;
+    sum_xx_ += sample.controller_time * sample.controller_time;
+    sum_xy_ += sample.controller_time * sample.local_time;
+  }
+}
+}  // namespace kuka_drivers_core
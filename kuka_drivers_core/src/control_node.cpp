@@ -13,12 +13,15 @@
 // limitations under the License.
 
 #include <memory>
+#include <string>
 #include <thread>
 
 #include "controller_manager/controller_manager.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "std_msgs/msg/bool.hpp"
 
+#include "kuka_drivers_core/hardware_clock.hpp"
+
 int main(int argc, char ** argv)
 {
   rclcpp::init(argc, argv);
@@ -52,11 +55,47 @@ int main(int argc, char ** argv)
         rclcpp::Duration::from_seconds(1.0 / controller_manager->get_update_rate());
       std::chrono::milliseconds dt_ms{1000 / controller_manager->get_update_rate()};
 
+      // With a hardware clock the time and period passed to the controllers are those of the
+      //  cycles of the robot controller, instead of the system clock and the nominal period
+      std::string hardware_clock_name;
+      controller_manager->get_parameter_or<std::string>("hardware_clock", hardware_clock_name, "");
+      std::shared_ptr<kuka_drivers_core::HardwareClock> hardware_clock;
+      if (!hardware_clock_name.empty())
+      {
+        hardware_clock = kuka_drivers_core::HardwareClock::get(hardware_clock_name);
+        RCLCPP_INFO(
+          controller_manager->get_logger(), "Using the cycles of '%s' as time base",
+          hardware_clock_name.c_str());
+      }
+      const auto clock_type = controller_manager->get_clock()->get_clock_type();
+      rclcpp::Time time = controller_manager->now();
+      rclcpp::Duration period = dt;
+
       try
       {
         while (rclcpp::ok())
         {
-          if (is_configured)
+          if (is_configured && hardware_clock)
+          {
+            // The read gets the time of the previous cycle, as the current one is not known yet
+            controller_manager->read(time, period);
+            int64_t time_ns = 0;
+            int64_t period_ns = 0;
+            if (hardware_clock->consume(time_ns, period_ns))
+            {
+              time = rclcpp::Time(time_ns, clock_type);
+              period = period_ns > 0 ? rclcpp::Duration::from_nanoseconds(period_ns) : dt;
+            }
+            else
+            {
+              // No state was received in this cycle (e.g. the hardware is not active)
+              time = controller_manager->now();
+              period = dt;
+            }
+            controller_manager->update(time, period);
+            controller_manager->write(time, period);
+          }
+          else if (is_configured)
           {
             controller_manager->read(controller_manager->now(), dt);
             controller_manager->update(controller_manager->now(), dt);
@@ -0,0 +1,36 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <map>
+#include <mutex>
+
+#include "kuka_drivers_core/hardware_clock.hpp"
+
+namespace kuka_drivers_core
+{
+std::shared_ptr<HardwareClock> HardwareClock::get(const std::string & hardware_name)
+{
+  // The hardware interfaces and the control node are in the same process, and link this library
+  static std::mutex registry_mutex;
+  static std::map<std::string, std::shared_ptr<HardwareClock>> registry;
+
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  auto & clock = registry[hardware_name];
+  if (!clock)
+  {
+    clock = std::make_shared<HardwareClock>();
+  }
+  return clock;
+}
+}  // namespace kuka_drivers_core
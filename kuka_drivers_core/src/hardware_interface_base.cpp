@@ -0,0 +1,288 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <limits>
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "rclcpp/logging.hpp"
+
+#include "kuka_drivers_core/hardware_interface_base.hpp"
+#include "kuka_drivers_core/hardware_interface_types.hpp"
+
+namespace kuka_drivers_core
+{
+namespace
+{
+bool validateInterfaces(
+  const rclcpp::Logger & logger, const std::string & joint, const std::string & type,
+  const std::vector<hardware_interface::InterfaceInfo> & interfaces,
+  const std::vector<std::string> & expected)
+{
+  if (interfaces.size() != expected.size())
+  {
+    RCLCPP_FATAL(
+      logger, "Joint '%s': expecting exactly %zu %s interfaces, got %zu", joint.c_str(),
+      expected.size(), type.c_str(), interfaces.size());
+    return false;
+  }
+  for (std::size_t i = 0; i < expected.size(); ++i)
+  {
+    if (interfaces[i].name != expected[i])
+    {
+      RCLCPP_FATAL(
+        logger, "Joint '%s': expecting '%s' %s interface at position %zu, got '%s'",
+        joint.c_str(), expected[i].c_str(), type.c_str(), i + 1, interfaces[i].name.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+// Whether the interface name is '<joint>/<type>', compared without allocation
+bool isJointInterface(const std::string & interface, const std::string & joint, const char * type)
+{
+  return interface.size() > joint.size() && interface.compare(0, joint.size(), joint) == 0 &&
+         interface[joint.size()] == '/' &&
+         interface.compare(joint.size() + 1, std::string::npos, type) == 0;
+}
+
+bool containsJointInterface(
+  const std::vector<std::string> & interfaces, const std::string & joint, const char * type)
+{
+  return std::any_of(
+    interfaces.begin(), interfaces.end(),
+    [&joint, type](const std::string & interface)
+    { return isJointInterface(interface, joint, type); });
+}
+
+double parseLimit(const std::string & value, double default_value)
+{
+  return value.empty() ? default_value : std::stod(value);
+}
+}  // namespace
+
+HardwareInterfaceBase::HardwareInterfaceBase(const std::string & logger_name)
+: logger_(rclcpp::get_logger(logger_name))
+{
+}
+
+bool HardwareInterfaceBase::validateJointInterfaces(
+  const std::vector<std::string> & command_interfaces,
+  const std::vector<std::string> & state_interfaces) const
+{
+  for (const auto & joint : info_.joints)
+  {
+    if (
+      !validateInterfaces(
+        logger_, joint.name, "command", joint.command_interfaces, command_interfaces) ||
+      !validateInterfaces(logger_, joint.name, "state", joint.state_interfaces, state_interfaces))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HardwareInterfaceBase::exportHealthStateInterfaces(
+  std::vector<hardware_interface::StateInterface> & state_interfaces, bool server_state)
+{
+  if (server_state)
+  {
+    state_interfaces.emplace_back(
+      hardware_interface::STATE_PREFIX, hardware_interface::SERVER_STATE, &server_state_);
+  }
+  state_interfaces.emplace_back(
+    info_.name, hardware_interface::MISSED_CYCLES, health_.missedCycles());
+  state_interfaces.emplace_back(
+    info_.name, hardware_interface::RECEIVE_PERIOD, health_.receivePeriod());
+  state_interfaces.emplace_back(
+    info_.name, hardware_interface::CONNECTION_QUALITY, health_.connectionQuality());
+  state_interfaces.emplace_back(info_.name, hardware_interface::RESPONSE_TIME, &response_time_);
+}
+
+void HardwareInterfaceBase::exportTimestampStateInterfaces(
+  std::vector<hardware_interface::StateInterface> & state_interfaces)
+{
+  state_interfaces.emplace_back(info_.name, hardware_interface::TIMESTAMP, &timestamp_);
+  state_interfaces.emplace_back(info_.name, hardware_interface::ROS_TIMESTAMP, &ros_timestamp_);
+}
+
+hardware_interface::return_type HardwareInterfaceBase::prepare_command_mode_switch(
+  const std::vector<std::string> & start_interfaces,
+  const std::vector<std::string> & stop_interfaces)
+{
+  if (position_claimed_.empty())
+  {
+    return hardware_interface::return_type::OK;
+  }
+
+  for (std::size_t i = 0; i < info_.joints.size(); ++i)
+  {
+    const std::string & joint = info_.joints[i].name;
+    const auto claimed_after_switch = [&](const char * type, bool claimed)
+    {
+      return containsJointInterface(start_interfaces, joint, type) ||
+             (claimed && !containsJointInterface(stop_interfaces, joint, type));
+    };
+    if (
+      claimed_after_switch(hardware_interface::HW_IF_POSITION, position_claimed_[i]) &&
+      claimed_after_switch(hardware_interface::HW_IF_VELOCITY, velocity_integrator_.isActive(i)))
+    {
+      RCLCPP_ERROR(
+        logger_, "Joint '%s': the position and velocity interfaces cannot be claimed together",
+        joint.c_str());
+      return hardware_interface::return_type::ERROR;
+    }
+  }
+  return hardware_interface::return_type::OK;
+}
+
+hardware_interface::return_type HardwareInterfaceBase::perform_command_mode_switch(
+  const std::vector<std::string> & start_interfaces,
+  const std::vector<std::string> & stop_interfaces)
+{
+  if (position_claimed_.empty())
+  {
+    return hardware_interface::return_type::OK;
+  }
+
+  const auto update_claims = [this](const std::vector<std::string> & interfaces, bool claimed)
+  {
+    for (std::size_t i = 0; i < info_.joints.size(); ++i)
+    {
+      const std::string & joint = info_.joints[i].name;
+      if (containsJointInterface(interfaces, joint, hardware_interface::HW_IF_VELOCITY))
+      {
+        velocity_integrator_.setActive(i, claimed);
+      }
+      if (containsJointInterface(interfaces, joint, hardware_interface::HW_IF_POSITION))
+      {
+        position_claimed_[i] = claimed;
+      }
+    }
+  };
+  // Stopping before starting keeps the joints active if a velocity controller replaces another
+  update_claims(stop_interfaces, false);
+  update_claims(start_interfaces, true);
+  return hardware_interface::return_type::OK;
+}
+
+void HardwareInterfaceBase::exportVelocityCommandInterfaces(
+  std::vector<hardware_interface::CommandInterface> & command_interfaces)
+{
+  constexpr double inf = std::numeric_limits<double>::infinity();
+  velocity_integrator_.resize(info_.joints.size());
+  position_claimed_.assign(info_.joints.size(), false);
+  for (std::size_t i = 0; i < info_.joints.size(); ++i)
+  {
+    const auto & joint = info_.joints[i];
+    for (const auto & interface : joint.command_interfaces)
+    {
+      if (interface.name == hardware_interface::HW_IF_POSITION)
+      {
+        velocity_integrator_.setPositionLimits(
+          i, parseLimit(interface.min, -inf), parseLimit(interface.max, inf));
+      }
+    }
+    const auto max_velocity = joint.parameters.find("max_velocity");
+    if (max_velocity != joint.parameters.end())
+    {
+      velocity_integrator_.setVelocityLimit(i, parseLimit(max_velocity->second, inf));
+    }
+    command_interfaces.emplace_back(
+      joint.name, hardware_interface::HW_IF_VELOCITY, &velocity_integrator_.commands()[i]);
+  }
+}
+
+void HardwareInterfaceBase::startCycles(std::chrono::nanoseconds receive_timeout)
+{
+  health_.reset();
+  resetCycleCount();
+  receive_timeout_ = receive_timeout;
+  has_received_ = false;
+  cycle_period_ = 0;
+  clock_sync_.reset();
+  response_time_ = 0;
+  if (!hardware_clock_)
+  {
+    hardware_clock_ = HardwareClock::get(info_.name);
+  }
+}
+
+std::chrono::nanoseconds HardwareInterfaceBase::receiveTimeout(
+  std::chrono::nanoseconds max_wait) const
+{
+  if (!has_received_ || receive_timeout_.count() == 0)
+  {
+    return max_wait;
+  }
+  const auto remaining = last_receive_ + receive_timeout_ - std::chrono::steady_clock::now();
+  return std::max(
+    std::chrono::nanoseconds(0),
+    std::min(max_wait, std::chrono::duration_cast<std::chrono::nanoseconds>(remaining)));
+}
+
+void HardwareInterfaceBase::stateReceived(uint64_t missed)
+{
+  const bool first_state = !has_received_;
+  last_receive_ = std::chrono::steady_clock::now();
+  has_received_ = true;
+  health_.stateReceived(missed);
+  cycle_period_ = first_state ? 0 : *health_.receivePeriod();
+  if (hardware_clock_)
+  {
+    hardware_clock_->tick(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch())
+        .count(),
+      static_cast<int64_t>(cycle_period_ * 1e9));
+  }
+  // The counter can be reset from other threads, so the increment must not overwrite a reset
+  cycle_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void HardwareInterfaceBase::stateMissed() { health_.stateMissed(); }
+
+void HardwareInterfaceBase::setControllerTime(double controller_time)
+{
+  using std::chrono::duration;
+  // The period is measured in the clock of the robot controller, which defines the cycles
+  const double period = clock_sync_.hasSamples() ? controller_time - timestamp_ : 0;
+  cycle_period_ = std::max(period, 0.0);
+  timestamp_ = controller_time;
+  clock_sync_.addSample(
+    controller_time, duration<double>(last_receive_.time_since_epoch()).count());
+
+  const auto system_offset = std::chrono::system_clock::now().time_since_epoch() -
+                             std::chrono::steady_clock::now().time_since_epoch();
+  ros_timestamp_ =
+    clock_sync_.toLocalTime(controller_time) + duration<double>(system_offset).count();
+  if (hardware_clock_)
+  {
+    hardware_clock_->tick(
+      static_cast<int64_t>(ros_timestamp_ * 1e9),
+      static_cast<int64_t>(cycle_period_ * 1e9));
+  }
+}
+
+void HardwareInterfaceBase::commandSent()
+{
+  if (has_received_)
+  {
+    response_time_ =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - last_receive_).count();
+  }
+}
+}  // namespace kuka_drivers_core
@@ -0,0 +1,111 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <string>
+
+#include "kuka_drivers_core/timing_diagnostics.hpp"
+
+namespace kuka_drivers_core
+{
+void TimingDiagnostics::declareParameters(
+  const rclcpp_lifecycle::LifecycleNode::SharedPtr & node, bool critical)
+{
+  node->declare_parameter<double>("timing.budget", 0.0);
+  node->declare_parameter<bool>("timing.critical", critical);
+  node->declare_parameter<double>("timing.diagnostics_rate", 1.0);
+}
+
+TimingDiagnostics::TimingDiagnostics(
+  const rclcpp_lifecycle::LifecycleNode::SharedPtr & node, UpdateTimer & timer)
+: timer_(timer),
+  status_name_(std::string(node->get_name()) + ": update timing"),
+  clock_(node->get_clock())
+{
+  const double budget_ms = node->get_parameter("timing.budget").as_double();
+  timer.configure(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<double, std::milli>(budget_ms > 0 ? budget_ms : 0.0)),
+    node->get_parameter("timing.critical").as_bool());
+
+  double rate = node->get_parameter("timing.diagnostics_rate").as_double();
+  if (rate <= 0)
+  {
+    RCLCPP_WARN(node->get_logger(), "Invalid diagnostics rate %.2f, using 1 Hz instead", rate);
+    rate = 1.0;
+  }
+
+  diagnostics_msg_.status.resize(1);
+  diagnostics_msg_.status[0].name = status_name_;
+  publisher_ = node->create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+    "/diagnostics", rclcpp::SystemDefaultsQoS());
+  timer_callback_ = node->create_wall_timer(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(1.0 / rate)),
+    [this]() { publish(); });
+}
+
+void TimingDiagnostics::publish()
+{
+  const auto statistics = timer_.getStatistics();
+  auto & status = diagnostics_msg_.status[0];
+  const uint64_t new_overruns = statistics.overruns - published_overruns_;
+  published_overruns_ = statistics.overruns;
+
+  if (new_overruns == 0)
+  {
+    status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+    status.message = "Update within budget";
+  }
+  else
+  {
+    status.level = timer_.isCritical() ? diagnostic_msgs::msg::DiagnosticStatus::ERROR
+                                       : diagnostic_msgs::msg::DiagnosticStatus::WARN;
+    status.message = "Budget exceeded in " + std::to_string(new_overruns) + " updates";
+  }
+
+  auto to_us = [](std::chrono::nanoseconds duration)
+  { return std::to_string(static_cast<double>(duration.count()) / 1000); };
+
+  status.values.clear();
+  auto add_value = [&status](const std::string & key, const std::string & value)
+  {
+    diagnostic_msgs::msg::KeyValue key_value;
+    key_value.key = key;
+    key_value.value = value;
+    status.values.push_back(key_value);
+  };
+  add_value("Budget [us]", to_us(timer_.getBudget()));
+  add_value("Critical", timer_.isCritical() ? "true" : "false");
+  add_value("Updates", std::to_string(statistics.updates));
+  add_value("Skipped updates", std::to_string(statistics.skipped));
+  add_value("Overruns", std::to_string(statistics.overruns));
+  add_value(
+    "Mean [us]", to_us(std::chrono::nanoseconds(
+                   statistics.updates > 0 ? statistics.total.count() / statistics.updates : 0)));
+  add_value("Max [us]", to_us(statistics.max));
+  for (std::size_t i = 0; i < UpdateTimer::HISTOGRAM_BUCKETS - 1; ++i)
+  {
+    add_value(
+      "< " + std::to_string(UpdateTimer::getBucketLimit(i)) + " us",
+      std::to_string(statistics.histogram[i]));
+  }
+  add_value(
+    ">= " + std::to_string(UpdateTimer::getBucketLimit(UpdateTimer::HISTOGRAM_BUCKETS - 2)) +
+      " us",
+    std::to_string(statistics.histogram.back()));
+
+  diagnostics_msg_.header.stamp = clock_->now();
+  publisher_->publish(diagnostics_msg_);
+}
+}  // namespace kuka_drivers_core
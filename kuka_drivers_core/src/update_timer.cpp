@@ -0,0 +1,93 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "kuka_drivers_core/update_timer.hpp"
+
+namespace kuka_drivers_core
+{
+void UpdateTimer::configure(std::chrono::nanoseconds budget, bool critical)
+{
+  budget_ = budget;
+  critical_ = critical;
+  skip_next_ = false;
+
+  updates_ = 0;
+  skipped_ = 0;
+  overruns_ = 0;
+  total_ns_ = 0;
+  max_ns_ = 0;
+  for (auto & bucket : histogram_)
+  {
+    bucket = 0;
+  }
+}
+
+bool UpdateTimer::start()
+{
+  if (skip_next_)
+  {
+    skip_next_ = false;
+    skipped_.store(skipped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return false;
+  }
+  start_time_ = std::chrono::steady_clock::now();
+  return true;
+}
+
+void UpdateTimer::stop()
+{
+  const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now() - start_time_);
+  const int64_t elapsed_ns = elapsed.count();
+
+  // There is a single writer, so a load and a store are enough instead of read-modify-write
+  updates_.store(updates_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  total_ns_.store(
+    total_ns_.load(std::memory_order_relaxed) + elapsed_ns, std::memory_order_relaxed);
+  if (elapsed_ns > max_ns_.load(std::memory_order_relaxed))
+  {
+    max_ns_.store(elapsed_ns, std::memory_order_relaxed);
+  }
+
+  std::size_t bucket = 0;
+  for (uint64_t us = static_cast<uint64_t>(elapsed_ns) / 1000;
+       us > 0 && bucket < HISTOGRAM_BUCKETS - 1; us >>= 1)
+  {
+    ++bucket;
+  }
+  histogram_[bucket].store(
+    histogram_[bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+  if (budget_.count() > 0 && elapsed > budget_)
+  {
+    overruns_.store(overruns_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    skip_next_ = !critical_;
+  }
+}
+
+UpdateTimer::Statistics UpdateTimer::getStatistics() const
+{
+  Statistics statistics;
+  statistics.updates = updates_.load(std::memory_order_relaxed);
+  statistics.skipped = skipped_.load(std::memory_order_relaxed);
+  statistics.overruns = overruns_.load(std::memory_order_relaxed);
+  statistics.total = std::chrono::nanoseconds(total_ns_.load(std::memory_order_relaxed));
+  statistics.max = std::chrono::nanoseconds(max_ns_.load(std::memory_order_relaxed));
+  for (std::size_t i = 0; i < HISTOGRAM_BUCKETS; ++i)
+  {
+    statistics.histogram[i] = histogram_[i].load(std::memory_order_relaxed);
+  }
+  return statistics;
+}
+}  // namespace kuka_drivers_core
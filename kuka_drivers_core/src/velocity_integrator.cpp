@@ -0,0 +1,86 @@
+// Copyright 2024 Aron Svastits
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "kuka_drivers_core/velocity_integrator.hpp"
+
+namespace kuka_drivers_core
+{
+void VelocityIntegrator::resize(std::size_t joint_count)
+{
+  constexpr double inf = std::numeric_limits<double>::infinity();
+  commands_.assign(joint_count, 0.0);
+  min_positions_.assign(joint_count, -inf);
+  max_positions_.assign(joint_count, inf);
+  max_velocities_.assign(joint_count, inf);
+  active_.assign(joint_count, false);
+  active_count_ = 0;
+}
+
+void VelocityIntegrator::setPositionLimits(
+  std::size_t joint, double min_position, double max_position)
+{
+  min_positions_[joint] = min_position;
+  max_positions_[joint] = max_position;
+}
+
+void VelocityIntegrator::setVelocityLimit(std::size_t joint, double max_velocity)
+{
+  max_velocities_[joint] = std::abs(max_velocity);
+}
+
+void VelocityIntegrator::setActive(std::size_t joint, bool active)
+{
+  if (static_cast<bool>(active_[joint]) != active)
+  {
+    active_[joint] = active;
+    active ? ++active_count_ : --active_count_;
+  }
+  // The last command of a previous controller must not move the joint
+  commands_[joint] = 0.0;
+}
+
+void VelocityIntegrator::integrate(double period, std::vector<double> & positions) const
+{
+  if (active_count_ == 0 || !(period > 0))
+  {
+    return;
+  }
+
+  for (std::size_t i = 0; i < commands_.size(); ++i)
+  {
+    if (!active_[i] || !std::isfinite(commands_[i]))
+    {
+      continue;
+    }
+    const double velocity =
+      std::max(-max_velocities_[i], std::min(commands_[i], max_velocities_[i]));
+    const double position = positions[i] + velocity * period;
+
+    // Stop at the limit in the direction of the motion, without pulling a setpoint outside the
+    //  limits onto them
+    if (velocity > 0)
+    {
+      positions[i] = std::max(positions[i], std::min(position, max_positions_[i]));
+    }
+    else if (velocity < 0)
+    {
+      positions[i] = std::min(positions[i], std::max(position, min_positions_[i]));
+    }
+  }
+}
+}  // namespace kuka_drivers_core
@@ -33,25 +33,25 @@ public:
   }
   void OnSampling() override
   {
-    hw_interface_->set_server_event(kuka_drivers_core::HardwareEvent::CONTROL_STARTED);
+    hw_interface_->setServerEvent(kuka_drivers_core::HardwareEvent::CONTROL_STARTED);
     RCLCPP_INFO(rclcpp::get_logger("KukaEACHardwareInterface"), "External control is active");
   }
   void OnControlModeSwitch(const std::string &) override
   {
-    hw_interface_->set_server_event(kuka_drivers_core::HardwareEvent::CONTROL_MODE_SWITCH);
+    hw_interface_->setServerEvent(kuka_drivers_core::HardwareEvent::CONTROL_MODE_SWITCH);
     RCLCPP_INFO(
       rclcpp::get_logger("KukaEACHardwareInterface"), "Control mode switch is in progress");
-    hw_interface_->reset_cycle_count();
+    hw_interface_->resetCycleCount();
   }
   void OnStopped(const std::string &) override
   {
-    hw_interface_->set_server_event(kuka_drivers_core::HardwareEvent::CONTROL_STOPPED);
+    hw_interface_->setServerEvent(kuka_drivers_core::HardwareEvent::CONTROL_STOPPED);
     RCLCPP_INFO(rclcpp::get_logger("KukaEACHardwareInterface"), "External control finished");
     hw_interface_->set_stop_flag();
   }
   void OnError(const std::string & reason) override
   {
-    hw_interface_->set_server_event(kuka_drivers_core::HardwareEvent::ERROR);
+    hw_interface_->setServerEvent(kuka_drivers_core::HardwareEvent::ERROR);
     RCLCPP_ERROR(
       rclcpp::get_logger("KukaEACHardwareInterface"), "External control stopped by an error");
     RCLCPP_ERROR(rclcpp::get_logger("KukaEACHardwareInterface"), reason.c_str());
@@ -23,7 +23,6 @@
 #include <thread>
 #include <vector>
 
-#include "hardware_interface/system_interface.hpp"
 #include "pluginlib/class_list_macros.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/rclcpp.hpp"
@@ -31,7 +30,7 @@
 #include "kuka/external-control-sdk/iiqka/sdk.h"
 #include "rclcpp_lifecycle/state.hpp"
 
-#include "kuka_drivers_core/hardware_event.hpp"
+#include "kuka_drivers_core/hardware_interface_base.hpp"
 
 #include "kuka_iiqka_eac_driver/visibility_control.h"
 
@@ -40,11 +39,16 @@ using CallbackReturn = rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface
 
 namespace kuka_eac
 {
-class KukaEACHardwareInterface : public hardware_interface::SystemInterface
+class KukaEACHardwareInterface : public kuka_drivers_core::HardwareInterfaceBase
 {
 public:
   RCLCPP_SHARED_PTR_DEFINITIONS(KukaEACHardwareInterface)
 
+  KUKA_IIQKA_EAC_DRIVER_PUBLIC KukaEACHardwareInterface()
+  : kuka_drivers_core::HardwareInterfaceBase("KukaEACHardwareInterface")
+  {
+  }
+
   KUKA_IIQKA_EAC_DRIVER_PUBLIC CallbackReturn
   on_init(const hardware_interface::HardwareInfo & info) override;
 
@@ -69,15 +73,14 @@ public:
   KUKA_IIQKA_EAC_DRIVER_PUBLIC return_type
   write(const rclcpp::Time & time, const rclcpp::Duration & period) override;
 
-  KUKA_IIQKA_EAC_DRIVER_PUBLIC void set_server_event(kuka_drivers_core::HardwareEvent event);
-
   KUKA_IIQKA_EAC_DRIVER_PUBLIC void set_stop_flag() { stop_requested_ = true; }
 
-  KUKA_IIQKA_EAC_DRIVER_PUBLIC void reset_cycle_count() { cycle_count_ = 0; }
-
 private:
   KUKA_IIQKA_EAC_DRIVER_LOCAL bool SetupRobot();
   KUKA_IIQKA_EAC_DRIVER_LOCAL bool SetupQoS();
+  // Control mode of the robot controller, which runs position control for velocity commands
+  KUKA_IIQKA_EAC_DRIVER_LOCAL static kuka::external::control::ControlMode RobotControlMode(
+    double control_mode);
 
   std::unique_ptr<kuka::external::control::iiqka::Robot> robot_ptr_;
 
@@ -89,15 +92,9 @@ private:
   std::vector<double> hw_torque_states_;
 
   double hw_control_mode_command_ = 0;
-  double server_state_ = 0;
-  int cycle_count_ = 0;
-
-  std::mutex event_mutex_;
 
   kuka_drivers_core::ControlMode prev_control_mode_ =
     kuka_drivers_core::ControlMode::CONTROL_MODE_UNSPECIFIED;
-  kuka_drivers_core::HardwareEvent last_event_ =
-    kuka_drivers_core::HardwareEvent::HARDWARE_EVENT_UNSPECIFIED;
 
   bool msg_received_;
   std::atomic<bool> stop_requested_{false};
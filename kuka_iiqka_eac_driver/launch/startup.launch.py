@@ -39,6 +39,7 @@ def launch_setup(context, *args, **kwargs):
     jtc_config = LaunchConfiguration("jtc_config")
     jic_config = LaunchConfiguration("jic_config")
     ec_config = LaunchConfiguration("ec_config")
+    vc_config = LaunchConfiguration("vc_config")
     if ns.perform(context) == "":
         tf_prefix = ""
     else:
@@ -165,6 +166,7 @@ def launch_setup(context, *args, **kwargs):
         "joint_trajectory_controller": jtc_config,
         "joint_group_impedance_controller": jic_config,
         "effort_controller": ec_config,
+        "velocity_controller": vc_config,
         "control_mode_handler": None,
         "event_broadcaster": None,
     }
@@ -231,4 +233,11 @@ def generate_launch_description():
             + "/config/effort_controller_config.yaml",
         )
     )
+    launch_arguments.append(
+        DeclareLaunchArgument(
+            "vc_config",
+            default_value=get_package_share_directory("kuka_iiqka_eac_driver")
+            + "/config/velocity_controller_config.yaml",
+        )
+    )
     return LaunchDescription(launch_arguments + [OpaqueFunction(function=launch_setup)])
@@ -43,69 +43,12 @@ CallbackReturn KukaEACHardwareInterface::on_init(const hardware_interface::Hardw
   hw_stiffness_commands_.resize(info_.joints.size(), 30);
   hw_damping_commands_.resize(info_.joints.size(), 0.7);
 
-  for (const hardware_interface::ComponentInfo & joint : info_.joints)
+  if (!validateJointInterfaces(
+        {hardware_interface::HW_IF_POSITION, hardware_interface::HW_IF_STIFFNESS,
+         hardware_interface::HW_IF_DAMPING, hardware_interface::HW_IF_EFFORT},
+        {hardware_interface::HW_IF_POSITION, hardware_interface::HW_IF_EFFORT}))
   {
-    if (joint.command_interfaces.size() != 4)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaEACHardwareInterface"), "expecting exactly 4 command interface");
-      return CallbackReturn::ERROR;
-    }
-
-    if (joint.command_interfaces[0].name != hardware_interface::HW_IF_POSITION)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaEACHardwareInterface"),
-        "expecting 'POSITION' command interface as first");
-      return CallbackReturn::ERROR;
-    }
-
-    if (joint.command_interfaces[1].name != hardware_interface::HW_IF_STIFFNESS)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaEACHardwareInterface"),
-        "expecting 'STIFFNESS' command interface as second");
-      return CallbackReturn::ERROR;
-    }
-
-    if (joint.command_interfaces[2].name != hardware_interface::HW_IF_DAMPING)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaEACHardwareInterface"),
-        "expecting 'DAMPING' command interface as third");
-      return CallbackReturn::ERROR;
-    }
-
-    if (joint.command_interfaces[3].name != hardware_interface::HW_IF_EFFORT)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaEACHardwareInterface"),
-        "expecting 'EFFORT' command interface as fourth");
-      return CallbackReturn::ERROR;
-    }
-
-    if (joint.state_interfaces.size() != 2)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaEACHardwareInterface"), "expecting exactly 2 state interface");
-      return CallbackReturn::ERROR;
-    }
-
-    if (joint.state_interfaces[0].name != hardware_interface::HW_IF_POSITION)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaEACHardwareInterface"),
-        "expecting 'POSITION' state interface as first");
-      return CallbackReturn::ERROR;
-    }
-
-    if (joint.state_interfaces[1].name != hardware_interface::HW_IF_EFFORT)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaEACHardwareInterface"),
-        "expecting 'EFFORT' state interface as second");
-      return CallbackReturn::ERROR;
-    }
+    return CallbackReturn::ERROR;
   }
 
   RCLCPP_INFO(
@@ -130,8 +73,7 @@ std::vector<hardware_interface::StateInterface> KukaEACHardwareInterface::export
       info_.joints[i].name, hardware_interface::HW_IF_EFFORT, &hw_torque_states_[i]);
   }
 
-  state_interfaces.emplace_back(
-    hardware_interface::STATE_PREFIX, hardware_interface::SERVER_STATE, &server_state_);
+  exportHealthStateInterfaces(state_interfaces);
 
   return state_interfaces;
 }
@@ -156,6 +98,7 @@ KukaEACHardwareInterface::export_command_interfaces()
     command_interfaces.emplace_back(
       info_.joints[i].name, hardware_interface::HW_IF_DAMPING, &hw_damping_commands_[i]);
   }
+  exportVelocityCommandInterfaces(command_interfaces);
 
   command_interfaces.emplace_back(
     hardware_interface::CONFIG_PREFIX, hardware_interface::CONTROL_MODE, &hw_control_mode_command_);
@@ -196,8 +139,8 @@ CallbackReturn KukaEACHardwareInterface::on_activate(const rclcpp_lifecycle::Sta
       "Creating event observer failed, error message: %s", create_event_observer.message);
   }
 
-  kuka::external::control::Status start_control = robot_ptr_->StartControlling(
-    static_cast<kuka::external::control::ControlMode>(hw_control_mode_command_));
+  kuka::external::control::Status start_control =
+    robot_ptr_->StartControlling(RobotControlMode(hw_control_mode_command_));
   if (start_control.return_code == kuka::external::control::ReturnCode::ERROR)
   {
     RCLCPP_ERROR(
@@ -213,7 +156,7 @@ CallbackReturn KukaEACHardwareInterface::on_activate(const rclcpp_lifecycle::Sta
     "External control session started successfully");
 
   stop_requested_ = false;
-  cycle_count_ = 0;
+  startCycles();
   return CallbackReturn::SUCCESS;
 }
 
@@ -243,18 +186,22 @@ return_type KukaEACHardwareInterface::read(const rclcpp::Time &, const rclcpp::D
       req_message.GetMeasuredTorques().begin(), req_message.GetMeasuredTorques().end(),
       hw_torque_states_.begin());
 
-    if (cycle_count_ == 0)
+    if (cycleCount() == 0)
     {
       std::copy(
         hw_position_states_.begin(), hw_position_states_.end(), hw_position_commands_.begin());
     }
 
-    cycle_count_++;
+    stateReceived();
+  }
+  else
+  {
+    // Timeouts are counted only after the first state, which arrives when the control started
+    stateMissed();
   }
 
   // Modify state interface only in read
-  std::lock_guard<std::mutex> lk(event_mutex_);
-  server_state_ = static_cast<double>(last_event_);
+  updateServerState();
   return return_type::OK;
 }
 
@@ -266,6 +213,7 @@ return_type KukaEACHardwareInterface::write(const rclcpp::Time &, const rclcpp::
     return return_type::OK;
   }
 
+  integrateVelocityCommands(hw_position_commands_);
   robot_ptr_->GetControlSignal().AddJointPositionValues(
     hw_position_commands_.begin(), hw_position_commands_.end());
   robot_ptr_->GetControlSignal().AddTorqueValues(
@@ -280,12 +228,13 @@ return_type KukaEACHardwareInterface::write(const rclcpp::Time &, const rclcpp::
     RCLCPP_INFO(rclcpp::get_logger("KukaEACHardwareInterface"), "Sending stop signal");
     send_reply = robot_ptr_->StopControlling();
   }
+  // Switching between position and velocity control does not change the mode of the robot
   else if (
-    static_cast<kuka_drivers_core::ControlMode>(hw_control_mode_command_) != prev_control_mode_)
+    RobotControlMode(hw_control_mode_command_) !=
+    RobotControlMode(static_cast<double>(prev_control_mode_)))
   {
     RCLCPP_INFO(rclcpp::get_logger("KukaEACHardwareInterface"), "Requesting control mode switch");
-    send_reply = robot_ptr_->SwitchControlMode(
-      static_cast<kuka::external::control::ControlMode>(hw_control_mode_command_));
+    send_reply = robot_ptr_->SwitchControlMode(RobotControlMode(hw_control_mode_command_));
     prev_control_mode_ = static_cast<kuka_drivers_core::ControlMode>(hw_control_mode_command_);
   }
   else
@@ -299,9 +248,24 @@ return_type KukaEACHardwareInterface::write(const rclcpp::Time &, const rclcpp::
       send_reply.message);
     throw std::runtime_error("Error sending reply");
   }
+  commandSent();
   return return_type::OK;
 }
 
+kuka::external::control::ControlMode KukaEACHardwareInterface::RobotControlMode(
+  double control_mode)
+{
+  // Joint velocities are integrated into the position commands by the driver
+  if (
+    static_cast<kuka_drivers_core::ControlMode>(control_mode) ==
+    kuka_drivers_core::ControlMode::JOINT_VELOCITY_CONTROL)
+  {
+    return static_cast<kuka::external::control::ControlMode>(
+      kuka_drivers_core::ControlMode::JOINT_POSITION_CONTROL);
+  }
+  return static_cast<kuka::external::control::ControlMode>(control_mode);
+}
+
 bool KukaEACHardwareInterface::SetupRobot()
 {
   kuka::external::control::iiqka::Configuration config;
@@ -348,12 +312,6 @@ bool KukaEACHardwareInterface::SetupQoS()
 
   return true;
 }
-
-void KukaEACHardwareInterface::set_server_event(kuka_drivers_core::HardwareEvent event)
-{
-  std::lock_guard<std::mutex> lk(event_mutex_);
-  last_event_ = event;
-}
 }  // namespace kuka_eac
 
 PLUGINLIB_EXPORT_CLASS(kuka_eac::KukaEACHardwareInterface, hardware_interface::SystemInterface)
@@ -28,6 +28,17 @@ using namespace lifecycle_msgs::msg;           // NOLINT
 
 namespace kuka_eac
 {
+namespace
+{
+// The hardware interface integrates joint velocities into position commands
+kuka_drivers_core::ControlMode RobotControlMode(kuka_drivers_core::ControlMode control_mode)
+{
+  return control_mode == kuka_drivers_core::ControlMode::JOINT_VELOCITY_CONTROL
+           ? kuka_drivers_core::ControlMode::JOINT_POSITION_CONTROL
+           : control_mode;
+}
+}  // namespace
+
 RobotManagerNode::RobotManagerNode() : kuka_drivers_core::ROS2BaseLCNode("robot_manager")
 {
   auto qos = rclcpp::QoS(rclcpp::KeepLast(10));
@@ -73,6 +84,14 @@ RobotManagerNode::RobotManagerNode() : kuka_drivers_core::ROS2BaseLCNode("robot_
       return this->controller_handler_.UpdateControllerName(
         kuka_drivers_core::ControllerType::JOINT_IMPEDANCE_CONTROLLER_TYPE, controller_name);
     });
+  this->registerParameter<std::string>(
+    "velocity_controller_name", "velocity_controller",
+    kuka_drivers_core::ParameterSetAccessRights{true, false},
+    [this](const std::string & controller_name)
+    {
+      return this->controller_handler_.UpdateControllerName(
+        kuka_drivers_core::ControllerType::JOINT_VELOCITY_CONTROLLER_TYPE, controller_name);
+    });
   this->registerParameter<std::string>(
     "torque_controller_name", "effort_controller",
     kuka_drivers_core::ParameterSetAccessRights{true, false},
@@ -270,6 +289,7 @@ bool RobotManagerNode::onControlModeChangeRequest(int control_mode)
   if (
     control_mode != static_cast<int>(kuka_drivers_core::ControlMode::JOINT_POSITION_CONTROL) &&
     control_mode != static_cast<int>(kuka_drivers_core::ControlMode::JOINT_IMPEDANCE_CONTROL) &&
+    control_mode != static_cast<int>(kuka_drivers_core::ControlMode::JOINT_VELOCITY_CONTROL) &&
     control_mode != static_cast<int>(kuka_drivers_core::ControlMode::JOINT_TORQUE_CONTROL))
   {
     RCLCPP_ERROR(get_logger(), "Tried to change to a not implemented control mode");
@@ -294,20 +314,26 @@ bool RobotManagerNode::onControlModeChangeRequest(int control_mode)
       return false;
     }
 
-    // Wait for event of successful restart
-    std::unique_lock<std::mutex> control_mode_lk(this->control_mode_cv_m_);
-
-    if (!this->control_mode_cv_.wait_for(
-          control_mode_lk, std::chrono::milliseconds(3000),
-          [this]() { return this->control_mode_change_finished_; }))
+    // Wait for event of successful restart, if the robot controller changes its control mode
+    if (
+      RobotControlMode(control_mode_) !=
+      RobotControlMode(static_cast<kuka_drivers_core::ControlMode>(control_mode)))
     {
-      RCLCPP_ERROR(get_logger(), "Timeout reached while waiting for robot to change control mode.");
-      this->on_deactivate(get_current_state());
-      return false;
+      std::unique_lock<std::mutex> control_mode_lk(this->control_mode_cv_m_);
+
+      if (!this->control_mode_cv_.wait_for(
+            control_mode_lk, std::chrono::milliseconds(3000),
+            [this]() { return this->control_mode_change_finished_; }))
+      {
+        RCLCPP_ERROR(
+          get_logger(), "Timeout reached while waiting for robot to change control mode.");
+        this->on_deactivate(get_current_state());
+        return false;
+      }
+      control_mode_change_finished_ = false;
+      control_mode_lk.unlock();
+      RCLCPP_INFO(get_logger(), "Robot Controller finished control mode change");
     }
-    control_mode_change_finished_ = false;
-    control_mode_lk.unlock();
-    RCLCPP_INFO(get_logger(), "Robot Controller finished control mode change");
 
     // Workaround until controller_manager/jtc bug is fixed:
     std::this_thread::sleep_for(std::chrono::milliseconds(30));
@@ -27,7 +27,7 @@
 #include "rclcpp/rclcpp.hpp"
 #include "rclcpp_lifecycle/state.hpp"
 
-#include "hardware_interface/system_interface.hpp"
+#include "kuka_drivers_core/hardware_interface_base.hpp"
 
 #include "kuka_kss_rsi_driver/rsi_command.hpp"
 #include "kuka_kss_rsi_driver/rsi_state.hpp"
@@ -40,11 +40,16 @@ using CallbackReturn = rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface
 namespace kuka_kss_rsi_driver
 {
 
-class KukaRSIHardwareInterface : public hardware_interface::SystemInterface
+class KukaRSIHardwareInterface : public kuka_drivers_core::HardwareInterfaceBase
 {
 public:
   RCLCPP_SHARED_PTR_DEFINITIONS(KukaRSIHardwareInterface)
 
+  KUKA_KSS_RSI_DRIVER_PUBLIC KukaRSIHardwareInterface()
+  : kuka_drivers_core::HardwareInterfaceBase("KukaRSIHardwareInterface")
+  {
+  }
+
   KUKA_KSS_RSI_DRIVER_PUBLIC
   CallbackReturn on_init(const hardware_interface::HardwareInfo & info) override;
 
@@ -80,12 +85,16 @@ private:
   std::vector<double> joint_pos_correction_deg_;
 
   uint64_t ipoc_ = 0;
+  // Smallest IPOC difference between consecutive states, the period of RSI
+  uint64_t ipoc_period_ = 0;
   RSIState rsi_state_;
   RSICommand rsi_command_;
   std::unique_ptr<UDPServer> server_;
   std::string in_buffer_;
   std::string out_buffer_;
 
+  // Maximum time between two states before the connection is considered lost
+  static constexpr std::chrono::seconds RECEIVE_TIMEOUT{1};
   static constexpr double R2D = 180 / M_PI;
   static constexpr double D2R = M_PI / 180;
 };
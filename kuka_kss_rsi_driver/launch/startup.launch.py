@@ -39,6 +39,7 @@ def launch_setup(context, *args, **kwargs):
     ns = LaunchConfiguration("namespace")
     controller_config = LaunchConfiguration("controller_config")
     jtc_config = LaunchConfiguration("jtc_config")
+    vc_config = LaunchConfiguration("vc_config")
     if ns.perform(context) == "":
         tf_prefix = ""
     else:
@@ -148,6 +149,7 @@ def launch_setup(context, *args, **kwargs):
     controllers = {
         "joint_state_broadcaster": None,
         "joint_trajectory_controller": jtc_config,
+        "velocity_controller": vc_config,
     }
 
     controller_spawners = [
@@ -192,4 +194,11 @@ def generate_launch_description():
             + "/config/joint_trajectory_controller_config.yaml",
         )
     )
+    launch_arguments.append(
+        DeclareLaunchArgument(
+            "vc_config",
+            default_value=get_package_share_directory("kuka_kss_rsi_driver")
+            + "/config/velocity_controller_config.yaml",
+        )
+    )
     return LaunchDescription(launch_arguments + [OpaqueFunction(function=launch_setup)])
@@ -12,12 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <memory>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
 #include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "kuka_drivers_core/hardware_interface_types.hpp"
 
 #include "kuka_kss_rsi_driver/hardware_interface.hpp"
 
@@ -33,36 +35,10 @@ CallbackReturn KukaRSIHardwareInterface::on_init(const hardware_interface::Hardw
   hw_states_.resize(info_.joints.size(), 0.0);
   hw_commands_.resize(info_.joints.size(), 0.0);
 
-  for (const hardware_interface::ComponentInfo & joint : info_.joints)
+  if (!validateJointInterfaces(
+        {hardware_interface::HW_IF_POSITION}, {hardware_interface::HW_IF_POSITION}))
   {
-    if (joint.command_interfaces.size() != 1)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaRSIHardwareInterface"), "expecting exactly 1 command interface");
-      return CallbackReturn::ERROR;
-    }
-
-    if (joint.command_interfaces[0].name != hardware_interface::HW_IF_POSITION)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaRSIHardwareInterface"),
-        "expecting only POSITION command interface");
-      return CallbackReturn::ERROR;
-    }
-
-    if (joint.state_interfaces.size() != 1)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaRSIHardwareInterface"), "expecting exactly 1 state interface");
-      return CallbackReturn::ERROR;
-    }
-
-    if (joint.state_interfaces[0].name != hardware_interface::HW_IF_POSITION)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaRSIHardwareInterface"), "expecting only POSITION state interface");
-      return CallbackReturn::ERROR;
-    }
+    return CallbackReturn::ERROR;
   }
 
   // RSI
@@ -91,6 +67,9 @@ std::vector<hardware_interface::StateInterface> KukaRSIHardwareInterface::export
     state_interfaces.emplace_back(
       info_.joints[i].name, hardware_interface::HW_IF_POSITION, &hw_states_[i]);
   }
+  exportTimestampStateInterfaces(state_interfaces);
+  // RSI does not report server state events
+  exportHealthStateInterfaces(state_interfaces, false);
   return state_interfaces;
 }
 
@@ -103,6 +82,8 @@ KukaRSIHardwareInterface::export_command_interfaces()
     command_interfaces.emplace_back(
       info_.joints[i].name, hardware_interface::HW_IF_POSITION, &hw_commands_[i]);
   }
+  // RSI accepts only position corrections, velocities are integrated in the cycles of RSI
+  exportVelocityCommandInterfaces(command_interfaces);
   return command_interfaces;
 }
 
@@ -139,10 +120,14 @@ CallbackReturn KukaRSIHardwareInterface::on_activate(const rclcpp_lifecycle::Sta
     initial_joint_pos_[i] = rsi_state_.initial_positions[i] * KukaRSIHardwareInterface::D2R;
   }
   ipoc_ = rsi_state_.ipoc;
+  ipoc_period_ = 0;
+  startCycles(RECEIVE_TIMEOUT);
+  stateReceived();
+  setControllerTime(static_cast<double>(ipoc_) * 1e-3);
 
   out_buffer_ = RSICommand(joint_pos_correction_deg_, ipoc_, stop_flag_).xml_doc;
   server_->send(out_buffer_);
-  server_->set_timeout(1000);  // Set receive timeout to 1 second
+  commandSent();
 
   RCLCPP_INFO(rclcpp::get_logger("KukaRSIHardwareInterface"), "System Successfully started!");
   is_active_ = true;
@@ -165,6 +150,10 @@ return_type KukaRSIHardwareInterface::read(const rclcpp::Time &, const rclcpp::D
     return return_type::OK;
   }
 
+  // Wait at most until the deadline measured from the previous state, rounded up to milliseconds
+  const auto timeout =
+    std::chrono::duration_cast<std::chrono::milliseconds>(receiveTimeout(RECEIVE_TIMEOUT));
+  server_->set_timeout(static_cast<int>(timeout.count()) + 1);
   if (server_->recv(in_buffer_) == 0)
   {
     RCLCPP_ERROR(rclcpp::get_logger("KukaRSIHardwareInterface"), "No data received from robot");
@@ -177,7 +166,19 @@ return_type KukaRSIHardwareInterface::read(const rclcpp::Time &, const rclcpp::D
   {
     hw_states_[i] = rsi_state_.positions[i] * KukaRSIHardwareInterface::D2R;
   }
+
+  // The robot controller sends a state in every RSI cycle, a larger IPOC step means lost states
+  uint64_t missed = 0;
+  if (rsi_state_.ipoc > ipoc_)
+  {
+    const uint64_t step = rsi_state_.ipoc - ipoc_;
+    ipoc_period_ = ipoc_period_ == 0 ? step : std::min(ipoc_period_, step);
+    missed = (step + ipoc_period_ / 2) / ipoc_period_ - 1;
+  }
+  stateReceived(missed);
   ipoc_ = rsi_state_.ipoc;
+  // The IPOC is the time of the robot controller in milliseconds
+  setControllerTime(static_cast<double>(ipoc_) * 1e-3);
   return return_type::OK;
 }
 
@@ -197,6 +198,8 @@ return_type KukaRSIHardwareInterface::write(const rclcpp::Time &, const rclcpp::
     is_active_ = false;
   }
 
+  // The period is the IPOC step, which includes the lost states
+  integrateVelocityCommands(hw_commands_);
   for (size_t i = 0; i < info_.joints.size(); i++)
   {
     joint_pos_correction_deg_[i] =
@@ -205,6 +208,7 @@ return_type KukaRSIHardwareInterface::write(const rclcpp::Time &, const rclcpp::
 
   out_buffer_ = RSICommand(joint_pos_correction_deg_, ipoc_, stop_flag_).xml_doc;
   server_->send(out_buffer_);
+  commandSent();
   return return_type::OK;
 }
 }  // namespace kuka_kss_rsi_driver
@@ -119,10 +119,10 @@ class RSISimulator(Node):
             msg = create_rsi_xml_rob(
                 self.act_joint_pos, self.initial_joint_pos, self.timeout_count, self.ipoc
             )
-            self.rsi_act_pub_.publish(msg)
+            self.rsi_act_pub_.publish(String(data=msg.decode()))
             self.socket_.sendto(msg, (self.rsi_ip_address_, self.rsi_port_address_))
             recv_msg, addr = self.socket_.recvfrom(1024)
-            self.rsi_cmd_pub_.publish(recv_msg)
+            self.rsi_cmd_pub_.publish(String(data=recv_msg.decode()))
             self.get_logger().warn(f"msg: {recv_msg}")
             des_joint_correction_absolute, ipoc_recv, stop_flag = parse_rsi_xml_sen(recv_msg)
             if ipoc_recv == self.ipoc:
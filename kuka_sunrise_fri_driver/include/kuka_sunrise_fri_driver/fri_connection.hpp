@@ -60,7 +60,8 @@ enum CommandSuccess : std::uint8_t
 enum ControlModeID : std::uint8_t
 {
   POSITION_CONTROL_MODE = 1,
-  JOINT_IMPEDANCE_CONTROL_MODE = 2
+  JOINT_IMPEDANCE_CONTROL_MODE = 2,
+  CARTESIAN_IMPEDANCE_CONTROL_MODE = 3
 };
 
 enum ClientCommandModeID : std::uint8_t
@@ -70,6 +71,8 @@ enum ClientCommandModeID : std::uint8_t
 };
 
 static const std::vector<std::uint8_t> FRI_CONFIG_HEADER = {0xAC, 0xED, 0x00, 0x05, 0x77, 0x10};
+// Java serialization header of a data block of 112 bytes (14 doubles), both the joint and the
+//  Cartesian impedance control mode parameters have this size
 static const std::vector<std::uint8_t> CONTROL_MODE_HEADER = {0xAC, 0xED, 0x00, 0x05, 0x77, 0x70};
 
 class FRIConnection
@@ -88,6 +91,10 @@ public:
   bool setPositionControlMode();
   bool setJointImpedanceControlMode(
     const std::vector<double> & joint_stiffness, const std::vector<double> & joint_damping);
+  // The stiffness and damping vectors contain the values of the X, Y, Z, A, B, C axes and the null
+  //  space, in the units of CartesianImpedanceControlMode
+  bool setCartesianImpedanceControlMode(
+    const std::vector<double> & cartesian_stiffness, const std::vector<double> & cartesian_damping);
   bool setClientCommandMode(ClientCommandModeID client_command_mode);
   // bool getControlMode();
   bool setFRIConfig(
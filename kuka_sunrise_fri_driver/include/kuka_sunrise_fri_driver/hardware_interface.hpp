@@ -24,9 +24,8 @@
 #include "pluginlib/class_list_macros.hpp"
 #include "rclcpp/rclcpp.hpp"
 
-#include "hardware_interface/system_interface.hpp"
 #include "kuka_drivers_core/control_mode.hpp"
-#include "kuka_drivers_core/hardware_event.hpp"
+#include "kuka_drivers_core/hardware_interface_base.hpp"
 
 #include "fri_client_sdk/HWIFClientApplication.hpp"
 #include "fri_client_sdk/friClientIf.h"
@@ -50,7 +49,7 @@ enum class IOTypes
 static std::unordered_map<std::string, IOTypes> const types = {
   {"analog", IOTypes::ANALOG}, {"digital", IOTypes::DIGITAL}, {"boolean", IOTypes::BOOLEAN}};
 
-class KukaFRIHardwareInterface : public hardware_interface::SystemInterface,
+class KukaFRIHardwareInterface : public kuka_drivers_core::HardwareInterfaceBase,
                                  public KUKA::FRI::LBRClient
 {
 public:
@@ -58,7 +57,8 @@ public:
 
   // Set UDP timeout to 10 ms to enable checking return value of client_app_read()
   KUKA_SUNRISE_FRI_DRIVER_PUBLIC KukaFRIHardwareInterface()
-  : client_application_(udp_connection_, *this)
+  : kuka_drivers_core::HardwareInterfaceBase("KukaFRIHardwareInterface"),
+    client_application_(udp_connection_, *this)
   {
   }
   KUKA_SUNRISE_FRI_DRIVER_PUBLIC CallbackReturn
@@ -126,18 +126,14 @@ private:
   std::vector<double> hw_torque_commands_;
   std::vector<double> hw_stiffness_commands_;
   std::vector<double> hw_damping_commands_;
+  // Cartesian impedance of the X, Y, Z, A, B, C axes and the null space
+  std::vector<double> hw_cart_stiffness_commands_;
+  std::vector<double> hw_cart_damping_commands_;
 
   std::vector<double> hw_position_states_;
   std::vector<double> hw_torque_states_;
   std::vector<double> hw_ext_torque_states_;
 
-  double server_state_ = 0;
-
-  std::mutex event_mutex_;
-
-  kuka_drivers_core::HardwareEvent last_event_ =
-    kuka_drivers_core::HardwareEvent::HARDWARE_EVENT_UNSPECIFIED;
-
   static const int TCP_SERVER_PORT = 30000;
   static const int DOF = 7;
 
@@ -168,6 +168,7 @@ def launch_setup(context, *args, **kwargs):
         "fri_configuration_controller": None,
         "fri_state_broadcaster": None,
         "joint_group_impedance_controller": jic_config,
+        "cartesian_impedance_controller": None,
         "effort_controller": ec_config,
         "control_mode_handler": None,
         "event_broadcaster": None,
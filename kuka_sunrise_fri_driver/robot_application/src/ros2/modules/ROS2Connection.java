@@ -4,12 +4,14 @@ import java.io.Externalizable;
 import java.util.Arrays;
 
 import ros2.modules.FRIManager;
+import ros2.serialization.CartesianImpedanceControlModeExternalizable;
 import ros2.serialization.ControlModeParams;
 import ros2.serialization.FRIConfigurationParams;
 import ros2.serialization.JointImpedanceControlModeExternalizable;
 import ros2.serialization.MessageEncoding;
 
 import com.kuka.connectivity.fastRobotInterface.ClientCommandMode;
+import com.kuka.roboticsAPI.motionModel.controlModeModel.CartesianImpedanceControlMode;
 import com.kuka.roboticsAPI.motionModel.controlModeModel.IMotionControlMode;
 import com.kuka.roboticsAPI.motionModel.controlModeModel.JointImpedanceControlMode;
 import com.kuka.roboticsAPI.motionModel.controlModeModel.PositionControlMode;
@@ -95,7 +97,8 @@ public class ROS2Connection {
 
 	private enum ControlModeID{
 		POSITION(		(byte)1),
-		JOINT_IMPEDANCE((byte)2);
+		JOINT_IMPEDANCE((byte)2),
+		CARTESIAN_IMPEDANCE((byte)3);
 
 		public final byte value;
 
@@ -323,6 +326,9 @@ public class ROS2Connection {
 		} else if (controlMode instanceof JointImpedanceControlMode){
 			controlModeID = ControlModeID.JOINT_IMPEDANCE;
 			controlModeData = MessageEncoding.Encode(new JointImpedanceControlModeExternalizable((JointImpedanceControlMode)controlMode), JointImpedanceControlModeExternalizable.length);
+		} else if (controlMode instanceof CartesianImpedanceControlMode){
+			controlModeID = ControlModeID.CARTESIAN_IMPEDANCE;
+			controlModeData = MessageEncoding.Encode(new CartesianImpedanceControlModeExternalizable((CartesianImpedanceControlMode)controlMode), CartesianImpedanceControlModeExternalizable.length);
 		} else {
 			throw new RuntimeException("Control mode not supported");
 		}
@@ -348,6 +354,12 @@ public class ROS2Connection {
 				MessageEncoding.Decode(controlModeData, externalizable);
 				controlMode = externalizable.toControlMode();
 				break;
+			case CARTESIAN_IMPEDANCE:
+				ensureArrayLength(controlModeData, CartesianImpedanceControlModeExternalizable.length + 6);
+				CartesianImpedanceControlModeExternalizable cartesianExternalizable = new CartesianImpedanceControlModeExternalizable();
+				MessageEncoding.Decode(controlModeData, cartesianExternalizable);
+				controlMode = cartesianExternalizable.toControlMode();
+				break;
 		}
 		System.out.println("Control mode decoded.");
 		FRIManager.CommandResult commandResult = _FRIManager.setControlMode(controlMode);
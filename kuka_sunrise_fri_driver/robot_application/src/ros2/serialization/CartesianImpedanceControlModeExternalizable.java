@@ -0,0 +1,58 @@
+package ros2.serialization;
+
+import java.io.Externalizable;
+import java.io.IOException;
+import java.io.ObjectInput;
+import java.io.ObjectOutput;
+
+import com.kuka.roboticsAPI.geometricModel.CartDOF;
+import com.kuka.roboticsAPI.motionModel.controlModeModel.CartesianImpedanceControlMode;
+import com.kuka.roboticsAPI.motionModel.controlModeModel.IMotionControlMode;
+
+public class CartesianImpedanceControlModeExternalizable extends CartesianImpedanceControlMode implements Externalizable{
+
+	// Stiffness and damping of the X, Y, Z, A, B, C axes and the null space (14 doubles)
+	public final static int length = 112;
+
+	private final static CartDOF[] axes = {CartDOF.X, CartDOF.Y, CartDOF.Z, CartDOF.A, CartDOF.B, CartDOF.C};
+
+	public CartesianImpedanceControlModeExternalizable(){
+		super();
+	}
+
+	public CartesianImpedanceControlModeExternalizable(CartesianImpedanceControlMode other){
+		super(other);
+	}
+
+	public IMotionControlMode toControlMode(){
+		CartesianImpedanceControlMode controlMode = new CartesianImpedanceControlMode((CartesianImpedanceControlMode)this);
+		return (IMotionControlMode)controlMode;
+	}
+
+	@Override
+	public void writeExternal(ObjectOutput out) throws IOException {
+		for(double cartesianStiffness : getStiffness()){
+			out.writeDouble(cartesianStiffness);
+		}
+		out.writeDouble(getNullSpaceStiffness());
+		for(double cartesianDamping : getDamping()){
+			out.writeDouble(cartesianDamping);
+		}
+		out.writeDouble(getNullSpaceDamping());
+	}
+
+	@Override
+	public void readExternal(ObjectInput in) throws IOException,
+			ClassNotFoundException {
+		for(CartDOF axis : axes){
+			parametrize(axis).setStiffness(in.readDouble());
+		}
+		setNullSpaceStiffness(in.readDouble());
+
+		for(CartDOF axis : axes){
+			parametrize(axis).setDamping(in.readDouble());
+		}
+		setNullSpaceDamping(in.readDouble());
+	}
+
+}
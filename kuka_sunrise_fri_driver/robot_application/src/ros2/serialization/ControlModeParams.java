@@ -7,6 +7,7 @@ import java.io.ObjectOutput;
 import java.util.Arrays;
 
 
+import com.kuka.roboticsAPI.motionModel.controlModeModel.CartesianImpedanceControlMode;
 import com.kuka.roboticsAPI.motionModel.controlModeModel.IMotionControlMode;
 import com.kuka.roboticsAPI.motionModel.controlModeModel.JointImpedanceControlMode;
 import com.kuka.roboticsAPI.motionModel.controlModeModel.PositionControlMode;
@@ -16,7 +17,8 @@ public abstract class ControlModeParams implements Externalizable{
 
 	private enum ControlModeID{
 		POSITION(		(byte)1),
-		JOINT_IMPEDANCE((byte)2);
+		JOINT_IMPEDANCE((byte)2),
+		CARTESIAN_IMPEDANCE((byte)3);
 
 		public final byte value;
 
@@ -47,6 +49,9 @@ public abstract class ControlModeParams implements Externalizable{
 			case JOINT_IMPEDANCE:
 				controlModeParams = new JointImpedanceControlModeParams();
 				break;
+			case CARTESIAN_IMPEDANCE:
+				controlModeParams = new CartesianImpedanceControlModeParams();
+				break;
 		}
 		serialData = Arrays.copyOfRange(serialData, 1, serialData.length);
 		MessageEncoding.Decode(serialData, controlModeParams);
@@ -62,6 +67,8 @@ public abstract class ControlModeParams implements Externalizable{
 			controlModeParams = new PositionControlModeParams();
 		} else if (controlMode instanceof JointImpedanceControlMode){
 			controlModeParams = new JointImpedanceControlModeParams((JointImpedanceControlMode) controlMode);
+		} else if (controlMode instanceof CartesianImpedanceControlMode){
+			controlModeParams = new CartesianImpedanceControlModeParams((CartesianImpedanceControlMode) controlMode);
 		} else {
 			throw new RuntimeException("Control mode not supported");
 		}
@@ -95,3 +102,12 @@ class JointImpedanceControlModeParams extends ControlModeParams{
 
 	}
 }
+
+class CartesianImpedanceControlModeParams extends ControlModeParams{
+	public CartesianImpedanceControlModeParams(){
+
+	}
+	public CartesianImpedanceControlModeParams(CartesianImpedanceControlMode controlMode){
+
+	}
+}
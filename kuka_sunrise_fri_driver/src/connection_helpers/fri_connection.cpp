@@ -118,6 +118,28 @@ bool FRIConnection::setJointImpedanceControlMode(
   return sendCommandAndWait(SET_CONTROL_MODE, serialized);
 }
 
+bool FRIConnection::setCartesianImpedanceControlMode(
+  const std::vector<double> & cartesian_stiffness, const std::vector<double> & cartesian_damping)
+{
+  // All parameters are sent in one message, as the control mode can be set only as a whole
+  std::vector<std::uint8_t> serialized;
+  serialized.reserve(1 + CONTROL_MODE_HEADER.size() + 2 * 7 * sizeof(double));
+  serialized.emplace_back(CARTESIAN_IMPEDANCE_CONTROL_MODE);
+  for (std::uint8_t byte : CONTROL_MODE_HEADER)
+  {
+    serialized.emplace_back(byte);
+  }
+  for (double cs : cartesian_stiffness)
+  {
+    serializeNext(cs, serialized);
+  }
+  for (double cd : cartesian_damping)
+  {
+    serializeNext(cd, serialized);
+  }
+  return sendCommandAndWait(SET_CONTROL_MODE, serialized);
+}
+
 bool FRIConnection::setClientCommandMode(ClientCommandModeID client_command_mode)
 {
   std::vector<std::uint8_t> command_data = {client_command_mode};
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <memory>
+#include <string>
 
 #include <hardware_interface/types/hardware_interface_type_values.hpp>
 #include "kuka_drivers_core/hardware_interface_types.hpp"
@@ -39,6 +40,9 @@ CallbackReturn KukaFRIHardwareInterface::on_init(
   hw_position_commands_.resize(info_.joints.size());
   hw_stiffness_commands_.resize(info_.joints.size());
   hw_damping_commands_.resize(info_.joints.size());
+  // Defaults of the robot manager, valid even if the impedance is not set before activation
+  hw_cart_stiffness_commands_ = {2000.0, 2000.0, 2000.0, 200.0, 200.0, 200.0, 100.0};
+  hw_cart_damping_commands_.assign(hardware_interface::CARTESIAN_IMPEDANCE_AXES.size(), 0.7);
   hw_torque_states_.resize(info_.joints.size());
   hw_ext_torque_states_.resize(info_.joints.size());
   hw_torque_commands_.resize(info_.joints.size());
@@ -69,74 +73,13 @@ CallbackReturn KukaFRIHardwareInterface::on_init(
       std::stod(command_if.initial_value));
   }
 
-  for (const hardware_interface::ComponentInfo & joint : info_.joints)
+  if (!validateJointInterfaces(
+        {hardware_interface::HW_IF_POSITION, hardware_interface::HW_IF_STIFFNESS,
+         hardware_interface::HW_IF_DAMPING, hardware_interface::HW_IF_EFFORT},
+        {hardware_interface::HW_IF_POSITION, hardware_interface::HW_IF_EFFORT,
+         hardware_interface::HW_IF_EXTERNAL_TORQUE}))
   {
-    if (joint.command_interfaces.size() != 4)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaFRIHardwareInterface"), "expecting exactly 4 command interface");
-      return CallbackReturn::ERROR;
-    }
-
-    if (joint.command_interfaces[0].name != hardware_interface::HW_IF_POSITION)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaFRIHardwareInterface"),
-        "expecting 'POSITION' command interface as first");
-      return CallbackReturn::ERROR;
-    }
-    if (joint.command_interfaces[1].name != hardware_interface::HW_IF_STIFFNESS)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaFRIHardwareInterface"),
-        "expecting 'STIFFNESS' command interface as second");
-      return CallbackReturn::ERROR;
-    }
-    if (joint.command_interfaces[2].name != hardware_interface::HW_IF_DAMPING)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaFRIHardwareInterface"),
-        "expecting 'DAMPING' command interface as third");
-      return CallbackReturn::ERROR;
-    }
-    if (joint.command_interfaces[3].name != hardware_interface::HW_IF_EFFORT)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaFRIHardwareInterface"),
-        "expecting 'EFFORT' command interface as fourth");
-      return CallbackReturn::ERROR;
-    }
-
-    if (joint.state_interfaces.size() != 3)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaFRIHardwareInterface"), "expecting exactly 3 state interface");
-      return CallbackReturn::ERROR;
-    }
-
-    if (joint.state_interfaces[0].name != hardware_interface::HW_IF_POSITION)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaFRIHardwareInterface"),
-        "expecting 'POSITION' state interface as first");
-      return CallbackReturn::ERROR;
-    }
-
-    if (joint.state_interfaces[1].name != hardware_interface::HW_IF_EFFORT)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaFRIHardwareInterface"),
-        "expecting 'EFFORT' state interface as second");
-      return CallbackReturn::ERROR;
-    }
-
-    if (joint.state_interfaces[2].name != hardware_interface::HW_IF_EXTERNAL_TORQUE)
-    {
-      RCLCPP_FATAL(
-        rclcpp::get_logger("KukaFRIHardwareInterface"),
-        "expecting 'EXTERNAL_TORQUE' state interface as third");
-      return CallbackReturn::ERROR;
-    }
+    return CallbackReturn::ERROR;
   }
 
   RCLCPP_INFO(
@@ -188,26 +131,46 @@ CallbackReturn KukaFRIHardwareInterface::on_activate(const rclcpp_lifecycle::Sta
 {
   // Set control mode before starting motion - not even the impedance attributes can be changed in
   // active state
+  bool control_mode_set = false;
   switch (static_cast<kuka_drivers_core::ControlMode>(control_mode_))
   {
     case kuka_drivers_core::ControlMode::JOINT_POSITION_CONTROL:
-      fri_connection_->setPositionControlMode();
-      fri_connection_->setClientCommandMode(ClientCommandModeID::POSITION_COMMAND_MODE);
+      control_mode_set =
+        fri_connection_->setPositionControlMode() &&
+        fri_connection_->setClientCommandMode(ClientCommandModeID::POSITION_COMMAND_MODE);
       break;
     case kuka_drivers_core::ControlMode::JOINT_IMPEDANCE_CONTROL:
-      fri_connection_->setJointImpedanceControlMode(hw_stiffness_commands_, hw_damping_commands_);
-      fri_connection_->setClientCommandMode(ClientCommandModeID::POSITION_COMMAND_MODE);
+      control_mode_set =
+        fri_connection_->setJointImpedanceControlMode(
+          hw_stiffness_commands_, hw_damping_commands_) &&
+        fri_connection_->setClientCommandMode(ClientCommandModeID::POSITION_COMMAND_MODE);
+      break;
+    case kuka_drivers_core::ControlMode::CARTESIAN_IMPEDANCE_CONTROL:
+      control_mode_set =
+        fri_connection_->setCartesianImpedanceControlMode(
+          hw_cart_stiffness_commands_, hw_cart_damping_commands_) &&
+        fri_connection_->setClientCommandMode(ClientCommandModeID::POSITION_COMMAND_MODE);
       break;
     case kuka_drivers_core::ControlMode::JOINT_TORQUE_CONTROL:
-      fri_connection_->setJointImpedanceControlMode(
-        std::vector<double>(DOF, 0.0), std::vector<double>(DOF, 0.0));
-      fri_connection_->setClientCommandMode(ClientCommandModeID::TORQUE_COMMAND_MODE);
+      control_mode_set =
+        fri_connection_->setJointImpedanceControlMode(
+          std::vector<double>(DOF, 0.0), std::vector<double>(DOF, 0.0)) &&
+        fri_connection_->setClientCommandMode(ClientCommandModeID::TORQUE_COMMAND_MODE);
       break;
 
     default:
       RCLCPP_ERROR(rclcpp::get_logger("KukaFRIHardwareInterface"), "Unsupported control mode");
       return CallbackReturn::ERROR;
   }
+  if (!control_mode_set)
+  {
+    RCLCPP_ERROR(
+      rclcpp::get_logger("KukaFRIHardwareInterface"),
+      "Could not set control mode, check the impedance attributes");
+    return CallbackReturn::ERROR;
+  }
+
+  startCycles();
 
   // Start FRI (in monitoring mode)
   if (!fri_connection_->startFRI())
@@ -287,15 +250,24 @@ hardware_interface::return_type KukaFRIHardwareInterface::read(
     robot_state_.drive_state_ = robotState().getDriveState();
     robot_state_.overlay_type_ = robotState().getOverlayType();
 
+    // The native connection quality is used instead of the ratio of received states
+    stateReceived();
+    setControllerTime(robotState().getTimestampSec() + robotState().getTimestampNanoSec() * 1e-9);
+    health_.setConnectionQuality(
+      robot_state_.connection_quality_ / KUKA::FRI::EConnectionQuality::EXCELLENT);
+
     for (auto & output : gpio_outputs_)
     {
       output.getValue();
     }
   }
+  else
+  {
+    stateMissed();
+  }
 
   // Modify state interface only in read
-  std::lock_guard<std::mutex> lk(event_mutex_);
-  server_state_ = static_cast<double>(last_event_);
+  updateServerState();
   return hardware_interface::return_type::OK;
 }
 
@@ -333,6 +305,7 @@ hardware_interface::return_type KukaFRIHardwareInterface::write(
       rclcpp::get_logger("KukaFRIHardwareInterface"), "Could not send command to controller");
     return hardware_interface::return_type::ERROR;
   }
+  commandSent();
 
   return hardware_interface::return_type::OK;
 }
@@ -344,6 +317,9 @@ void KukaFRIHardwareInterface::updateCommand(const rclcpp::Time &)
     case kuka_drivers_core::ControlMode::JOINT_POSITION_CONTROL:
       [[fallthrough]];
     case kuka_drivers_core::ControlMode::JOINT_IMPEDANCE_CONTROL:
+      [[fallthrough]];
+    // The robot controller realizes the Cartesian impedance around the commanded joint positions
+    case kuka_drivers_core::ControlMode::CARTESIAN_IMPEDANCE_CONTROL:
     {
       const double * joint_positions_ = hw_position_commands_.data();
       robotCommand().setJointPosition(joint_positions_);
@@ -404,6 +380,7 @@ std::vector<hardware_interface::StateInterface> KukaFRIHardwareInterface::export
   state_interfaces.emplace_back(
     hardware_interface::FRI_STATE_PREFIX, hardware_interface::TRACKING_PERFORMANCE,
     &robot_state_.tracking_performance_);
+  exportTimestampStateInterfaces(state_interfaces);
 
   // Register I/O outputs (read access)
   for (auto & output : gpio_outputs_)
@@ -424,8 +401,7 @@ std::vector<hardware_interface::StateInterface> KukaFRIHardwareInterface::export
       info_.joints[i].name, hardware_interface::HW_IF_EXTERNAL_TORQUE, &hw_ext_torque_states_[i]);
   }
 
-  state_interfaces.emplace_back(
-    hardware_interface::STATE_PREFIX, hardware_interface::SERVER_STATE, &server_state_);
+  exportHealthStateInterfaces(state_interfaces);
   return state_interfaces;
 }
 
@@ -460,6 +436,16 @@ KukaFRIHardwareInterface::export_command_interfaces()
     command_interfaces.emplace_back(
       info_.joints[i].name, hardware_interface::HW_IF_EFFORT, &hw_torque_commands_[i]);
   }
+
+  for (size_t i = 0; i < hardware_interface::CARTESIAN_IMPEDANCE_AXES.size(); i++)
+  {
+    const std::string prefix = std::string(hardware_interface::CARTESIAN_IMPEDANCE_PREFIX) + "_" +
+                               hardware_interface::CARTESIAN_IMPEDANCE_AXES[i];
+    command_interfaces.emplace_back(
+      prefix, hardware_interface::HW_IF_STIFFNESS, &hw_cart_stiffness_commands_[i]);
+    command_interfaces.emplace_back(
+      prefix, hardware_interface::HW_IF_DAMPING, &hw_cart_damping_commands_[i]);
+  }
   return command_interfaces;
 }
 
@@ -481,8 +467,7 @@ void KukaFRIHardwareInterface::activateFrictionCompensation(double * values) con
 
 void KukaFRIHardwareInterface::onError()
 {
-  std::lock_guard<std::mutex> lk(event_mutex_);
-  last_event_ = kuka_drivers_core::HardwareEvent::ERROR;
+  setServerEvent(kuka_drivers_core::HardwareEvent::ERROR);
   RCLCPP_ERROR(
     rclcpp::get_logger("KukaFRIHardwareInterface"), "External control stopped by an error");
 }
@@ -60,6 +60,9 @@ RobotManagerNode::RobotManagerNode() : kuka_drivers_core::ROS2BaseLCNode("robot_
   joint_imp_pub_ = this->create_publisher<std_msgs::msg::Float64MultiArray>(
     "joint_group_impedance_controller/commands", rclcpp::SystemDefaultsQoS());
 
+  cart_imp_pub_ = this->create_publisher<std_msgs::msg::Float64MultiArray>(
+    "cartesian_impedance_controller/commands", rclcpp::SystemDefaultsQoS());
+
   rclcpp::SubscriptionOptions sub_options;
   sub_options.callback_group = event_cbg_;
   event_subscriber_ = this->create_subscription<std_msgs::msg::UInt8>(
@@ -115,6 +118,30 @@ RobotManagerNode::RobotManagerNode() : kuka_drivers_core::ROS2BaseLCNode("robot_
     "joint_damping", joint_damping_, kuka_drivers_core::ParameterSetAccessRights{true, false},
     [this](const std::vector<double> & joint_damping)
     { return this->onJointDampingChangeRequest(joint_damping); });
+
+  registerParameter<std::vector<double>>(
+    "cartesian_stiffness", cartesian_stiffness_,
+    kuka_drivers_core::ParameterSetAccessRights{true, false},
+    [this](const std::vector<double> & cartesian_stiffness)
+    { return this->onCartesianStiffnessChangeRequest(cartesian_stiffness); });
+
+  registerParameter<std::vector<double>>(
+    "cartesian_damping", cartesian_damping_,
+    kuka_drivers_core::ParameterSetAccessRights{true, false},
+    [this](const std::vector<double> & cartesian_damping)
+    { return this->onCartesianDampingChangeRequest(cartesian_damping); });
+
+  registerParameter<double>(
+    "nullspace_stiffness", nullspace_stiffness_,
+    kuka_drivers_core::ParameterSetAccessRights{true, false},
+    [this](double nullspace_stiffness)
+    { return this->onNullspaceStiffnessChangeRequest(nullspace_stiffness); });
+
+  registerParameter<double>(
+    "nullspace_damping", nullspace_damping_,
+    kuka_drivers_core::ParameterSetAccessRights{true, false},
+    [this](double nullspace_damping)
+    { return this->onNullspaceDampingChangeRequest(nullspace_damping); });
 }
 
 rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn
@@ -145,7 +172,16 @@ RobotManagerNode::on_configure(const rclcpp_lifecycle::State &)
     RCLCPP_ERROR(get_logger(), "Could not activate configuration controllers");
     return FAILURE;
   }
+  // The Cartesian impedance interfaces are not exported by the mock hardware, therefore the
+  //  controller is switched with best effort strictness
+  if (!kuka_drivers_core::changeControllerState(
+        change_controller_state_client_, {kuka_drivers_core::CARTESIAN_IMPEDANCE_CONTROLLER}, {},
+        SwitchController::Request::BEST_EFFORT))
+  {
+    RCLCPP_WARN(get_logger(), "Could not activate Cartesian impedance controller");
+  }
   setImpedanceConfiguration(joint_imp_pub_, joint_stiffness_, joint_damping_);
+  setCartesianImpedanceConfiguration();
   is_configured_pub_->on_activate();
   is_configured_msg_.data = true;
   is_configured_pub_->publish(is_configured_msg_);
@@ -161,7 +197,8 @@ RobotManagerNode::on_cleanup(const rclcpp_lifecycle::State &)
   if (!kuka_drivers_core::changeControllerState(
         change_controller_state_client_, {},
         {kuka_drivers_core::FRI_CONFIGURATION_CONTROLLER, kuka_drivers_core::CONTROL_MODE_HANDLER,
-         kuka_drivers_core::EVENT_BROADCASTER, kuka_drivers_core::JOINT_GROUP_IMPEDANCE_CONTROLLER},
+         kuka_drivers_core::EVENT_BROADCASTER, kuka_drivers_core::JOINT_GROUP_IMPEDANCE_CONTROLLER,
+         kuka_drivers_core::CARTESIAN_IMPEDANCE_CONTROLLER},
         SwitchController::Request::BEST_EFFORT))
   {
     RCLCPP_ERROR(get_logger(), "Could not stop controllers");
@@ -215,6 +252,13 @@ RobotManagerNode::on_activate(const rclcpp_lifecycle::State &)
     this->on_deactivate(get_current_state());
     return FAILURE;
   }
+  // The Cartesian impedance cannot be changed in active state either
+  if (!kuka_drivers_core::changeControllerState(
+        change_controller_state_client_, {}, {kuka_drivers_core::CARTESIAN_IMPEDANCE_CONTROLLER},
+        SwitchController::Request::BEST_EFFORT))
+  {
+    RCLCPP_WARN(get_logger(), "Could not deactivate Cartesian impedance controller");
+  }
   return SUCCESS;
 }
 
@@ -234,7 +278,9 @@ RobotManagerNode::on_deactivate(const rclcpp_lifecycle::State &)
   // Stop RT controllers
   // With best effort strictness, deactivation succeeds if specific controller is not active
   if (!kuka_drivers_core::changeControllerState(
-        change_controller_state_client_, {kuka_drivers_core::JOINT_GROUP_IMPEDANCE_CONTROLLER},
+        change_controller_state_client_,
+        {kuka_drivers_core::JOINT_GROUP_IMPEDANCE_CONTROLLER,
+         kuka_drivers_core::CARTESIAN_IMPEDANCE_CONTROLLER},
         {GetControllerName(), kuka_drivers_core::JOINT_STATE_BROADCASTER,
          kuka_drivers_core::EXTERNAL_TORQUE_BROADCASTER, kuka_drivers_core::FRI_STATE_BROADCASTER},
         SwitchController::Request::BEST_EFFORT))
@@ -271,6 +317,8 @@ bool RobotManagerNode::onControlModeChangeRequest(int control_mode)
       break;
     case kuka_drivers_core::ControlMode::JOINT_IMPEDANCE_CONTROL:
       break;
+    case kuka_drivers_core::ControlMode::CARTESIAN_IMPEDANCE_CONTROL:
+      break;
     case kuka_drivers_core::ControlMode::JOINT_TORQUE_CONTROL:
       if (send_period_ms_ > 5)
       {
@@ -393,6 +441,8 @@ std::string RobotManagerNode::GetControllerName() const
       return joint_pos_controller_name_;
     case kuka_drivers_core::ControlMode::JOINT_IMPEDANCE_CONTROL:
       return joint_pos_controller_name_;
+    case kuka_drivers_core::ControlMode::CARTESIAN_IMPEDANCE_CONTROL:
+      return joint_pos_controller_name_;
     case kuka_drivers_core::ControlMode::JOINT_TORQUE_CONTROL:
       return joint_torque_controller_name_;
     default:
@@ -421,6 +471,16 @@ void RobotManagerNode::setImpedanceConfiguration(
   pub->publish(msg);
 }
 
+void RobotManagerNode::setCartesianImpedanceConfiguration() const
+{
+  // The null space is the last axis of the Cartesian impedance interfaces
+  std::vector<double> stiffness = cartesian_stiffness_;
+  stiffness.push_back(nullspace_stiffness_);
+  std::vector<double> damping = cartesian_damping_;
+  damping.push_back(nullspace_damping_);
+  setImpedanceConfiguration(cart_imp_pub_, stiffness, damping);
+}
+
 bool RobotManagerNode::onJointStiffnessChangeRequest(const std::vector<double> & joint_stiffness)
 {
   if (joint_stiffness.size() != 7)
@@ -461,6 +521,76 @@ bool RobotManagerNode::onJointDampingChangeRequest(const std::vector<double> & j
   return true;
 }
 
+bool RobotManagerNode::onCartesianStiffnessChangeRequest(
+  const std::vector<double> & cartesian_stiffness)
+{
+  if (cartesian_stiffness.size() != 6)
+  {
+    RCLCPP_ERROR(get_logger(), "Invalid parameter array length for parameter cartesian stiffness");
+    return false;
+  }
+  // Limits of the translational [N/m] and rotational [Nm/rad] stiffness in FRI
+  for (std::size_t i = 0; i < cartesian_stiffness.size(); i++)
+  {
+    const double limit = i < 3 ? 5000.0 : 300.0;
+    if (cartesian_stiffness[i] < 0 || cartesian_stiffness[i] > limit)
+    {
+      RCLCPP_ERROR(
+        get_logger(),
+        "Cartesian stiffness values must be >=0 && <=5000 for translation and <=300 for rotation");
+      return false;
+    }
+  }
+  cartesian_stiffness_ = cartesian_stiffness;
+  setCartesianImpedanceConfiguration();
+  return true;
+}
+
+bool RobotManagerNode::onCartesianDampingChangeRequest(
+  const std::vector<double> & cartesian_damping)
+{
+  if (cartesian_damping.size() != 6)
+  {
+    RCLCPP_ERROR(get_logger(), "Invalid parameter array length for parameter cartesian damping");
+    return false;
+  }
+  for (double cd : cartesian_damping)
+  {
+    if (cd < 0.1 || cd > 1)
+    {
+      RCLCPP_ERROR(get_logger(), "Cartesian damping values must be >=0.1 && <=1");
+      return false;
+    }
+  }
+  cartesian_damping_ = cartesian_damping;
+  setCartesianImpedanceConfiguration();
+  return true;
+}
+
+bool RobotManagerNode::onNullspaceStiffnessChangeRequest(double nullspace_stiffness)
+{
+  if (nullspace_stiffness < 0)
+  {
+    RCLCPP_ERROR(get_logger(), "Null space stiffness must be >=0");
+    return false;
+  }
+  nullspace_stiffness_ = nullspace_stiffness;
+  setCartesianImpedanceConfiguration();
+  return true;
+}
+
+bool RobotManagerNode::onNullspaceDampingChangeRequest(double nullspace_damping)
+{
+  if (nullspace_damping < 0.3 || nullspace_damping > 1)
+  {
+    RCLCPP_ERROR(get_logger(), "Null space damping must be >=0.3 && <=1");
+    return false;
+  }
+  nullspace_damping_ = nullspace_damping;
+  setCartesianImpedanceConfiguration();
+  return true;
+}
+
 void RobotManagerNode::EventSubscriptionCallback(const std_msgs::msg::UInt8::SharedPtr msg)
 {
   switch (static_cast<kuka_drivers_core::HardwareEvent>(msg->data))